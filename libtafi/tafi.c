@@ -0,0 +1,326 @@
+/**
+ *  tafi.c -- The Amazing Fan Idea client library
+ *  Device discovery and frame submission.
+ *
+ *  Submitted frames live in a dma-buf mapped into the process and are
+ *  handed to the driver with TAFI_IOC_DMABUF_QUEUE, which reads them in
+ *  place and returns a pickup fence. The buffer is a private udmabuf where
+ *  /dev/udmabuf is available and the driver can read it, else a slot of
+ *  the driver's native frame ring, which is shared with every other user
+ *  of the ring.
+ *
+ *      (C) 2017 Harindu Perera
+ *
+ *  This file is subject to the terms and conditions of the GNU General Public
+ *  License. See the file COPYING in the main directory of this archive for
+ *  more details.
+ */
+
+#define _GNU_SOURCE
+
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/sysmacros.h>
+#include <linux/sync_file.h>
+#include <linux/udmabuf.h>
+
+#include "tafi.h"
+
+#define TAFI_DEFAULT_DEVICE "/dev/tafi"
+#define TAFI_SYSFS_DEV "/sys/class/tafi/tafi/dev"
+
+// Ring slot used when there is no udmabuf.
+#define TAFI_RING_SLOT 0
+
+struct tafi {
+    int fd;
+    // dma-buf holding the frame of tafi_frame()
+    int dmabuf;
+    uint8_t *frame;
+    size_t frame_size;
+};
+
+/**
+ * Check that path is the device the driver registered, in case a stale
+ * node is left over. Without sysfs there is nothing to check against.
+ */
+static int tafi_check_node(int fd) {
+    unsigned int major;
+    unsigned int minor;
+    struct stat st;
+    FILE *dev;
+    int n;
+
+    dev = fopen(TAFI_SYSFS_DEV, "re");
+    if (dev == NULL)
+        return 0;
+    n = fscanf(dev, "%u:%u", &major, &minor);
+    fclose(dev);
+    if (n != 2)
+        return 0;
+
+    if (fstat(fd, &st) < 0)
+        return -errno;
+    if (!S_ISCHR(st.st_mode) || st.st_rdev != makedev(major, minor))
+        return -ENODEV;
+    return 0;
+}
+
+static int tafi_map_udmabuf(struct tafi *tafi) {
+    struct udmabuf_create create;
+    int memfd;
+    int dev;
+    int ret;
+
+    memfd = memfd_create("tafi-frame", MFD_CLOEXEC | MFD_ALLOW_SEALING);
+    if (memfd < 0)
+        return -errno;
+    if (ftruncate(memfd, tafi->frame_size) < 0 || fcntl(memfd, F_ADD_SEALS, F_SEAL_SHRINK) < 0) {
+        ret = -errno;
+        goto out_memfd;
+    }
+
+    dev = open("/dev/udmabuf", O_RDWR | O_CLOEXEC);
+    if (dev < 0) {
+        ret = -errno;
+        goto out_memfd;
+    }
+
+    memset(&create, 0, sizeof(create));
+    create.memfd = memfd;
+    create.flags = UDMABUF_FLAGS_CLOEXEC;
+    create.size = tafi->frame_size;
+    tafi->dmabuf = ioctl(dev, UDMABUF_CREATE, &create);
+    ret = tafi->dmabuf < 0 ? -errno : 0;
+    close(dev);
+    if (ret)
+        goto out_memfd;
+
+    // the memfd is the same memory, and mapping it needs no help from udmabuf
+    tafi->frame = mmap(NULL, tafi->frame_size, PROT_READ | PROT_WRITE, MAP_SHARED, memfd, 0);
+    if (tafi->frame == MAP_FAILED) {
+        ret = -errno;
+        close(tafi->dmabuf);
+    }
+
+out_memfd:
+    close(memfd);
+    return ret;
+}
+
+/**
+ * Check that the driver can read the udmabuf by queueing what is on
+ * display already, so the probe doesn't change the picture.
+ */
+static int tafi_probe_udmabuf(struct tafi *tafi) {
+    struct tafi_dmabuf_queue queue = {
+        .fd = tafi->dmabuf,
+        .offset = 0,
+    };
+    ssize_t n;
+
+    n = pread(tafi->fd, tafi->frame, TAFI_DATA_BUF_LEN, 0);
+    if (n != TAFI_DATA_BUF_LEN)
+        return n < 0 ? -errno : -EIO;
+    if (ioctl(tafi->fd, TAFI_IOC_DMABUF_QUEUE, &queue) < 0)
+        return -errno;
+    close(queue.fence_fd);
+    return 0;
+}
+
+static void tafi_unmap(struct tafi *tafi) {
+    munmap(tafi->frame, tafi->frame_size);
+    close(tafi->dmabuf);
+}
+
+static int tafi_map_ring(struct tafi *tafi) {
+    struct tafi_dmabuf_export export = {
+        .index = TAFI_RING_SLOT,
+        .flags = O_RDWR | O_CLOEXEC,
+    };
+    int ret;
+
+    if (ioctl(tafi->fd, TAFI_IOC_DMABUF_EXPORT, &export) < 0)
+        return -errno;
+    tafi->dmabuf = export.fd;
+
+    tafi->frame = mmap(NULL, tafi->frame_size, PROT_READ | PROT_WRITE, MAP_SHARED, tafi->dmabuf, 0);
+    if (tafi->frame == MAP_FAILED) {
+        ret = -errno;
+        close(tafi->dmabuf);
+        return ret;
+    }
+    return 0;
+}
+
+struct tafi *tafi_open(const char *path) {
+    long page_size = sysconf(_SC_PAGESIZE);
+    struct tafi *tafi;
+    int ret;
+
+    if (path == NULL)
+        path = getenv("TAFI_DEVICE");
+    if (path == NULL)
+        path = TAFI_DEFAULT_DEVICE;
+
+    tafi = calloc(1, sizeof(*tafi));
+    if (tafi == NULL)
+        return NULL;
+    tafi->frame_size = (TAFI_DATA_BUF_LEN + page_size - 1) / page_size * page_size;
+
+    tafi->fd = open(path, O_RDWR | O_CLOEXEC);
+    if (tafi->fd < 0) {
+        ret = -errno;
+        goto err_free;
+    }
+
+    ret = tafi_check_node(tafi->fd);
+    if (ret)
+        goto err_close;
+
+    ret = tafi_map_udmabuf(tafi);
+    if (ret == 0) {
+        ret = tafi_probe_udmabuf(tafi);
+        if (ret)
+            tafi_unmap(tafi);
+    }
+    if (ret)
+        ret = tafi_map_ring(tafi);
+    if (ret)
+        goto err_close;
+
+    tafi_frame_clear(tafi->frame);
+    return tafi;
+
+err_close:
+    close(tafi->fd);
+err_free:
+    free(tafi);
+    errno = -ret;
+    return NULL;
+}
+
+void tafi_close(struct tafi *tafi) {
+    if (tafi == NULL)
+        return;
+    tafi_unmap(tafi);
+    close(tafi->fd);
+    free(tafi);
+}
+
+int tafi_fd(const struct tafi *tafi) {
+    return tafi->fd;
+}
+
+uint8_t *tafi_frame(struct tafi *tafi) {
+    return tafi->frame;
+}
+
+int tafi_submit(struct tafi *tafi) {
+    struct tafi_dmabuf_queue queue = {
+        .fd = tafi->dmabuf,
+        .offset = 0,
+    };
+
+    if (ioctl(tafi->fd, TAFI_IOC_DMABUF_QUEUE, &queue) < 0)
+        return -errno;
+    return queue.fence_fd;
+}
+
+int tafi_write(struct tafi *tafi, const uint8_t *frame) {
+    size_t done = 0;
+    ssize_t n;
+
+    while (done < TAFI_DATA_BUF_LEN) {
+        n = pwrite(tafi->fd, frame + done, TAFI_DATA_BUF_LEN - done, done);
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n <= 0)
+            return n < 0 ? -errno : -EIO;
+        done += n;
+    }
+
+    if (ioctl(tafi->fd, TAFI_IOC_COMMIT) < 0)
+        return -errno;
+    return 0;
+}
+
+int tafi_set_present(struct tafi *tafi, unsigned int mode, unsigned int depth) {
+    struct tafi_present present = {
+        .mode = mode,
+        .depth = depth,
+    };
+
+    if (ioctl(tafi->fd, TAFI_IOC_SET_PRESENT, &present) < 0)
+        return -errno;
+    return 0;
+}
+
+int tafi_set_fade(struct tafi *tafi, unsigned int frames) {
+    uint32_t fade = frames;
+
+    if (ioctl(tafi->fd, TAFI_IOC_SET_FADE, &fade) < 0)
+        return -errno;
+    return 0;
+}
+
+int tafi_dropped(struct tafi *tafi, uint64_t *dropped) {
+    struct tafi_present present;
+
+    if (ioctl(tafi->fd, TAFI_IOC_GET_PRESENT, &present) < 0)
+        return -errno;
+    *dropped = present.dropped;
+    return 0;
+}
+
+int tafi_sync(struct tafi *tafi) {
+    if (fsync(tafi->fd) < 0)
+        return -errno;
+    return 0;
+}
+
+int tafi_fence_wait(int fence, int timeout_ms, uint64_t *pickup_ns) {
+    struct pollfd pfd = { .fd = fence, .events = POLLIN };
+    struct sync_fence_info fence_info;
+    struct sync_file_info info;
+    int n;
+
+    do {
+        n = poll(&pfd, 1, timeout_ms);
+    } while (n < 0 && errno == EINTR);
+    if (n < 0)
+        return -errno;
+    if (n == 0)
+        return -ETIME;
+
+    if (pickup_ns == NULL)
+        return 0;
+
+    // the signal time is taken in the transmit thread, not when poll() woke
+    memset(&info, 0, sizeof(info));
+    memset(&fence_info, 0, sizeof(fence_info));
+    info.num_fences = 1;
+    info.sync_fence_info = (uintptr_t) &fence_info;
+    if (ioctl(fence, SYNC_IOC_FILE_INFO, &info) < 0)
+        return -errno;
+    if (fence_info.status < 0)
+        return fence_info.status;
+    *pickup_ns = fence_info.timestamp_ns;
+    return 0;
+}
+
+uint64_t tafi_now_ns(void) {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
@@ -0,0 +1,144 @@
+/**
+ *  tafi.h -- The Amazing Fan Idea client library
+ *  Opening the display, the native frame layout, conversion into it and
+ *  frame submission, for programs driving /dev/tafi.
+ *
+ *  Frames are TAFI_DATA_BUF_LEN bytes in wire format, see tafi_uapi.h.
+ *  Functions returning int return 0 or a negative errno value.
+ *
+ *      (C) 2017 Harindu Perera
+ *
+ *  This file is subject to the terms and conditions of the GNU General Public
+ *  License. See the file COPYING in the main directory of this archive for
+ *  more details.
+ */
+
+#ifndef TAFI_LIB
+#define TAFI_LIB
+
+#include <stdint.h>
+
+#include "../tafi_uapi.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct tafi;
+
+// Byte layout of a source pixel.
+struct tafi_format {
+    unsigned int cpp;       // bytes per pixel
+    unsigned int red;       // byte offsets of the channels within a pixel
+    unsigned int green;
+    unsigned int blue;
+};
+
+extern const struct tafi_format tafi_rgb888;       // R, G, B bytes
+extern const struct tafi_format tafi_xrgb8888;     // 32 bit 0xXXRRGGBB, little endian
+
+/**
+ * Open the display. A NULL path uses $TAFI_DEVICE, or else the node of the
+ * tafi class device. Returns NULL with errno set on failure.
+ */
+struct tafi *tafi_open(const char *path);
+
+void tafi_close(struct tafi *tafi);
+
+/**
+ * File descriptor of the open display, for the ioctls in tafi_uapi.h.
+ */
+int tafi_fd(const struct tafi *tafi);
+
+/**
+ * Byte offset of an LED's blue, red, green triple in a native frame.
+ */
+static inline unsigned int tafi_led_offset(unsigned int sector, unsigned int led) {
+    return sector * TAFI_SECTOR_BUF_LEN + led * TAFI_LED_COLOR_FIELD_COUNT;
+}
+
+/**
+ * Turn every LED of a native frame off.
+ */
+void tafi_frame_clear(uint8_t *frame);
+
+/**
+ * Set one LED of a native frame, with the driver's brightness correction.
+ */
+void tafi_frame_set(uint8_t *frame, unsigned int sector, unsigned int led, uint8_t red, uint8_t green,
+    uint8_t blue);
+
+/**
+ * Convert a TAFI_FB_XRES x TAFI_FB_YRES image into a native frame, the
+ * same way the framebuffer device does.
+ */
+void tafi_convert_rect(const uint8_t *src, unsigned int pitch, const struct tafi_format *format, uint8_t *frame);
+
+/**
+ * Convert an image in native polar layout, one line of
+ * TAFI_SECTOR_LED_COUNT pixels per sector, into a native frame.
+ */
+void tafi_convert_polar(const uint8_t *src, unsigned int pitch, const struct tafi_format *format,
+    uint8_t *frame);
+
+/**
+ * The frame buffer submitted by tafi_submit(), mapped into the process.
+ * The driver copies it on submission, so it can be refilled right after.
+ */
+uint8_t *tafi_frame(struct tafi *tafi);
+
+/**
+ * Display the contents of tafi_frame() without copying them through a
+ * write(). Returns a sync_file descriptor that signals when the transmit
+ * thread has picked the frame up, or a negative errno value. The caller
+ * closes it, see tafi_fence_wait().
+ */
+int tafi_submit(struct tafi *tafi);
+
+/**
+ * Display a frame held anywhere in memory, through write(). Returns once
+ * the frame is committed; tafi_sync() waits for the pickup.
+ */
+int tafi_write(struct tafi *tafi, const uint8_t *frame);
+
+/**
+ * Choose how frames submitted through this display are presented, one of
+ * TAFI_PRESENT_*. depth is the queue length in FIFO mode. In FIFO mode
+ * tafi_submit() and tafi_write() block while the queue is full.
+ */
+int tafi_set_present(struct tafi *tafi, unsigned int mode, unsigned int depth);
+
+/**
+ * Crossfade every frame submitted from now on in over this many
+ * transmitted frames, at most TAFI_FADE_MAX; 0 cuts to it.
+ */
+int tafi_set_fade(struct tafi *tafi, unsigned int frames);
+
+/**
+ * Number of frames submitted through this display that were never
+ * transmitted.
+ */
+int tafi_dropped(struct tafi *tafi, uint64_t *dropped);
+
+/**
+ * Wait until everything submitted so far has been picked up.
+ */
+int tafi_sync(struct tafi *tafi);
+
+/**
+ * Wait up to timeout_ms, or forever if negative, for a fence returned by
+ * tafi_submit(). The CLOCK_MONOTONIC time the frame was picked up goes to
+ * pickup_ns, if given. Returns -ETIME on timeout.
+ */
+int tafi_fence_wait(int fence, int timeout_ms, uint64_t *pickup_ns);
+
+/**
+ * CLOCK_MONOTONIC now, in nanoseconds, to compare with pickup times.
+ */
+uint64_t tafi_now_ns(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
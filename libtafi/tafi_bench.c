@@ -0,0 +1,274 @@
+/**
+ *  tafi_bench.c -- The Amazing Fan Idea client library
+ *  tafi-bench: submit throughput and submit to transmit latency of the
+ *  driver.
+ *
+ *  Every frame differs from the last, so idle mode never skips one. With
+ *  the default zero copy submission the latency runs from the start of
+ *  tafi_submit() to the time the transmit thread signalled the pickup
+ *  fence, which is when the frame started going out on the wire. Frames
+ *  submitted faster than the display runs are superseded, and their fence
+ *  signals with the pickup of the frame that replaced them. The write mode
+ *  has no fence, so it waits in fsync() after every frame and the latency
+ *  includes the wakeup.
+ *
+ *  The presentation mode decides what happens to frames submitted faster
+ *  than the display runs: mailbox drops them, FIFO holds the submitter
+ *  back.
+ *
+ *  Usage: tafi-bench [-d device] [-n frames] [-i interval_us] [-m zerocopy|write]
+ *                    [-p mailbox|fifo|immediate] [-q fifo_depth]
+ *
+ *      (C) 2017 Harindu Perera
+ *
+ *  This file is subject to the terms and conditions of the GNU General Public
+ *  License. See the file COPYING in the main directory of this archive for
+ *  more details.
+ */
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "tafi.h"
+
+// Fences waited for later, so submission runs ahead of the display.
+#define BENCH_FENCES_IN_FLIGHT 64
+
+// Give up on a fence after this long, the display has stopped.
+#define BENCH_FENCE_TIMEOUT_MS 1000
+
+struct bench_fence {
+    int fd;
+    uint64_t submit_ns;
+};
+
+static struct tafi *tafi;
+static uint64_t *latencies;
+static unsigned int latency_count;
+
+static int cmp_u64(const void *a, const void *b) {
+    uint64_t x = *(const uint64_t *) a;
+    uint64_t y = *(const uint64_t *) b;
+
+    return x < y ? -1 : x > y;
+}
+
+/*
+ * A frame that changes every time: a gradient rotating by one sector per
+ * frame.
+ */
+static void fill_frame(uint8_t *frame, unsigned int n) {
+    unsigned int s;
+    unsigned int l;
+    unsigned int v;
+
+    for (s = 0; s < TAFI_SECTOR_COUNT; s++) {
+        v = (s + n) % TAFI_SECTOR_COUNT * 255 / (TAFI_SECTOR_COUNT - 1);
+        for (l = 0; l < TAFI_SECTOR_LED_COUNT; l++)
+            tafi_frame_set(frame, s, l, v, 255 - v, l * 255 / (TAFI_SECTOR_LED_COUNT - 1));
+    }
+}
+
+static int collect(struct bench_fence *fence) {
+    uint64_t pickup_ns;
+    int ret;
+
+    ret = tafi_fence_wait(fence->fd, BENCH_FENCE_TIMEOUT_MS, &pickup_ns);
+    close(fence->fd);
+    fence->fd = -1;
+    if (ret) {
+        fprintf(stderr, "tafi-bench: no pickup: %s\n", strerror(-ret));
+        return ret;
+    }
+
+    latencies[latency_count++] = pickup_ns > fence->submit_ns ? pickup_ns - fence->submit_ns : 0;
+    return 0;
+}
+
+static void sleep_until(uint64_t ns) {
+    struct timespec ts = {
+        .tv_sec = ns / 1000000000,
+        .tv_nsec = ns % 1000000000,
+    };
+
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) == EINTR)
+        ;
+}
+
+static int run_zerocopy(unsigned int frames, unsigned int interval_us, uint64_t *submit_ns) {
+    struct bench_fence fences[BENCH_FENCES_IN_FLIGHT];
+    struct bench_fence *fence;
+    uint64_t start = tafi_now_ns();
+    uint64_t t;
+    unsigned int n;
+    int ret = 0;
+
+    for (n = 0; n < BENCH_FENCES_IN_FLIGHT; n++)
+        fences[n].fd = -1;
+
+    for (n = 0; n < frames; n++) {
+        fence = &fences[n % BENCH_FENCES_IN_FLIGHT];
+        if (fence->fd >= 0 && (ret = collect(fence)))
+            goto out;
+
+        if (interval_us)
+            sleep_until(start + (uint64_t) n * interval_us * 1000);
+        fill_frame(tafi_frame(tafi), n);
+
+        t = tafi_now_ns();
+        fence->fd = tafi_submit(tafi);
+        *submit_ns += tafi_now_ns() - t;
+        if (fence->fd < 0) {
+            ret = fence->fd;
+            fprintf(stderr, "tafi-bench: submit: %s\n", strerror(-ret));
+            goto out;
+        }
+        fence->submit_ns = t;
+    }
+
+out:
+    for (n = 0; n < BENCH_FENCES_IN_FLIGHT; n++)
+        if (fences[n].fd >= 0 && collect(&fences[n]) && !ret)
+            ret = -ETIME;
+    return ret;
+}
+
+static int run_write(unsigned int frames, unsigned int interval_us, uint64_t *submit_ns) {
+    uint8_t frame[TAFI_DATA_BUF_LEN];
+    uint64_t start = tafi_now_ns();
+    uint64_t t;
+    unsigned int n;
+    int ret;
+
+    for (n = 0; n < frames; n++) {
+        if (interval_us)
+            sleep_until(start + (uint64_t) n * interval_us * 1000);
+        fill_frame(frame, n);
+
+        t = tafi_now_ns();
+        ret = tafi_write(tafi, frame);
+        *submit_ns += tafi_now_ns() - t;
+        if (ret == 0)
+            ret = tafi_sync(tafi);
+        if (ret) {
+            fprintf(stderr, "tafi-bench: write: %s\n", strerror(-ret));
+            return ret;
+        }
+        latencies[latency_count++] = tafi_now_ns() - t;
+    }
+    return 0;
+}
+
+static void print_percentile(const char *name, double p) {
+    unsigned int i = (unsigned int) (p / 100 * (latency_count - 1) + 0.5);
+
+    printf("  %-6s %10.3f ms\n", name, latencies[i] / 1e6);
+}
+
+static void usage(void) {
+    fprintf(stderr, "usage: tafi-bench [-d device] [-n frames] [-i interval_us] [-m zerocopy|write]\n"
+        "                  [-p mailbox|fifo|immediate] [-q fifo_depth]\n");
+    exit(2);
+}
+
+int main(int argc, char **argv) {
+    const char *device = NULL;
+    unsigned int frames = 1000;
+    unsigned int interval_us = 0;
+    int zerocopy = 1;
+    unsigned int present = TAFI_PRESENT_MAILBOX;
+    unsigned int depth = 2;
+    uint64_t dropped = 0;
+    uint64_t submit_ns = 0;
+    uint64_t start;
+    uint64_t elapsed;
+    int opt;
+    int ret;
+
+    while ((opt = getopt(argc, argv, "d:n:i:m:p:q:")) != -1) {
+        switch (opt) {
+        case 'd':
+            device = optarg;
+            break;
+        case 'n':
+            frames = strtoul(optarg, NULL, 0);
+            break;
+        case 'i':
+            interval_us = strtoul(optarg, NULL, 0);
+            break;
+        case 'm':
+            if (!strcmp(optarg, "zerocopy"))
+                zerocopy = 1;
+            else if (!strcmp(optarg, "write"))
+                zerocopy = 0;
+            else
+                usage();
+            break;
+        case 'p':
+            if (!strcmp(optarg, "mailbox"))
+                present = TAFI_PRESENT_MAILBOX;
+            else if (!strcmp(optarg, "fifo"))
+                present = TAFI_PRESENT_FIFO;
+            else if (!strcmp(optarg, "immediate"))
+                present = TAFI_PRESENT_IMMEDIATE;
+            else
+                usage();
+            break;
+        case 'q':
+            depth = strtoul(optarg, NULL, 0);
+            break;
+        default:
+            usage();
+        }
+    }
+    if (optind != argc || frames == 0)
+        usage();
+
+    tafi = tafi_open(device);
+    if (tafi == NULL) {
+        fprintf(stderr, "tafi-bench: cannot open the display: %s\n", strerror(errno));
+        return 1;
+    }
+
+    ret = tafi_set_present(tafi, present, present == TAFI_PRESENT_FIFO ? depth : 0);
+    if (ret) {
+        fprintf(stderr, "tafi-bench: cannot set the presentation mode: %s\n", strerror(-ret));
+        tafi_close(tafi);
+        return 1;
+    }
+
+    latencies = calloc(frames, sizeof(*latencies));
+    if (latencies == NULL) {
+        tafi_close(tafi);
+        return 1;
+    }
+
+    start = tafi_now_ns();
+    ret = zerocopy ? run_zerocopy(frames, interval_us, &submit_ns) : run_write(frames, interval_us, &submit_ns);
+    elapsed = tafi_now_ns() - start;
+    tafi_dropped(tafi, &dropped);
+
+    printf("%s: %u frames in %.3f s, %llu dropped\n", zerocopy ? "zerocopy" : "write", latency_count,
+        elapsed / 1e9, (unsigned long long) dropped);
+    if (latency_count) {
+        printf("  submit %10.1f frames/s, %.1f us per call\n", latency_count / (elapsed / 1e9),
+            submit_ns / 1e3 / latency_count);
+
+        qsort(latencies, latency_count, sizeof(*latencies), cmp_u64);
+        printf("submit to transmit latency:\n");
+        print_percentile("min", 0);
+        print_percentile("p50", 50);
+        print_percentile("p90", 90);
+        print_percentile("p99", 99);
+        print_percentile("p99.9", 99.9);
+        print_percentile("max", 100);
+    }
+
+    free(latencies);
+    tafi_close(tafi);
+    return ret ? 1 : 0;
+}
@@ -0,0 +1,225 @@
+/**
+ *  tafi_check.c -- The Amazing Fan Idea client library
+ *  tafi-check: self tests of the code shared with the driver, run by
+ *  make check.
+ *
+ *  The wire encoder is round tripped through the reference decoder on
+ *  empty, repeated, random and top-bit-clear frames, whole and in the
+ *  pieces a pipelined display queues them in.
+ *
+ *  Polar conversion, whose channel swizzle runs in the vector kernel
+ *  shared with the driver where the CPU has one, is compared against a
+ *  plain scalar conversion on random images in every pixel layout the
+ *  kernel takes, packed and with padded lines.
+ *
+ *      (C) 2017 Harindu Perera
+ *
+ *  This file is subject to the terms and conditions of the GNU General Public
+ *  License. See the file COPYING in the main directory of this archive for
+ *  more details.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "tafi.h"
+#include "tafi_lut.h"
+#include "../tafi_wire.h"
+
+// Sectors per piece when encoding like a pipelined display.
+#define CHECK_PIECE_SECTORS 7
+
+#define CHECK_RANDOM_FRAMES 64
+
+// Bytes a polar image line may be padded by.
+#define CHECK_MAX_PADDING 13
+
+// Pixel layouts: the two predefined ones, and the other channel orders
+// the kernel is given masks for.
+static const struct tafi_format check_formats[] = {
+    { .cpp = 3, .red = 0, .green = 1, .blue = 2 },
+    { .cpp = 4, .red = 2, .green = 1, .blue = 0 },
+    { .cpp = 3, .red = 2, .green = 1, .blue = 0 },
+    { .cpp = 4, .red = 1, .green = 2, .blue = 3 },
+};
+
+static int failures;
+
+static void fail(const char *what, const char *why) {
+    fprintf(stderr, "tafi-check: FAIL: %s: %s\n", what, why);
+    failures++;
+}
+
+/**
+ * Encode a frame whole and in pieces, check both encode the same and
+ * decode to the frame with every top bit set. Returns the encoded size.
+ */
+static unsigned int check_wire_frame(const uint8_t *frame, const char *what) {
+    static uint8_t whole[TAFI_DATA_BUF_LEN];
+    static uint8_t pieces[TAFI_DATA_BUF_LEN];
+    static uint8_t decoded[TAFI_DATA_BUF_LEN];
+    unsigned int len;
+    unsigned int fill = 0;
+    unsigned int first;
+    unsigned int count;
+    unsigned int i;
+
+    len = tafi_wire_encode(frame, 0, TAFI_SECTOR_COUNT, whole);
+    if (len > TAFI_DATA_BUF_LEN) {
+        fail(what, "frame grew");
+        return len;
+    }
+
+    for (first = 0; first < TAFI_SECTOR_COUNT; first += count) {
+        count = TAFI_SECTOR_COUNT - first < CHECK_PIECE_SECTORS ? TAFI_SECTOR_COUNT - first : CHECK_PIECE_SECTORS;
+        fill += tafi_wire_encode(frame, first, count, pieces + fill);
+    }
+    if (fill != len || memcmp(whole, pieces, len))
+        fail(what, "encoding in pieces differs");
+
+    if (tafi_wire_decode(whole, len, decoded)) {
+        fail(what, "does not decode");
+        return len;
+    }
+    for (i = 0; i < TAFI_DATA_BUF_LEN; i++) {
+        if (decoded[i] != (frame[i] | TAFI_WIRE_LITERAL)) {
+            fail(what, "decodes to another frame");
+            break;
+        }
+    }
+    return len;
+}
+
+static void check_wire(void) {
+    static uint8_t frame[TAFI_DATA_BUF_LEN];
+    unsigned int len;
+    unsigned int n;
+    unsigned int s;
+    unsigned int l;
+    unsigned int i;
+
+    // all off: one run per sector
+    tafi_frame_clear(frame);
+    len = check_wire_frame(frame, "empty frame");
+    if (len != TAFI_SECTOR_COUNT)
+        fail("empty frame", "not one command per sector");
+
+    // one wire value per sector, every other sector repeating the one before
+    for (s = 0; s < TAFI_SECTOR_COUNT; s++)
+        memset(frame + tafi_led_offset(s, 0), TAFI_WIRE_LITERAL | s / 2, TAFI_SECTOR_BUF_LEN);
+    len = check_wire_frame(frame, "repeated sectors");
+    if (len > TAFI_SECTOR_COUNT / 2 * (TAFI_LED_COLOR_FIELD_COUNT + 1) + TAFI_SECTOR_COUNT / 2)
+        fail("repeated sectors", "not one literal and one run, or one copy, per sector");
+
+    // nothing to compress: random wire values go out raw
+    srand(1);
+    for (n = 0; n < CHECK_RANDOM_FRAMES; n++) {
+        for (i = 0; i < TAFI_DATA_BUF_LEN; i++)
+            frame[i] = rand() | TAFI_WIRE_LITERAL;
+        check_wire_frame(frame, "random frame");
+    }
+
+    // random runs and copies of the sector before
+    for (n = 0; n < CHECK_RANDOM_FRAMES; n++) {
+        for (s = 0; s < TAFI_SECTOR_COUNT; s++) {
+            for (l = 0; l < TAFI_SECTOR_LED_COUNT; l++) {
+                i = tafi_led_offset(s, l);
+                if (l && rand() % 3 == 0) {
+                    memcpy(frame + i, frame + i - TAFI_LED_COLOR_FIELD_COUNT, TAFI_LED_COLOR_FIELD_COUNT);
+                } else if (s && rand() % 2 == 0) {
+                    memcpy(frame + i, frame + tafi_led_offset(s - 1, l), TAFI_LED_COLOR_FIELD_COUNT);
+                } else {
+                    frame[i] = rand() | TAFI_WIRE_LITERAL;
+                    frame[i + 1] = rand() | TAFI_WIRE_LITERAL;
+                    frame[i + 2] = rand() | TAFI_WIRE_LITERAL;
+                }
+            }
+        }
+        check_wire_frame(frame, "runs and copies");
+    }
+
+    // raw bytes, as written natively or through a dma-buf
+    memset(frame, 0, TAFI_DATA_BUF_LEN);
+    check_wire_frame(frame, "zero frame");
+    for (n = 0; n < CHECK_RANDOM_FRAMES; n++) {
+        for (i = 0; i < TAFI_DATA_BUF_LEN; i++)
+            frame[i] = rand() & (n & 1 ? 0x7f : 0xff);
+        check_wire_frame(frame, "top-bit-clear frame");
+    }
+}
+
+/**
+ * The conversion tafi_convert_polar() must match, one LED at a time.
+ */
+static void check_polar_reference(const uint8_t *src, unsigned int pitch, const struct tafi_format *format,
+    uint8_t *frame) {
+
+    const uint8_t *pixel;
+    unsigned int s;
+    unsigned int l;
+
+    for (s = 0; s < TAFI_SECTOR_COUNT; s++) {
+        for (l = 0; l < TAFI_SECTOR_LED_COUNT; l++) {
+            pixel = src + s * pitch + l * format->cpp;
+            frame[0] = tafi_lut_wire[l][pixel[format->blue]];
+            frame[1] = tafi_lut_wire[l][pixel[format->red]];
+            frame[2] = tafi_lut_wire[l][pixel[format->green]];
+            frame += TAFI_LED_COLOR_FIELD_COUNT;
+        }
+    }
+}
+
+static void check_polar(void) {
+    static uint8_t src[TAFI_SECTOR_COUNT * (TAFI_SECTOR_LED_COUNT * 4 + CHECK_MAX_PADDING)];
+    static uint8_t expected[TAFI_DATA_BUF_LEN];
+    static uint8_t frame[TAFI_DATA_BUF_LEN];
+    const struct tafi_format *format;
+    unsigned int pitch;
+    unsigned int f;
+    unsigned int n;
+    unsigned int i;
+
+    for (f = 0; f < sizeof(check_formats) / sizeof(check_formats[0]); f++) {
+        format = &check_formats[f];
+        for (n = 0; n < CHECK_RANDOM_FRAMES; n++) {
+            pitch = TAFI_SECTOR_LED_COUNT * format->cpp + n % (CHECK_MAX_PADDING + 1);
+            for (i = 0; i < sizeof(src); i++)
+                src[i] = rand();
+            check_polar_reference(src, pitch, format, expected);
+            // the kernel stores whole vectors, they must not spill over
+            memset(frame, 0, TAFI_DATA_BUF_LEN);
+            tafi_convert_polar(src, pitch, format, frame);
+            if (memcmp(frame, expected, TAFI_DATA_BUF_LEN)) {
+                fail("polar conversion", "differs from the scalar conversion");
+                return;
+            }
+        }
+    }
+}
+
+/**
+ * The swizzle kernel tafi_convert_polar() runs on this CPU.
+ */
+static const char *check_simd_name(void) {
+#if defined(__x86_64__) || defined(__i386__)
+    return __builtin_cpu_supports("ssse3") ? "ssse3" : "none";
+#elif defined(__ARM_NEON)
+    return "neon";
+#else
+    return "none";
+#endif
+}
+
+int main(void) {
+    check_wire();
+    check_polar();
+    printf("tafi-check: polar conversion checked with vector kernel: %s\n", check_simd_name());
+
+    if (failures) {
+        fprintf(stderr, "tafi-check: %d failures\n", failures);
+        return 1;
+    }
+    printf("tafi-check: ok\n");
+    return 0;
+}
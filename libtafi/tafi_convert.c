@@ -0,0 +1,179 @@
+/**
+ *  tafi_convert.c -- The Amazing Fan Idea client library
+ *  Conversion into the native wire layout.
+ *
+ *  Uses the lookup tables the driver is built with, generated by the same
+ *  tafi_lutgen from the same geometry, so a frame converted here is byte
+ *  for byte what the framebuffer device would send. Like in the driver,
+ *  only the channel swizzle of polar images is vectorised: the ARM build
+ *  links the driver's NEON kernel, x86 uses the same SSSE3 shuffle when the
+ *  CPU has it.
+ *
+ *      (C) 2017 Harindu Perera
+ *
+ *  This file is subject to the terms and conditions of the GNU General Public
+ *  License. See the file COPYING in the main directory of this archive for
+ *  more details.
+ */
+
+#include <string.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+#include "tafi.h"
+#include "tafi_lut.h"
+#include "../tafi_convert_simd.h"
+
+const struct tafi_format tafi_rgb888 = {
+    .cpp = 3,
+    .red = 0,
+    .green = 1,
+    .blue = 2,
+};
+
+const struct tafi_format tafi_xrgb8888 = {
+    .cpp = 4,
+    .red = 2,
+    .green = 1,
+    .blue = 0,
+};
+
+static inline uint8_t tafi_convert_channel(uint8_t value, unsigned int led) {
+    return tafi_lut_wire[led][value];
+}
+
+void tafi_frame_clear(uint8_t *frame) {
+    // 0 maps to 0 on every LED, so this is just the framing bit
+    memset(frame, 0x80, TAFI_DATA_BUF_LEN);
+}
+
+void tafi_frame_set(uint8_t *frame, unsigned int sector, unsigned int led, uint8_t red, uint8_t green,
+    uint8_t blue) {
+
+    uint8_t *out = frame + tafi_led_offset(sector, led);
+
+    out[0] = tafi_convert_channel(blue, led);
+    out[1] = tafi_convert_channel(red, led);
+    out[2] = tafi_convert_channel(green, led);
+}
+
+void tafi_convert_rect(const uint8_t *src, unsigned int pitch, const struct tafi_format *format, uint8_t *frame) {
+    const uint8_t *pixel;
+    unsigned int s;
+    unsigned int l;
+
+    for (s = 0; s < TAFI_SECTOR_COUNT; s++) {
+        for (l = 0; l < TAFI_SECTOR_LED_COUNT; l++) {
+            // the table holds (line, column) of the sampled pixel
+            pixel = src + tafi_lut_pixel[s][l][0] * pitch + tafi_lut_pixel[s][l][1] * format->cpp;
+            frame[0] = tafi_convert_channel(pixel[format->blue], l);
+            frame[1] = tafi_convert_channel(pixel[format->red], l);
+            frame[2] = tafi_convert_channel(pixel[format->green], l);
+            frame += TAFI_LED_COLOR_FIELD_COUNT;
+        }
+    }
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+__attribute__((target("ssse3")))
+static void tafi_convert_shuffle_ssse3(const struct tafi_convert_shuffle *shuffle, const unsigned char *src,
+    unsigned char *dst) {
+
+    __m128i mask = _mm_loadu_si128((const __m128i *) shuffle->mask);
+    const unsigned char *in;
+    unsigned char *out;
+    unsigned int row;
+    unsigned int chunk;
+
+    for (row = 0; row < shuffle->rows; row++) {
+        in = src + row * shuffle->src_pitch;
+        out = dst + row * shuffle->dst_pitch;
+        for (chunk = 0; chunk < shuffle->chunks; chunk++) {
+            _mm_storeu_si128((__m128i *) out, _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *) in), mask));
+            in += shuffle->src_step;
+            out += shuffle->dst_step;
+        }
+    }
+}
+#endif
+
+/*
+ * The user space twin of tafi_convert_simd_swizzle(): swizzle the leading
+ * pixels of each row into wire channel order and return how many per row
+ * were done.
+ */
+static unsigned int tafi_convert_swizzle(const uint8_t *src, unsigned int pitch, const struct tafi_format *format,
+    unsigned int rows, unsigned int pixels, uint8_t *dst) {
+
+    struct tafi_convert_shuffle shuffle;
+    unsigned int step;
+    unsigned int p;
+
+#if defined(__x86_64__) || defined(__i386__)
+    if (!__builtin_cpu_supports("ssse3"))
+        return 0;
+#elif !defined(__ARM_NEON)
+    return 0;
+#endif
+
+    if (format->cpp != 3 && format->cpp != 4)
+        return 0;
+    step = 16 / format->cpp;
+
+    // the last chunk still has to read and write 16 bytes within the row
+    if (pixels * TAFI_LED_COLOR_FIELD_COUNT < 16)
+        return 0;
+
+    memset(shuffle.mask, 0x80, sizeof(shuffle.mask));
+    for (p = 0; p < step; p++) {
+        shuffle.mask[p * 3 + 0] = p * format->cpp + format->blue;
+        shuffle.mask[p * 3 + 1] = p * format->cpp + format->red;
+        shuffle.mask[p * 3 + 2] = p * format->cpp + format->green;
+    }
+    shuffle.rows = rows;
+    shuffle.chunks = (pixels * TAFI_LED_COLOR_FIELD_COUNT - 16) / (step * TAFI_LED_COLOR_FIELD_COUNT) + 1;
+    shuffle.src_pitch = pitch;
+    shuffle.src_step = step * format->cpp;
+    shuffle.dst_pitch = pixels * TAFI_LED_COLOR_FIELD_COUNT;
+    shuffle.dst_step = step * TAFI_LED_COLOR_FIELD_COUNT;
+
+#if defined(__x86_64__) || defined(__i386__)
+    tafi_convert_shuffle_ssse3(&shuffle, src, dst);
+#elif defined(__ARM_NEON)
+    tafi_convert_shuffle_neon(&shuffle, src, dst);
+#endif
+
+    return shuffle.chunks * step;
+}
+
+void tafi_convert_polar(const uint8_t *src, unsigned int pitch, const struct tafi_format *format,
+    uint8_t *frame) {
+
+    const uint8_t *pixel;
+    uint8_t *out = frame;
+    unsigned int done;
+    unsigned int s;
+    unsigned int l;
+
+    // swizzle as many pixels as possible in vector registers first
+    done = tafi_convert_swizzle(src, pitch, format, TAFI_SECTOR_COUNT, TAFI_SECTOR_LED_COUNT, frame);
+
+    for (s = 0; s < TAFI_SECTOR_COUNT; s++) {
+        for (l = 0; l < done; l++) {
+            out[0] = tafi_convert_channel(out[0], l);
+            out[1] = tafi_convert_channel(out[1], l);
+            out[2] = tafi_convert_channel(out[2], l);
+            out += TAFI_LED_COLOR_FIELD_COUNT;
+        }
+        pixel = src + s * pitch + done * format->cpp;
+        for (l = done; l < TAFI_SECTOR_LED_COUNT; l++) {
+            out[0] = tafi_convert_channel(pixel[format->blue], l);
+            out[1] = tafi_convert_channel(pixel[format->red], l);
+            out[2] = tafi_convert_channel(pixel[format->green], l);
+            pixel += format->cpp;
+            out += TAFI_LED_COLOR_FIELD_COUNT;
+        }
+    }
+}
@@ -0,0 +1,35 @@
+/**
+ *  tafi_lut.h -- The Amazing Fan Idea client library
+ *  User space declarations of the lookup tables generated by tafi_lutgen,
+ *  so the library compiles the same tafi_lut.c as the driver.
+ *
+ *      (C) 2017 Harindu Perera
+ *
+ *  This file is subject to the terms and conditions of the GNU General Public
+ *  License. See the file COPYING in the main directory of this archive for
+ *  more details.
+ */
+
+#ifndef TAFI_LUT_HDR
+#define TAFI_LUT_HDR
+
+#include <stdint.h>
+
+#include "../tafi_uapi.h"
+
+typedef uint8_t u8;
+typedef uint16_t u16;
+
+// (row, column) of the framebuffer pixel each LED samples, in wire order.
+extern const u8 tafi_lut_pixel[TAFI_SECTOR_COUNT][TAFI_SECTOR_LED_COUNT][2];
+
+// The same half a sector later, for odd revolutions of angular interleaving.
+extern const u8 tafi_lut_pixel_half[TAFI_SECTOR_COUNT][TAFI_SECTOR_LED_COUNT][2];
+
+// Brightness corrected wire value of each channel value, per LED.
+extern const u8 tafi_lut_wire[TAFI_SECTOR_LED_COUNT][256];
+
+// Wire level of 16 bit channel values in 1/256 of a step, per LED.
+extern const u16 tafi_lut_deep[TAFI_SECTOR_LED_COUNT][257];
+
+#endif
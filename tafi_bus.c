@@ -18,7 +18,16 @@
 // SPI header
 #include <linux/spi/spi.h>
 
+// DMA mapping of transmit buffers
+#include <linux/dma-mapping.h>
+#include <linux/dmaengine.h>
+
+#include <linux/atomic.h>
+#include <linux/module.h>
+#include <linux/completion.h>
+
 #include "tafi_common.h"
+#include "tafi_uapi.h"
 #include "tafi_bus.h"
 
 // GPIO
@@ -64,9 +73,32 @@ inline void tafi_frame_end(void) {
 
 // SPI
 
+static int spi_bus = TAFI_SPI_BUS_NUM;
+module_param(spi_bus, int, 0444);
+MODULE_PARM_DESC(spi_bus, "SPI bus the fan is on, e.g. a virtual controller for testing");
+
 // The global SPI device
 static struct spi_device *tafi_spi_device;
 
+static void tafi_spi_queue_complete(void *context);
+
+// Message reused for every frame, so none is built per write.
+static struct spi_transfer tafi_spi_transfer;
+static struct spi_message tafi_spi_message;
+
+// The same frame sent from a sector other than the first, see
+// tafi_data_write_rotated_locked().
+static struct spi_transfer tafi_spi_rotated_transfers[2];
+static struct spi_message tafi_spi_rotated_message;
+
+// Messages of a frame sent piece by piece, see tafi_data_queue_locked().
+static struct spi_transfer tafi_spi_queue_transfers[TAFI_SECTOR_COUNT];
+static struct spi_message tafi_spi_queue_messages[TAFI_SECTOR_COUNT];
+static unsigned int tafi_spi_queue_len;
+static atomic_t tafi_spi_queue_pending;
+static int tafi_spi_queue_status;
+static DECLARE_COMPLETION(tafi_spi_queue_done);
+
 /**
  * Initializes SPI device.
  * TODO: fix the hijacking voodoo mess, and ensure removal
@@ -75,13 +107,14 @@ static struct spi_device *tafi_spi_device;
 int tafi_spi_init(void) {
     
     int ret;
+    int i;
     struct spi_master *master;
     struct device *temp_device;
     char temp_device_buf[20];
 
     printk(KERN_INFO TAFI_LOG_PREFIX"starting SPI...");
 
-    master = spi_busnum_to_master(TAFI_SPI_BUS_NUM);
+    master = spi_busnum_to_master(spi_bus);
     if (!master) {
         printk(KERN_INFO TAFI_LOG_PREFIX"SPI master init failed.");
         return -ENODEV;
@@ -123,6 +156,17 @@ int tafi_spi_init(void) {
         return -ENODEV;
     }
 
+    spi_message_init(&tafi_spi_message);
+    spi_message_add_tail(&tafi_spi_transfer, &tafi_spi_message);
+    spi_message_init(&tafi_spi_rotated_message);
+    spi_message_add_tail(&tafi_spi_rotated_transfers[0], &tafi_spi_rotated_message);
+    spi_message_add_tail(&tafi_spi_rotated_transfers[1], &tafi_spi_rotated_message);
+    for (i = 0; i < TAFI_SECTOR_COUNT; i++) {
+        spi_message_init(&tafi_spi_queue_messages[i]);
+        spi_message_add_tail(&tafi_spi_queue_transfers[i], &tafi_spi_queue_messages[i]);
+        tafi_spi_queue_messages[i].complete = tafi_spi_queue_complete;
+    }
+
     printk(KERN_INFO TAFI_LOG_PREFIX"SPI started.");
     return 0;
 }
@@ -147,4 +191,162 @@ void tafi_spi_exit(void) {
  */
 inline int tafi_data_write(const void *buf, size_t len) {
     return spi_write(tafi_spi_device, buf, len);
-}
\ No newline at end of file
+}
+
+/**
+ * Device that performs the controller's transmit DMA, or NULL if the
+ * controller only does PIO.
+ */
+static struct device *tafi_spi_dma_device(void) {
+    struct spi_controller *ctlr = tafi_spi_device->controller;
+
+    if (!ctlr->dma_tx)
+        return NULL;
+    return ctlr->dma_tx->device->dev;
+}
+
+/**
+ * Device imported dma-bufs are attached to: the one doing the controller's
+ * DMA, or else the controller's parent, which has the DMA mask a PIO
+ * controller itself lacks.
+ */
+struct device *tafi_spi_import_device(void) {
+    struct device *dev = tafi_spi_dma_device();
+
+    return dev ? dev : tafi_spi_device->controller->dev.parent;
+}
+
+/**
+ * Map a buffer for transmission once, so it can be sent any number of
+ * times without being mapped again. The buffer must not change while
+ * mapped.
+ * Returns DMA_MAPPING_ERROR if the buffer can't or needn't be mapped.
+ */
+dma_addr_t tafi_spi_map(const void *buf, size_t len) {
+    struct device *dev = tafi_spi_dma_device();
+    dma_addr_t dma;
+
+    if (dev == NULL)
+        return DMA_MAPPING_ERROR;
+
+    dma = dma_map_single(dev, (void *) buf, len, DMA_TO_DEVICE);
+    if (dma_mapping_error(dev, dma))
+        return DMA_MAPPING_ERROR;
+    return dma;
+}
+
+/**
+ * Release a mapping made by tafi_spi_map().
+ */
+void tafi_spi_unmap(dma_addr_t dma, size_t len) {
+    if (dma != DMA_MAPPING_ERROR)
+        dma_unmap_single(tafi_spi_dma_device(), dma, len, DMA_TO_DEVICE);
+}
+
+/**
+ * Take the SPI bus for a frame, so no other device on the controller can
+ * delay it. Only the _locked writes may be used until unlocked.
+ */
+void tafi_bus_lock(void) {
+    spi_bus_lock(tafi_spi_device->controller);
+}
+
+void tafi_bus_unlock(void) {
+    spi_bus_unlock(tafi_spi_device->controller);
+}
+
+/**
+ * Write a buffer, optionally pre-mapped by tafi_spi_map(), with the bus
+ * held by tafi_bus_lock().
+ */
+int tafi_data_write_locked(const void *buf, dma_addr_t dma, size_t len) {
+    tafi_spi_transfer.tx_buf = buf;
+    tafi_spi_transfer.tx_dma = dma;
+    tafi_spi_transfer.len = len;
+    tafi_spi_message.is_dma_mapped = dma != DMA_MAPPING_ERROR;
+    return spi_sync_locked(tafi_spi_device, &tafi_spi_message);
+}
+
+/**
+ * Write a buffer, optionally pre-mapped, starting at byte start and
+ * wrapping around to its beginning, with the bus held by tafi_bus_lock().
+ * Both parts go out as one message.
+ */
+int tafi_data_write_rotated_locked(const void *buf, dma_addr_t dma, size_t len, size_t start) {
+    bool mapped = dma != DMA_MAPPING_ERROR;
+
+    if (start == 0)
+        return tafi_data_write_locked(buf, dma, len);
+
+    tafi_spi_rotated_transfers[0].tx_buf = buf + start;
+    tafi_spi_rotated_transfers[0].tx_dma = mapped ? dma + start : 0;
+    tafi_spi_rotated_transfers[0].len = len - start;
+    tafi_spi_rotated_transfers[1].tx_buf = buf;
+    tafi_spi_rotated_transfers[1].tx_dma = mapped ? dma : 0;
+    tafi_spi_rotated_transfers[1].len = start;
+    tafi_spi_rotated_message.is_dma_mapped = mapped;
+    return spi_sync_locked(tafi_spi_device, &tafi_spi_rotated_message);
+}
+
+/**
+ * Completion callback of queued pieces, runs in the controller's context.
+ */
+static void tafi_spi_queue_complete(void *context) {
+    struct spi_message *message = context;
+
+    if (message->status && !tafi_spi_queue_status)
+        tafi_spi_queue_status = message->status;
+    if (atomic_dec_and_test(&tafi_spi_queue_pending))
+        complete(&tafi_spi_queue_done);
+}
+
+/**
+ * Queue a piece of a frame with the bus held by tafi_bus_lock() and return
+ * without waiting for it, so the next piece can be prepared while this one
+ * is on the wire. The controller sends pieces in the order they were
+ * queued. The buffer must stay untouched until tafi_data_queue_wait().
+ */
+int tafi_data_queue_locked(const void *buf, size_t len) {
+    struct spi_message *message;
+    int ret;
+
+    if (tafi_spi_queue_len == TAFI_SECTOR_COUNT)
+        return -ENOSPC;
+
+    if (tafi_spi_queue_len == 0) {
+        tafi_spi_queue_status = 0;
+        reinit_completion(&tafi_spi_queue_done);
+        // held until every piece is queued, so the callback can't complete early
+        atomic_set(&tafi_spi_queue_pending, 1);
+    }
+
+    message = &tafi_spi_queue_messages[tafi_spi_queue_len];
+    message->context = message;
+    tafi_spi_queue_transfers[tafi_spi_queue_len].tx_buf = buf;
+    tafi_spi_queue_transfers[tafi_spi_queue_len].len = len;
+
+    atomic_inc(&tafi_spi_queue_pending);
+    ret = spi_async_locked(tafi_spi_device, message);
+    if (ret < 0) {
+        atomic_dec(&tafi_spi_queue_pending);
+        return ret;
+    }
+
+    tafi_spi_queue_len++;
+    return 0;
+}
+
+/**
+ * Wait until every queued piece has been sent.
+ * Returns the first error reported by the controller.
+ */
+int tafi_data_queue_wait(void) {
+    if (tafi_spi_queue_len == 0)
+        return 0;
+
+    if (!atomic_dec_and_test(&tafi_spi_queue_pending))
+        wait_for_completion(&tafi_spi_queue_done);
+
+    tafi_spi_queue_len = 0;
+    return tafi_spi_queue_status;
+}
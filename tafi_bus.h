@@ -12,6 +12,10 @@
 #ifndef TAFI_BUS
 #define TAFI_BUS
 
+#include <linux/types.h>
+
+struct device;
+
 // GPIO pin for sending the frame start/end signal
 #define TAFI_GPIO_FRAME_START_PIN 7
 
@@ -36,4 +40,22 @@ void tafi_spi_exit(void);
 
 int tafi_data_write(const void *buf, size_t len);
 
+dma_addr_t tafi_spi_map(const void *buf, size_t len);
+
+void tafi_spi_unmap(dma_addr_t dma, size_t len);
+
+struct device *tafi_spi_import_device(void);
+
+void tafi_bus_lock(void);
+
+void tafi_bus_unlock(void);
+
+int tafi_data_write_locked(const void *buf, dma_addr_t dma, size_t len);
+
+int tafi_data_write_rotated_locked(const void *buf, dma_addr_t dma, size_t len, size_t start);
+
+int tafi_data_queue_locked(const void *buf, size_t len);
+
+int tafi_data_queue_wait(void);
+
 #endif
\ No newline at end of file
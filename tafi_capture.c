@@ -0,0 +1,206 @@
+/**
+ *  tafi_capture.c -- The Amazing Fan Idea driver
+ *  Ring of recently transmitted frames, exposed through debugfs.
+ *
+ *  The transmit thread appends every frame it puts on the bus. Readers of
+ *  <debugfs>/tafi/capture stream the ring as tafi_capture_record structs,
+ *  oldest first, blocking for new frames once they have caught up.
+ * 
+ *      (C) 2017 Harindu Perera
+ *  
+ *  This file is subject to the terms and conditions of the GNU General Public
+ *  License. See the file COPYING in the main directory of this archive for
+ *  more details.
+ */
+
+#include <linux/module.h>
+#include <linux/fs.h>
+#include <linux/mutex.h>
+#include <linux/poll.h>
+#include <linux/slab.h>
+#include <linux/vmalloc.h>
+#include <linux/wait.h>
+#include <asm/uaccess.h>
+
+#include "tafi_common.h"
+#include "tafi_ioctl.h"
+#include "tafi_debugfs.h"
+#include "tafi_capture.h"
+
+static unsigned int capture_frames;
+module_param(capture_frames, uint, 0444);
+MODULE_PARM_DESC(capture_frames, "Number of transmitted frames kept in the debugfs capture ring (0 = disabled)");
+
+DEFINE_STATIC_KEY_FALSE(tafi_capture_enabled);
+
+// The ring itself, capture_frames records long.
+static struct tafi_capture_record *tafi_capture_ring;
+
+// Sequence number the next captured frame will get.
+static u64 tafi_capture_seq;
+
+// Protects the ring and the sequence counter.
+static DEFINE_MUTEX(tafi_capture_mutex);
+
+static DECLARE_WAIT_QUEUE_HEAD(tafi_capture_wait);
+
+// Per-reader state.
+struct tafi_capture_reader {
+    u64 next_seq;
+    struct tafi_capture_record record;
+};
+
+/**
+ * Append a transmitted frame to the ring, overwriting the oldest one.
+ */
+void __tafi_capture_frame(const void *buf, size_t len, ktime_t start, ktime_t end) {
+    struct tafi_capture_record *rec;
+
+    if (len > TAFI_DATA_BUF_LEN)
+        len = TAFI_DATA_BUF_LEN;
+
+    mutex_lock(&tafi_capture_mutex);
+    rec = &tafi_capture_ring[tafi_capture_seq % capture_frames];
+    rec->seq = tafi_capture_seq;
+    rec->timestamp_ns = ktime_to_ns(start);
+    rec->duration_ns = (u32) ktime_to_ns(ktime_sub(end, start));
+    rec->len = len;
+    memcpy(rec->data, buf, len);
+    tafi_capture_seq++;
+    mutex_unlock(&tafi_capture_mutex);
+
+    wake_up_interruptible(&tafi_capture_wait);
+}
+
+static bool tafi_capture_available(struct tafi_capture_reader *reader) {
+    return READ_ONCE(tafi_capture_seq) > reader->next_seq;
+}
+
+/**
+ * Copy the reader's next record into its private buffer.
+ * Returns false if nothing new has been captured yet.
+ */
+static bool tafi_capture_fetch(struct tafi_capture_reader *reader) {
+    u64 oldest;
+    bool ret = false;
+
+    mutex_lock(&tafi_capture_mutex);
+    if (tafi_capture_seq > reader->next_seq) {
+        // skip whatever has been overwritten since the last read
+        oldest = tafi_capture_seq > capture_frames ? tafi_capture_seq - capture_frames : 0;
+        if (reader->next_seq < oldest)
+            reader->next_seq = oldest;
+        memcpy(&reader->record, &tafi_capture_ring[reader->next_seq % capture_frames], sizeof(reader->record));
+        reader->next_seq++;
+        ret = true;
+    }
+    mutex_unlock(&tafi_capture_mutex);
+    return ret;
+}
+
+static int tafi_capture_open(struct inode *inodep, struct file *filep) {
+    struct tafi_capture_reader *reader;
+
+    reader = vmalloc(sizeof(*reader));
+    if (reader == NULL)
+        return -ENOMEM;
+
+    // start with the oldest frame still in the ring
+    mutex_lock(&tafi_capture_mutex);
+    reader->next_seq = tafi_capture_seq > capture_frames ? tafi_capture_seq - capture_frames : 0;
+    mutex_unlock(&tafi_capture_mutex);
+
+    filep->private_data = reader;
+    return nonseekable_open(inodep, filep);
+}
+
+static int tafi_capture_release(struct inode *inodep, struct file *filep) {
+    vfree(filep->private_data);
+    return 0;
+}
+
+/**
+ * Stream whole capture records to user space.
+ */
+static ssize_t tafi_capture_read(struct file *filep, char __user *buf, size_t len, loff_t *offset) {
+    struct tafi_capture_reader *reader = filep->private_data;
+    ssize_t copied = 0;
+    int ret;
+
+    if (len < sizeof(struct tafi_capture_record))
+        return -EINVAL;
+
+    while (len - copied >= sizeof(struct tafi_capture_record)) {
+        if (!tafi_capture_fetch(reader)) {
+            if (copied)
+                break;
+            if (filep->f_flags & O_NONBLOCK)
+                return -EAGAIN;
+            ret = wait_event_interruptible(tafi_capture_wait, tafi_capture_available(reader));
+            if (ret)
+                return ret;
+            continue;
+        }
+        if (copy_to_user(buf + copied, &reader->record, sizeof(reader->record)))
+            return copied ? copied : -EFAULT;
+        copied += sizeof(reader->record);
+    }
+
+    return copied;
+}
+
+static unsigned int tafi_capture_poll(struct file *filep, poll_table *wait) {
+    struct tafi_capture_reader *reader = filep->private_data;
+
+    poll_wait(filep, &tafi_capture_wait, wait);
+    return tafi_capture_available(reader) ? POLLIN | POLLRDNORM : 0;
+}
+
+static const struct file_operations tafi_capture_fops = {
+    .owner = THIS_MODULE,
+    .open = tafi_capture_open,
+    .read = tafi_capture_read,
+    .poll = tafi_capture_poll,
+    .release = tafi_capture_release,
+    .llseek = no_llseek,
+};
+
+/**
+ * Allocate the ring and publish it in debugfs, if capturing was requested.
+ */
+int tafi_capture_init(void) {
+    if (capture_frames == 0)
+        return 0;
+
+    if (!tafi_debugfs_dir()) {
+        printk(KERN_INFO TAFI_LOG_PREFIX"frame capture requested, but debugfs is not available.");
+        return 0;
+    }
+
+    if (capture_frames > TAFI_CAPTURE_MAX_FRAMES)
+        capture_frames = TAFI_CAPTURE_MAX_FRAMES;
+
+    tafi_capture_ring = vzalloc(capture_frames * sizeof(struct tafi_capture_record));
+    if (tafi_capture_ring == NULL) {
+        printk(KERN_ERR TAFI_LOG_PREFIX"failed to allocate memory for frame capture ring.");
+        return -ENOMEM;
+    }
+
+    debugfs_create_file(TAFI_CAPTURE_FILE_NAME, 0400, tafi_debugfs_dir(), NULL, &tafi_capture_fops);
+
+    static_branch_enable(&tafi_capture_enabled);
+    printk(KERN_INFO TAFI_LOG_PREFIX"capturing the last %u transmitted frames.", capture_frames);
+    return 0;
+}
+
+/**
+ * Stop capturing and free the ring.
+ * Must be called after the debugfs directory has been removed and the
+ * thread has stopped.
+ */
+void tafi_capture_exit(void) {
+    if (static_key_enabled(&tafi_capture_enabled))
+        static_branch_disable(&tafi_capture_enabled);
+    vfree(tafi_capture_ring);
+    tafi_capture_ring = NULL;
+}
@@ -0,0 +1,40 @@
+/**
+ *  tafi_capture.h -- The Amazing Fan Idea driver
+ *  Ring of recently transmitted frames, exposed through debugfs.
+ * 
+ *      (C) 2017 Harindu Perera
+ *  
+ *  This file is subject to the terms and conditions of the GNU General Public
+ *  License. See the file COPYING in the main directory of this archive for
+ *  more details.
+ */
+
+#ifndef TAFI_CAPTURE
+#define TAFI_CAPTURE
+
+#include <linux/jump_label.h>
+#include <linux/ktime.h>
+
+// Upper bound for the capture_frames module parameter.
+#define TAFI_CAPTURE_MAX_FRAMES 1024
+
+#define TAFI_CAPTURE_FILE_NAME "capture"
+
+DECLARE_STATIC_KEY_FALSE(tafi_capture_enabled);
+
+int tafi_capture_init(void);
+
+void tafi_capture_exit(void);
+
+void __tafi_capture_frame(const void *buf, size_t len, ktime_t start, ktime_t end);
+
+/**
+ * Record a frame that has just been transmitted.
+ * Compiles down to a patched-out branch unless capturing was enabled at load.
+ */
+static inline void tafi_capture_frame(const void *buf, size_t len, ktime_t start, ktime_t end) {
+    if (static_branch_unlikely(&tafi_capture_enabled))
+        __tafi_capture_frame(buf, len, start, end);
+}
+
+#endif
@@ -12,23 +12,60 @@
 
 #include "tafi_chardev.h"
 #include "tafi_ioctl.h"
+#include "tafi_convert.h"
+#include "tafi_dmabuf.h"
+#include "tafi_transform.h"
+#include "tafi_palette.h"
+#include "tafi_clock.h"
+#include "tafi_present.h"
 
 static struct mutex tafi_chardev_mutex;
 static int    tafi_chardev_major_number;                  ///< Stores the device number -- determined automatically
 static struct class*  tafi_chardev_class  = NULL; ///< The device-driver class struct pointer
 static struct device* tafi_chardev = NULL;
 
+// Per-open state.
+struct tafi_chardev_file {
+    // Serializes everything below between threads sharing the file.
+    struct mutex lock;
+    // Frame the open transaction is assembled in, written straight from
+    // user space. NULL while no transaction is open.
+    struct tafi_frame *staging;
+    // Sectors of the staging frame touched by the open transaction.
+    DECLARE_BITMAP(dirty_sectors, TAFI_SECTOR_COUNT);
+    struct tafi_range ranges[TAFI_SECTOR_COUNT];
+    // Task feeding the device a stream of frames through splice() or
+    // sendfile(), with lock held, NULL while there is none.
+    struct task_struct *streamer;
+    // Bytes of the current streamed frame already staged.
+    size_t stream_fill;
+    // TAFI_FORMAT_* of the data read and written.
+    u32 format;
+    // Frame written in TAFI_FORMAT_NATIVE16, kept across transactions so
+    // partial writes apply to it.
+    u16 *deep;
+    // How committed frames are presented.
+    struct tafi_presenter present;
+};
+
 static int     tafi_chardev_open(struct inode *, struct file *);
 static int     tafi_chardev_release(struct inode *, struct file *);
-static ssize_t tafi_chardev_read(struct file *, char *, size_t, loff_t *);
-static ssize_t tafi_chardev_write(struct file *, const char *, size_t, loff_t *);
+static ssize_t tafi_chardev_read_iter(struct kiocb *, struct iov_iter *);
+static ssize_t tafi_chardev_write_iter(struct kiocb *, struct iov_iter *);
+static ssize_t tafi_chardev_splice_write(struct pipe_inode_info *, struct file *, loff_t *, size_t, unsigned int);
+static long    tafi_chardev_ioctl(struct file *, unsigned int, unsigned long);
+static int     tafi_chardev_fsync(struct file *, loff_t, loff_t, int);
 
 static int tafi_chardev_uevent(struct device *dev, struct kobj_uevent_env *env);
 
 static struct file_operations fops = {
+    .owner = THIS_MODULE,
     .open = tafi_chardev_open,
-    .read = tafi_chardev_read,
-    .write = tafi_chardev_write,
+    .read_iter = tafi_chardev_read_iter,
+    .write_iter = tafi_chardev_write_iter,
+    .splice_write = tafi_chardev_splice_write,
+    .unlocked_ioctl = tafi_chardev_ioctl,
+    .fsync = tafi_chardev_fsync,
     .release = tafi_chardev_release,
 };
 
@@ -60,7 +97,9 @@ int tafi_chardev_init(void) {
     printk(KERN_INFO TAFI_LOG_PREFIX"device class registered correctly\n");
 
     // Register the device driver
-    tafi_chardev = device_create(tafi_chardev_class, NULL, MKDEV(tafi_chardev_major_number, 0), NULL, DEVICE_NAME);
+    // with the transform controls as attributes
+    tafi_chardev = device_create_with_groups(tafi_chardev_class, NULL, MKDEV(tafi_chardev_major_number, 0), NULL,
+        tafi_transform_groups, DEVICE_NAME);
     if (IS_ERR(tafi_chardev)){               // Clean up if there is an error
         class_destroy(tafi_chardev_class);           // Repeated code but the alternative is goto statements
         unregister_chrdev(tafi_chardev_major_number, DEVICE_NAME);
@@ -97,76 +136,655 @@ void tafi_chardev_exit(void) {
  * Handler called whenever the device is opened.
  */
 static int tafi_chardev_open(struct inode *inodep, struct file *filep){
+    struct tafi_chardev_file *file;
+
     if (!mutex_trylock(&tafi_chardev_mutex)) {
         printk(KERN_INFO TAFI_LOG_PREFIX"character device already open!");
         return -EBUSY;
     }
+
+    file = kzalloc(sizeof(*file), GFP_KERNEL);
+    if (file == NULL) {
+        printk(KERN_ERR TAFI_LOG_PREFIX"failed to allocate memory for character device staging buffer.");
+        mutex_unlock(&tafi_chardev_mutex);
+        return -ENOMEM;
+    }
+    mutex_init(&file->lock);
+    filep->private_data = file;
+
     printk(KERN_INFO TAFI_LOG_PREFIX"character device has been opened");
     return 0;
 }
  
 /**
- * Device read implementation.
+ * Bytes per sector in the file's format.
+ */
+static size_t tafi_chardev_sector_len(const struct tafi_chardev_file *file) {
+    switch (file->format) {
+    case TAFI_FORMAT_INDEXED8:
+        return TAFI_SECTOR_LED_COUNT;
+    case TAFI_FORMAT_NATIVE16:
+        return TAFI_SECTOR_BUF_LEN * 2;
+    default:
+        return TAFI_SECTOR_BUF_LEN;
+    }
+}
+
+static size_t tafi_chardev_frame_len(const struct tafi_chardev_file *file) {
+    return tafi_chardev_sector_len(file) * TAFI_SECTOR_COUNT;
+}
+
+/**
+ * Where the open transaction's bytes go.
  */
-static ssize_t tafi_chardev_read(struct file *filep, char *buf, size_t len, loff_t *offset) {
+static unsigned char *tafi_chardev_stage_buf(struct tafi_chardev_file *file) {
+    if (file->format == TAFI_FORMAT_NATIVE16)
+        return (unsigned char *) file->deep;
+    return file->staging->data;
+}
 
-    void *tmp_buf;
-    int error_count = 0;
+/**
+ * Device read implementation.
+ * Reads are served from the frame on display, which is never modified
+ * once published, so they are consistent without holding any lock the
+ * thread needs. The file's lock keeps its format steady meanwhile.
+ */
+static ssize_t tafi_chardev_read_locked(struct tafi_chardev_file *file, struct kiocb *iocb, struct iov_iter *to) {
+    struct tafi_frame *frame;
+    ssize_t len;
+    size_t copied;
 
-    printk(KERN_INFO TAFI_LOG_PREFIX"requested %d characters to user space at offset %d", len, *offset);
+    if (iocb->ki_pos >= tafi_chardev_frame_len(file)) {
+        return 0;
+    }
 
-    len = tafi_check_bounds(len, *offset);
+    len = tafi_check_bounds_size(iov_iter_count(to), iocb->ki_pos, tafi_chardev_frame_len(file));
     if (len < 0) {
         return -EFAULT;
     }
 
-    tmp_buf = kmalloc(len, GFP_KERNEL);
-    if (tmp_buf == NULL) {
-        printk(KERN_ERR TAFI_LOG_PREFIX"failed to allocate memory for character device copy buffer.");
+    if (file->format == TAFI_FORMAT_NATIVE16) {
+        // the wire has no 16 bit frame, return this file's own
+        copied = copy_to_iter((unsigned char *) file->deep + iocb->ki_pos, len, to);
+        iocb->ki_pos += copied;
+        return copied;
+    }
+
+    if (file->format == TAFI_FORMAT_INDEXED8) {
+        // a native frame has no indices to return
+        frame = tafi_frame_get_live();
+        if (!frame->indexed) {
+            tafi_frame_put(frame);
+            return -ENODATA;
+        }
+    } else {
+        frame = tafi_frame_get_live_native();
+        if (frame == NULL) {
+            return -ENOMEM;
+        }
+    }
+    copied = copy_to_iter(frame->data + iocb->ki_pos, len, to);
+    tafi_frame_put(frame);
+    if (copied == 0 && len > 0) {
+        printk(KERN_INFO TAFI_LOG_PREFIX"failed to send %zd characters to user space", len);
+        return -EFAULT;
+    }
+
+    iocb->ki_pos += copied;
+    return copied;
+}
+
+static ssize_t tafi_chardev_read_iter(struct kiocb *iocb, struct iov_iter *to) {
+    struct tafi_chardev_file *file = iocb->ki_filp->private_data;
+    ssize_t ret;
+
+    mutex_lock(&file->lock);
+    ret = tafi_chardev_read_locked(file, iocb, to);
+    mutex_unlock(&file->lock);
+    return ret;
+}
+
+/**
+ * Open a transaction if there is none. With snapshot set it starts from
+ * the frame on display, so sectors that are only partly written keep their
+ * other bytes; otherwise the caller must write the whole frame.
+ */
+static int tafi_chardev_begin(struct tafi_chardev_file *file, bool snapshot) {
+    struct tafi_frame *live;
+
+    if (file->staging) {
+        return 0;
+    }
+
+    file->staging = tafi_frame_alloc();
+    if (file->staging == NULL) {
+        return -ENOMEM;
+    }
+
+    file->staging->indexed = file->format == TAFI_FORMAT_INDEXED8;
+
+    if (snapshot && file->staging->indexed) {
+        // indices of the frame on display, if it has any
+        live = tafi_frame_get_live();
+        if (live->indexed) {
+            memcpy(file->staging->data, live->data, TAFI_INDEXED_BUF_LEN);
+        } else {
+            memset(file->staging->data, 0, TAFI_INDEXED_BUF_LEN);
+        }
+        tafi_frame_put(live);
+    } else if (snapshot && file->format == TAFI_FORMAT_NATIVE) {
+        live = tafi_frame_get_live_native();
+        if (live == NULL) {
+            tafi_frame_put(file->staging);
+            file->staging = NULL;
+            return -ENOMEM;
+        }
+        memcpy(file->staging->data, live->data, TAFI_DATA_BUF_LEN);
+        tafi_frame_put(live);
+    }
+    bitmap_zero(file->dirty_sectors, TAFI_SECTOR_COUNT);
+    return 0;
+}
+
+/**
+ * Convert a TAFI_FORMAT_NATIVE16 transaction into its staging frame, which
+ * then holds a whole frame. On failure the transaction is dropped.
+ */
+static int tafi_chardev_finish_deep(struct tafi_chardev_file *file) {
+    u8 *frac;
+
+    if (file->format != TAFI_FORMAT_NATIVE16) {
+        return 0;
+    }
+
+    // a commit that failed and is retried converts again
+    kfree(file->staging->dither);
+    file->staging->dither = NULL;
+
+    frac = kmalloc(TAFI_DATA_BUF_LEN, GFP_KERNEL);
+    if (frac == NULL) {
+        printk(KERN_ERR TAFI_LOG_PREFIX"failed to allocate memory for dithering.");
+        tafi_frame_put(file->staging);
+        file->staging = NULL;
         return -ENOMEM;
     }
+    // frames the wire can show exactly skip dithering, and can idle
+    if (tafi_convert_deep(file->deep, file->staging->data, frac)) {
+        file->staging->dither = frac;
+    } else {
+        kfree(frac);
+    }
+    bitmap_fill(file->dirty_sectors, TAFI_SECTOR_COUNT);
+    return 0;
+}
 
-    tafi_get_color_data(tmp_buf, len, *offset);
+/**
+ * Drop the open transaction if nothing was staged in it, e.g. by a write
+ * that faulted. It would only present the snapshot it was opened with
+ * again. Indexed and NATIVE16 transactions are always whole frames.
+ * Returns true if it was dropped.
+ */
+static bool tafi_chardev_drop_empty(struct tafi_chardev_file *file) {
+    if (!bitmap_empty(file->dirty_sectors, TAFI_SECTOR_COUNT) || file->staging->indexed ||
+        file->format == TAFI_FORMAT_NATIVE16) {
+        return false;
+    }
 
-    // copy_to_user has the format ( * to, *from, size) and returns 0 on success
-    error_count = copy_to_user(buf, tmp_buf, len);
+    tafi_frame_put(file->staging);
+    file->staging = NULL;
+    return true;
+}
 
-    kfree(tmp_buf);
+/**
+ * Make the open transaction go live as one update, as the file's
+ * presentation mode says. In FIFO mode this may wait for room in the
+ * queue, or fail with -EAGAIN if nonblock is set; the transaction stays
+ * open if it fails.
+ * The ticket for tafi_wait_for_pickup() goes to ticket, if given.
+ */
+static int tafi_chardev_commit(struct tafi_chardev_file *file, bool nonblock, u64 *ticket) {
+    unsigned int count;
+    u64 pickup;
+    int ret;
 
-    if (error_count == 0) {
-        // if true then have success
-        printk(KERN_INFO TAFI_LOG_PREFIX"read data");
+    if (file->staging == NULL || tafi_chardev_drop_empty(file)) {
+        pickup = tafi_color_data_pickup_count();
+        goto out;
     }
-    else {
-        printk(KERN_INFO TAFI_LOG_PREFIX"failed to send %d characters to user space", error_count);
+
+    ret = tafi_chardev_finish_deep(file);
+    if (ret < 0) {
+        return ret;
+    }
+
+    if (bitmap_full(file->dirty_sectors, TAFI_SECTOR_COUNT) || file->staging->indexed) {
+        // whole frame rewritten, or an indexed one that can't be merged
+        // into a native frame, hand it over as is
+        ret = tafi_present_frame(&file->present, file->staging, nonblock, &pickup);
+        if (ret < 0) {
+            return ret;
+        }
+    } else {
+        count = tafi_convert_sectors_to_ranges(file->dirty_sectors, file->ranges);
+        ret = tafi_present_ranges(&file->present, file->staging->data, file->ranges, count, nonblock, &pickup);
+        if (ret < 0) {
+            return ret;
+        }
+        tafi_frame_put(file->staging);
+    }
+    file->staging = NULL;
+
+out:
+    if (ticket) {
+        *ticket = pickup;
+    }
+    return 0;
+}
+
+/**
+ * Make the open transaction go live at a tick of the frame clock. The
+ * whole staging frame is scheduled, so sectors the transaction didn't
+ * write show what was on display when it was opened.
+ */
+static int tafi_chardev_commit_at(struct tafi_chardev_file *file, u64 tick) {
+    int ret;
+
+    if (file->staging == NULL || tafi_chardev_drop_empty(file)) {
+        return 0;
+    }
+
+    ret = tafi_chardev_finish_deep(file);
+    if (ret < 0) {
+        return ret;
+    }
+
+    file->staging->fade = file->present.fade;
+    tafi_publish_frame_at(file->staging, tick);
+    file->staging = NULL;
+    return 0;
+}
+
+/**
+ * Mark the sectors overlapping a byte range of the frame as touched.
+ */
+static void tafi_chardev_touch(struct tafi_chardev_file *file, loff_t offset, size_t len) {
+    unsigned int first = offset / tafi_chardev_sector_len(file);
+    unsigned int last = (offset + len - 1) / tafi_chardev_sector_len(file);
+
+    bitmap_set(file->dirty_sectors, first, last - first + 1);
+}
+
+/**
+ * Stage a contiguous update starting at the file position.
+ */
+static ssize_t tafi_chardev_stage_linear(struct tafi_chardev_file *file, struct iov_iter *from, loff_t offset) {
+    ssize_t len;
+
+    len = tafi_check_bounds_size(iov_iter_count(from), offset, tafi_chardev_frame_len(file));
+    if (len < 0) {
+        return -EFAULT;
+    }
+
+    if (copy_from_iter(tafi_chardev_stage_buf(file) + offset, len, from) != len) {
         return -EFAULT;
     }
 
-    printk(KERN_INFO TAFI_LOG_PREFIX"sent %d characters to user space at offset %d", len, *offset);
-    
+    if (len > 0) {
+        tafi_chardev_touch(file, offset, len);
+    }
     return len;
 }
- 
+
 /**
- * Write data to device.
+ * Stage a sequence of tafi_sector_range records, see TAFI_SPARSE_WRITE_OFFSET.
  */
-static ssize_t tafi_chardev_write(struct file *filep, const char *buf, size_t len, loff_t *offset) {
-   
-    len = tafi_check_bounds(len, *offset);
+static ssize_t tafi_chardev_stage_sparse(struct tafi_chardev_file *file, struct iov_iter *from) {
+    struct tafi_sector_range range;
+    size_t len;
+    ssize_t total = 0;
+
+    while (iov_iter_count(from) > 0) {
+        // a truncated record is malformed, a short copy is a fault
+        if (iov_iter_count(from) < sizeof(range)) {
+            return -EINVAL;
+        }
+        if (copy_from_iter(&range, sizeof(range), from) != sizeof(range)) {
+            return -EFAULT;
+        }
+        if (range.sector_count == 0 || range.first_sector >= TAFI_SECTOR_COUNT ||
+            range.sector_count > TAFI_SECTOR_COUNT - range.first_sector) {
+            return -EINVAL;
+        }
+
+        len = range.sector_count * tafi_chardev_sector_len(file);
+        if (iov_iter_count(from) < len) {
+            return -EINVAL;
+        }
+        if (copy_from_iter(tafi_chardev_stage_buf(file) + range.first_sector * tafi_chardev_sector_len(file), len, from) != len) {
+            return -EFAULT;
+        }
+
+        bitmap_set(file->dirty_sectors, range.first_sector, range.sector_count);
+        total += sizeof(range) + len;
+    }
+
+    return total;
+}
+
+/**
+ * Stage streamed data frame by frame. Every completed frame is committed
+ * and the caller is held back until the thread has picked it up, so a
+ * stream plays at the display's pace.
+ */
+static ssize_t tafi_chardev_stage_stream(struct tafi_chardev_file *file, struct iov_iter *from) {
+    size_t chunk;
+    ssize_t total = 0;
+    u64 ticket;
+    int ret;
+
+    while (iov_iter_count(from) > 0) {
+        ret = tafi_chardev_begin(file, false);
+        if (ret < 0) {
+            return total ? total : ret;
+        }
+
+        chunk = min_t(size_t, iov_iter_count(from), tafi_chardev_frame_len(file) - file->stream_fill);
+        if (copy_from_iter(tafi_chardev_stage_buf(file) + file->stream_fill, chunk, from) != chunk) {
+            return total ? total : -EFAULT;
+        }
+        tafi_chardev_touch(file, file->stream_fill, chunk);
+        file->stream_fill += chunk;
+        total += chunk;
+
+        if (file->stream_fill == tafi_chardev_frame_len(file)) {
+            ret = tafi_chardev_commit(file, false, &ticket);
+            if (ret < 0) {
+                // the whole frame stays staged, the next write commits it
+                return total ? total : ret;
+            }
+            file->stream_fill = 0;
+            if (tafi_wait_for_pickup(ticket)) {
+                // interrupted, the frame is committed but not yet shown
+                break;
+            }
+        }
+    }
+
+    return total;
+}
+
+/**
+ * Stage one write, and commit it if it must go live now. Called with the
+ * file's lock held.
+ */
+static ssize_t tafi_chardev_write_locked(struct tafi_chardev_file *file, struct kiocb *iocb, struct iov_iter *from,
+    bool sync, u64 *ticket) {
+
+    ssize_t len;
+    int ret;
+
+    len = tafi_chardev_begin(file, true);
     if (len < 0) {
-        return -EFAULT;
+        return len;
     }
 
-    tafi_set_color_data(buf, len, *offset);
+    if (iocb->ki_pos == TAFI_SPARSE_WRITE_OFFSET) {
+        len = tafi_chardev_stage_sparse(file, from);
+    } else {
+        len = tafi_chardev_stage_linear(file, from, iocb->ki_pos);
+        if (len > 0) {
+            iocb->ki_pos += len;
+        }
+    }
 
-    printk(KERN_INFO TAFI_LOG_PREFIX"received %d from user space", len);
+    if (len < 0) {
+        return len;
+    }
+
+    if (sync || file->present.mode == TAFI_PRESENT_IMMEDIATE) {
+        ret = tafi_chardev_commit(file, iocb->ki_filp->f_flags & O_NONBLOCK, ticket);
+        if (ret < 0) {
+            return ret;
+        }
+    }
     return len;
 }
+
+/**
+ * Write data to device.
+ * Writes are copied from user space straight into the transaction's
+ * staging frame, without holding any lock the thread needs. Nothing goes
+ * live until the transaction is committed, so the thread never transmits
+ * half of an update.
+ * With IOCB_DSYNC the write returns once the update is on display; the
+ * wait happens with the file unlocked.
+ */
+static ssize_t tafi_chardev_write_iter(struct kiocb *iocb, struct iov_iter *from) {
+
+    struct tafi_chardev_file *file = iocb->ki_filp->private_data;
+    bool sync = iocb->ki_flags & IOCB_DSYNC;
+    ssize_t len;
+    u64 ticket;
+    int ret;
+
+    // nothing to stage, and no transaction to open for it
+    if (iov_iter_count(from) == 0) {
+        return 0;
+    }
+
+    // called back from our own splice_write, which holds the lock
+    if (READ_ONCE(file->streamer) == current) {
+        return tafi_chardev_stage_stream(file, from);
+    }
+
+    mutex_lock(&file->lock);
+    len = tafi_chardev_write_locked(file, iocb, from, sync, &ticket);
+    mutex_unlock(&file->lock);
+
+    if (len >= 0 && sync) {
+        ret = tafi_wait_for_pickup(ticket);
+        if (ret < 0) {
+            return ret;
+        }
+    }
+    return len;
+}
+
+/**
+ * Commit the open transaction and wait until it is on display.
+ */
+static int tafi_chardev_fsync(struct file *filep, loff_t start, loff_t end, int datasync) {
+    struct tafi_chardev_file *file = filep->private_data;
+    u64 ticket;
+    int ret;
+
+    mutex_lock(&file->lock);
+    ret = tafi_chardev_commit(file, false, &ticket);
+    mutex_unlock(&file->lock);
+    if (ret < 0)
+        return ret;
+    return tafi_wait_for_pickup(ticket);
+}
+ 
+/**
+ * Accept splice()/sendfile() input as a stream of raw TAFI_DATA_BUF_LEN
+ * frames. The pipe's page cache pages are staged straight into the frame,
+ * without a round trip through user space. A frame may span several calls.
+ * The file stays locked for the whole splice, its writes come back through
+ * tafi_chardev_write_iter() on this task.
+ */
+static ssize_t tafi_chardev_splice_write(struct pipe_inode_info *pipe, struct file *out, loff_t *ppos, size_t len, unsigned int flags) {
+    struct tafi_chardev_file *file = out->private_data;
+    // the stream position is tracked in stream_fill, not in the file
+    loff_t pos = 0;
+    ssize_t ret;
+
+    mutex_lock(&file->lock);
+    WRITE_ONCE(file->streamer, current);
+    ret = iter_file_splice_write(pipe, out, &pos, len, flags);
+    WRITE_ONCE(file->streamer, NULL);
+    mutex_unlock(&file->lock);
+
+    return ret;
+}
  
+/**
+ * Device ioctl implementation. Called with the file's lock held.
+ */
+static long tafi_chardev_ioctl_locked(struct file *filep, unsigned int cmd, unsigned long arg) {
+    struct tafi_chardev_file *file = filep->private_data;
+    void __user *argp = (void __user *) arg;
+    struct tafi_dmabuf_export export_args;
+    struct tafi_dmabuf_queue queue_args;
+    struct tafi_transform transform;
+    struct tafi_palette *palette;
+    struct tafi_clock_info clock;
+    struct tafi_present present;
+    u64 tick;
+    u32 format;
+    u32 fade;
+    int ret;
+
+    switch (cmd) {
+    case TAFI_IOC_DMABUF_EXPORT:
+        if (copy_from_user(&export_args, argp, sizeof(export_args)))
+            return -EFAULT;
+        ret = tafi_dmabuf_export_frame(&export_args);
+        if (ret)
+            return ret;
+        if (copy_to_user(argp, &export_args, sizeof(export_args)))
+            return -EFAULT;
+        return 0;
+    case TAFI_IOC_DMABUF_QUEUE:
+        if (copy_from_user(&queue_args, argp, sizeof(queue_args)))
+            return -EFAULT;
+        ret = tafi_dmabuf_queue(&queue_args, &file->present, filep->f_flags & O_NONBLOCK);
+        if (ret)
+            return ret;
+        if (copy_to_user(argp, &queue_args, sizeof(queue_args)))
+            return -EFAULT;
+        return 0;
+    case TAFI_IOC_COMMIT:
+        return tafi_chardev_commit(file, filep->f_flags & O_NONBLOCK, NULL);
+    case TAFI_IOC_COMMIT_AT:
+        if (get_user(tick, (u64 __user *) argp))
+            return -EFAULT;
+        // a partly streamed frame isn't whole yet
+        if (file->stream_fill)
+            return -EBUSY;
+        return tafi_chardev_commit_at(file, tick);
+    case TAFI_IOC_GET_CLOCK:
+        memset(&clock, 0, sizeof(clock));
+        clock.tick = tafi_clock_seq();
+        clock.tick_ns = ktime_to_ns(tafi_clock_last_tick());
+        clock.period_us = TAFI_FRAME_PERIOD_US;
+        if (tafi_clock_synced())
+            clock.flags |= TAFI_CLOCK_SYNCED;
+        if (copy_to_user(argp, &clock, sizeof(clock)))
+            return -EFAULT;
+        return 0;
+    case TAFI_IOC_SET_CLOCK:
+        if (get_user(tick, (u64 __user *) argp))
+            return -EFAULT;
+        tafi_clock_set_next(tick);
+        return 0;
+    case TAFI_IOC_SET_TRANSFORM:
+        if (copy_from_user(&transform, argp, sizeof(transform)))
+            return -EFAULT;
+        return tafi_transform_set(&transform);
+    case TAFI_IOC_GET_TRANSFORM:
+        tafi_transform_get(&transform);
+        if (copy_to_user(argp, &transform, sizeof(transform)))
+            return -EFAULT;
+        return 0;
+    case TAFI_IOC_SET_PALETTE:
+        palette = memdup_user(argp, sizeof(*palette));
+        if (IS_ERR(palette))
+            return PTR_ERR(palette);
+        tafi_palette_set((const u8 (*)[3]) palette->entries, 0, TAFI_PALETTE_SIZE);
+        kfree(palette);
+        return 0;
+    case TAFI_IOC_GET_PALETTE:
+        palette = kmalloc(sizeof(*palette), GFP_KERNEL);
+        if (palette == NULL)
+            return -ENOMEM;
+        tafi_palette_get(palette->entries);
+        ret = copy_to_user(argp, palette, sizeof(*palette)) ? -EFAULT : 0;
+        kfree(palette);
+        return ret;
+    case TAFI_IOC_SET_FORMAT:
+        if (get_user(format, (u32 __user *) argp))
+            return -EFAULT;
+        if (format != TAFI_FORMAT_NATIVE && format != TAFI_FORMAT_INDEXED8 && format != TAFI_FORMAT_NATIVE16)
+            return -EINVAL;
+        // a partly streamed frame can't change its layout
+        if (file->stream_fill)
+            return -EBUSY;
+        if (format == TAFI_FORMAT_NATIVE16 && file->deep == NULL) {
+            file->deep = kzalloc(TAFI_DEEP_BUF_LEN, GFP_KERNEL);
+            if (file->deep == NULL)
+                return -ENOMEM;
+        }
+        ret = tafi_chardev_commit(file, filep->f_flags & O_NONBLOCK, NULL);
+        if (ret < 0)
+            return ret;
+        file->format = format;
+        return 0;
+    case TAFI_IOC_SET_PRESENT:
+        if (copy_from_user(&present, argp, sizeof(present)))
+            return -EFAULT;
+        if (file->stream_fill)
+            return -EBUSY;
+        ret = tafi_chardev_commit(file, filep->f_flags & O_NONBLOCK, NULL);
+        if (ret < 0)
+            return ret;
+        return tafi_present_set(&file->present, &present);
+    case TAFI_IOC_GET_PRESENT:
+        tafi_present_get(&file->present, &present);
+        if (copy_to_user(argp, &present, sizeof(present)))
+            return -EFAULT;
+        return 0;
+    case TAFI_IOC_SET_FADE:
+        // applies from the open transaction on
+        if (get_user(fade, (u32 __user *) argp))
+            return -EFAULT;
+        return tafi_present_set_fade(&file->present, fade);
+    case TAFI_IOC_GET_FADE:
+        return put_user(file->present.fade, (u32 __user *) argp);
+    default:
+        return -ENOTTY;
+    }
+}
+
+static long tafi_chardev_ioctl(struct file *filep, unsigned int cmd, unsigned long arg) {
+    struct tafi_chardev_file *file = filep->private_data;
+    long ret;
+
+    mutex_lock(&file->lock);
+    ret = tafi_chardev_ioctl_locked(filep, cmd, arg);
+    mutex_unlock(&file->lock);
+    return ret;
+}
+
 /**
  * Release chardev after closure
  */
 static int tafi_chardev_release(struct inode *inodep, struct file *filep) {
+   struct tafi_chardev_file *file = filep->private_data;
+
+   mutex_lock(&file->lock);
+   // a partly streamed frame is dropped, anything else written goes live
+   if (file->stream_fill) {
+       tafi_frame_put(file->staging);
+   } else if (tafi_chardev_commit(file, false, NULL) < 0) {
+       // e.g. interrupted while waiting for room in the queue
+       tafi_frame_put(file->staging);
+       tafi_present_drop(&file->present);
+   }
+   mutex_unlock(&file->lock);
+   mutex_destroy(&file->lock);
+   kfree(file->deep);
+   kfree(file);
    mutex_unlock(&tafi_chardev_mutex);
    printk(KERN_INFO TAFI_LOG_PREFIX"Device successfully closed\n");
    return 0;
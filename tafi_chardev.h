@@ -18,6 +18,9 @@
 // Required for the copy to user function
 #include <asm/uaccess.h>
 
+// Vectored read/write iterators
+#include <linux/uio.h>
+
 // For kmalloc
 #include <linux/slab.h>
 
@@ -0,0 +1,235 @@
+/**
+ *  tafi_clock.c -- The Amazing Fan Idea driver
+ *  Frame clock pacing the transmit thread.
+ *
+ *  By default the clock is an hrtimer ticking every TAFI_FRAME_PERIOD_US
+ *  on absolute deadlines, so the frame rate doesn't drift by the time
+ *  spent transmitting. With sync_gpio set, every rising edge on that input
+ *  is a tick instead. Fans wired to the same sync line start their frames
+ *  together. Once every fan of the group has numbered the same edge with
+ *  TAFI_IOC_SET_CLOCK they count the same edges from the same number, and
+ *  a frame committed for a given tick with TAFI_IOC_COMMIT_AT shows on all
+ *  of them at once.
+ *
+ *      (C) 2017 Harindu Perera
+ *
+ *  This file is subject to the terms and conditions of the GNU General Public
+ *  License. See the file COPYING in the main directory of this archive for
+ *  more details.
+ */
+
+#include <linux/gpio.h>
+#include <linux/hrtimer.h>
+#include <linux/interrupt.h>
+#include <linux/kthread.h>
+#include <linux/math64.h>
+#include <linux/module.h>
+#include <linux/sched.h>
+#include <linux/wait.h>
+
+#include "tafi_common.h"
+#include "tafi_stats.h"
+#include "tafi_clock.h"
+
+static int sync_gpio = -1;
+module_param(sync_gpio, int, 0444);
+MODULE_PARM_DESC(sync_gpio, "GPIO whose rising edges start frames, shared by a group of fans (-1 = internal clock)");
+
+// Without sync edges for this long the clock runs on its own, so a broken
+// sync line doesn't freeze the display.
+#define TAFI_CLOCK_SYNC_TIMEOUT_PERIODS 4
+
+static int tafi_clock_irq = -1;
+
+// Number of the last tick, and its time.
+static u64 tafi_clock_ticks;
+static ktime_t tafi_clock_tick_time;
+static DEFINE_SPINLOCK(tafi_clock_lock);
+
+// Number the next tick gets, if tafi_clock_numbered is set.
+static u64 tafi_clock_next;
+static bool tafi_clock_numbered;
+
+// Internal clock: time of its first period, and periods since then at
+// the last tick.
+static ktime_t tafi_clock_epoch;
+static u64 tafi_clock_periods;
+
+// Sync input: edges so far, and those the thread has seen.
+static u64 tafi_clock_edges;
+static u64 tafi_clock_seen;
+static DECLARE_WAIT_QUEUE_HEAD(tafi_clock_wait_queue);
+
+static TAFI_COUNTER(tafi_sync_timeouts, "sync_timeouts");
+
+/**
+ * Count a tick, n ticks after the last one unless tafi_clock_set_next()
+ * numbered it. Called with tafi_clock_lock held.
+ */
+static void tafi_clock_advance(u64 n, ktime_t time) {
+    if (tafi_clock_numbered) {
+        tafi_clock_ticks = tafi_clock_next;
+        tafi_clock_numbered = false;
+    } else {
+        tafi_clock_ticks += n;
+    }
+    tafi_clock_tick_time = time;
+}
+
+static irqreturn_t tafi_clock_sync_irq(int irq, void *data) {
+    ktime_t now = ktime_get();
+
+    spin_lock(&tafi_clock_lock);
+    tafi_clock_edges++;
+    tafi_clock_advance(1, now);
+    spin_unlock(&tafi_clock_lock);
+
+    wake_up(&tafi_clock_wait_queue);
+    return IRQ_HANDLED;
+}
+
+/**
+ * Sleep until the next tick of the internal clock. Ticks missed while the
+ * thread was busy or idle are skipped, not caught up on.
+ */
+static ktime_t tafi_clock_wait_internal(void) {
+    ktime_t deadline;
+    u64 periods;
+
+    periods = div_u64(ktime_to_ns(ktime_sub(ktime_get(), tafi_clock_epoch)), TAFI_FRAME_PERIOD_US * NSEC_PER_USEC) + 1;
+    deadline = ktime_add_ns(tafi_clock_epoch, periods * TAFI_FRAME_PERIOD_US * NSEC_PER_USEC);
+
+    set_current_state(TASK_INTERRUPTIBLE);
+    schedule_hrtimeout_range(&deadline, 0, HRTIMER_MODE_ABS);
+
+    spin_lock_irq(&tafi_clock_lock);
+    tafi_clock_advance(periods - tafi_clock_periods, deadline);
+    spin_unlock_irq(&tafi_clock_lock);
+    tafi_clock_periods = periods;
+    return deadline;
+}
+
+/**
+ * Wait for the next edge on the sync input.
+ */
+static ktime_t tafi_clock_wait_sync(void) {
+    long ret;
+    u64 edges;
+    ktime_t time;
+
+    ret = wait_event_interruptible_timeout(tafi_clock_wait_queue,
+        READ_ONCE(tafi_clock_edges) != tafi_clock_seen || kthread_should_stop(),
+        usecs_to_jiffies(TAFI_CLOCK_SYNC_TIMEOUT_PERIODS * TAFI_FRAME_PERIOD_US));
+
+    spin_lock_irq(&tafi_clock_lock);
+    if (ret == 0) {
+        // no edge, keep going at the nominal rate without counting a tick
+        tafi_counter_inc(&tafi_sync_timeouts);
+        tafi_clock_tick_time = ktime_get();
+    }
+    edges = tafi_clock_edges;
+    time = tafi_clock_tick_time;
+    spin_unlock_irq(&tafi_clock_lock);
+
+    tafi_clock_seen = edges;
+    return time;
+}
+
+/**
+ * Wait for the next frame start, called by the transmit thread only.
+ * Returns the time the tick was due.
+ */
+ktime_t tafi_clock_wait(void) {
+    if (tafi_clock_irq >= 0)
+        return tafi_clock_wait_sync();
+    return tafi_clock_wait_internal();
+}
+
+/**
+ * Number the next tick, and count on from there. A frame already
+ * scheduled for a tick keeps that number, which then counts in the new
+ * numbering.
+ */
+void tafi_clock_set_next(u64 tick) {
+    spin_lock_irq(&tafi_clock_lock);
+    tafi_clock_next = tick;
+    tafi_clock_numbered = true;
+    spin_unlock_irq(&tafi_clock_lock);
+}
+
+/**
+ * Number of the last tick, counted from module load or from the tick
+ * numbered by tafi_clock_set_next().
+ */
+u64 tafi_clock_seq(void) {
+    u64 ticks;
+
+    spin_lock_irq(&tafi_clock_lock);
+    ticks = tafi_clock_ticks;
+    spin_unlock_irq(&tafi_clock_lock);
+    return ticks;
+}
+
+ktime_t tafi_clock_last_tick(void) {
+    ktime_t time;
+
+    spin_lock_irq(&tafi_clock_lock);
+    time = tafi_clock_tick_time;
+    spin_unlock_irq(&tafi_clock_lock);
+    return time;
+}
+
+/**
+ * Whether ticks come from the sync input.
+ */
+bool tafi_clock_synced(void) {
+    return tafi_clock_irq >= 0;
+}
+
+int tafi_clock_init(void) {
+    int ret;
+
+    tafi_clock_epoch = ktime_get();
+    tafi_clock_tick_time = tafi_clock_epoch;
+    tafi_stats_register_counter(&tafi_sync_timeouts);
+
+    if (sync_gpio < 0)
+        return 0;
+
+    ret = gpio_request_one(sync_gpio, GPIOF_IN, "TAFI_GPIO_SYNC_PIN");
+    if (ret < 0) {
+        printk(KERN_ERR TAFI_LOG_PREFIX"failed to get sync GPIO %d.", sync_gpio);
+        return ret;
+    }
+
+    tafi_clock_irq = gpio_to_irq(sync_gpio);
+    if (tafi_clock_irq < 0) {
+        ret = tafi_clock_irq;
+        goto err_gpio;
+    }
+
+    // hard IRQ, the edge is timestamped before anything else runs
+    ret = request_irq(tafi_clock_irq, tafi_clock_sync_irq, IRQF_TRIGGER_RISING, TAFI_DRIVER_NAME "-sync", NULL);
+    if (ret < 0)
+        goto err_gpio;
+
+    printk(KERN_INFO TAFI_LOG_PREFIX"frames synced to GPIO %d.", sync_gpio);
+    return 0;
+
+err_gpio:
+    printk(KERN_ERR TAFI_LOG_PREFIX"failed to get sync interrupt.");
+    tafi_clock_irq = -1;
+    gpio_free(sync_gpio);
+    return ret;
+}
+
+/**
+ * Must be called after the thread has stopped.
+ */
+void tafi_clock_exit(void) {
+    if (tafi_clock_irq < 0)
+        return;
+    free_irq(tafi_clock_irq, NULL);
+    gpio_free(sync_gpio);
+    tafi_clock_irq = -1;
+}
@@ -0,0 +1,35 @@
+/**
+ *  tafi_clock.h -- The Amazing Fan Idea driver
+ *  Frame clock pacing the transmit thread.
+ *
+ *      (C) 2017 Harindu Perera
+ *
+ *  This file is subject to the terms and conditions of the GNU General Public
+ *  License. See the file COPYING in the main directory of this archive for
+ *  more details.
+ */
+
+#ifndef TAFI_CLOCK_HDR
+#define TAFI_CLOCK_HDR
+
+#include <linux/ktime.h>
+#include <linux/types.h>
+
+// Time between frame starts, one revolution of the fan.
+#define TAFI_FRAME_PERIOD_US 92600
+
+int tafi_clock_init(void);
+
+void tafi_clock_exit(void);
+
+ktime_t tafi_clock_wait(void);
+
+void tafi_clock_set_next(u64 tick);
+
+u64 tafi_clock_seq(void);
+
+ktime_t tafi_clock_last_tick(void);
+
+bool tafi_clock_synced(void);
+
+#endif
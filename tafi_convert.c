@@ -0,0 +1,260 @@
+/**
+ *  tafi_convert.c -- The Amazing Fan Idea driver
+ *  Cartesian to polar conversion into the native wire layout.
+ *
+ *  Every LED samples one source pixel, looked up in tafi_lut_pixel, or in
+ *  tafi_lut_pixel_half for the odd revolutions of angular interleaving, and
+ *  corrects its brightness for the LED's radius. The wire carries the
+ *  channels in blue, red, green order, 7 bits each, with the top bit set.
+ * 
+ *      (C) 2017 Harindu Perera
+ *  
+ *  This file is subject to the terms and conditions of the GNU General Public
+ *  License. See the file COPYING in the main directory of this archive for
+ *  more details.
+ */
+
+#include <linux/bitmap.h>
+#include <linux/kernel.h>
+#include <linux/string.h>
+
+#include "tafi_convert.h"
+#include "tafi_convert_simd.h"
+#include "tafi_lut.h"
+
+// Packed RGB, as exposed by the framebuffer device.
+const struct tafi_convert_format tafi_convert_rgb888 = {
+    .cpp = 3,
+    .red = 0,
+    .green = 1,
+    .blue = 2,
+};
+
+// The wire tables have the framing already applied, one table per LED so
+// a sector's lookups stay within a few cache lines.
+static inline unsigned char tafi_convert_channel(unsigned char value, unsigned int led) {
+    return tafi_lut_wire[led][value];
+}
+
+void tafi_convert_init(void) {
+    tafi_convert_simd_init();
+}
+
+// A pixel table of tafi_lut.h.
+typedef const u8 (*tafi_convert_lut_t)[TAFI_SECTOR_LED_COUNT][2];
+
+static unsigned int tafi_convert_rect_range(const struct tafi_convert_src *src, tafi_convert_lut_t lut,
+    const struct tafi_convert_clip *clip, unsigned int first, unsigned int count, unsigned char *dst,
+    unsigned long *dirty_sectors) {
+
+    const struct tafi_convert_format *format = src->format;
+    const unsigned char *pixel;
+    unsigned char *out;
+    unsigned int row;
+    unsigned int col;
+    unsigned int s;
+    unsigned int l;
+    unsigned int touched = 0;
+    bool sector_touched;
+
+    for (s = first; s < first + count; s++) {
+        sector_touched = false;
+        for (l = 0; l < TAFI_SECTOR_LED_COUNT; l++) {
+            // the table holds (line, column) of the sampled pixel
+            row = lut[s][l][0];
+            col = lut[s][l][1];
+            if (clip && (col < clip->x1 || col >= clip->x2 || row < clip->y1 || row >= clip->y2))
+                continue;
+
+            pixel = src->vaddr + row * src->pitch + col * format->cpp;
+            out = dst + s * TAFI_SECTOR_BUF_LEN + l * TAFI_LED_COLOR_FIELD_COUNT;
+            out[0] = tafi_convert_channel(pixel[format->blue], l);
+            out[1] = tafi_convert_channel(pixel[format->red], l);
+            out[2] = tafi_convert_channel(pixel[format->green], l);
+            sector_touched = true;
+        }
+        if (sector_touched) {
+            if (dirty_sectors)
+                __set_bit(s, dirty_sectors);
+            touched++;
+        }
+    }
+
+    return touched;
+}
+
+unsigned int tafi_convert_rect(const struct tafi_convert_src *src, const struct tafi_convert_clip *clip,
+    unsigned char *dst, unsigned long *dirty_sectors) {
+
+    return tafi_convert_rect_range(src, tafi_lut_pixel, clip, 0, TAFI_SECTOR_COUNT, dst, dirty_sectors);
+}
+
+void tafi_convert_rect_sectors(const struct tafi_convert_src *src, unsigned int first, unsigned int count,
+    unsigned char *dst) {
+
+    tafi_convert_rect_range(src, tafi_lut_pixel, NULL, first, count, dst, NULL);
+}
+
+void tafi_convert_rect_half(const struct tafi_convert_src *src, unsigned char *dst) {
+    tafi_convert_rect_range(src, tafi_lut_pixel_half, NULL, 0, TAFI_SECTOR_COUNT, dst, NULL);
+}
+
+void tafi_convert_polar_sectors(const unsigned char *src, unsigned int pitch,
+    const struct tafi_convert_format *format, unsigned int first, unsigned int count, unsigned char *dst) {
+
+    const unsigned char *pixel;
+    unsigned char *out = dst + first * TAFI_SECTOR_BUF_LEN;
+    unsigned int done;
+    unsigned int s;
+    unsigned int l;
+
+    // swizzle as many pixels as possible in vector registers first
+    done = tafi_convert_simd_swizzle(src + first * pitch, pitch, format, count, TAFI_SECTOR_LED_COUNT, out);
+
+    for (s = first; s < first + count; s++) {
+        for (l = 0; l < done; l++) {
+            out[0] = tafi_convert_channel(out[0], l);
+            out[1] = tafi_convert_channel(out[1], l);
+            out[2] = tafi_convert_channel(out[2], l);
+            out += TAFI_LED_COLOR_FIELD_COUNT;
+        }
+        pixel = src + s * pitch + done * format->cpp;
+        for (l = done; l < TAFI_SECTOR_LED_COUNT; l++) {
+            out[0] = tafi_convert_channel(pixel[format->blue], l);
+            out[1] = tafi_convert_channel(pixel[format->red], l);
+            out[2] = tafi_convert_channel(pixel[format->green], l);
+            pixel += format->cpp;
+            out += TAFI_LED_COLOR_FIELD_COUNT;
+        }
+    }
+}
+
+void tafi_convert_polar(const unsigned char *src, unsigned int pitch, const struct tafi_convert_format *format,
+    unsigned char *dst) {
+
+    tafi_convert_polar_sectors(src, pitch, format, 0, TAFI_SECTOR_COUNT, dst);
+}
+
+void tafi_convert_sampled(unsigned int width, unsigned int height, tafi_convert_sample_t sample, const void *priv,
+    unsigned char *dst) {
+
+    unsigned char rgb[3];
+    unsigned char *out = dst;
+    unsigned int x;
+    unsigned int y;
+    unsigned int s;
+    unsigned int l;
+
+    for (s = 0; s < TAFI_SECTOR_COUNT; s++) {
+        for (l = 0; l < TAFI_SECTOR_LED_COUNT; l++) {
+            // centre of the table's pixel, scaled to the source size
+            y = (2 * tafi_lut_pixel[s][l][0] + 1) * height / (2 * TAFI_FB_YRES);
+            x = (2 * tafi_lut_pixel[s][l][1] + 1) * width / (2 * TAFI_FB_XRES);
+            sample(priv, x, y, rgb);
+            out[0] = tafi_convert_channel(rgb[2], l);
+            out[1] = tafi_convert_channel(rgb[0], l);
+            out[2] = tafi_convert_channel(rgb[1], l);
+            out += TAFI_LED_COLOR_FIELD_COUNT;
+        }
+    }
+}
+
+static void tafi_convert_rect_indexed_lut(const unsigned char *src, unsigned int pitch, tafi_convert_lut_t lut,
+    unsigned char *dst) {
+
+    unsigned int s;
+    unsigned int l;
+
+    for (s = 0; s < TAFI_SECTOR_COUNT; s++)
+        for (l = 0; l < TAFI_SECTOR_LED_COUNT; l++)
+            *dst++ = src[lut[s][l][0] * pitch + lut[s][l][1]];
+}
+
+void tafi_convert_rect_indexed(const unsigned char *src, unsigned int pitch, unsigned char *dst) {
+    tafi_convert_rect_indexed_lut(src, pitch, tafi_lut_pixel, dst);
+}
+
+void tafi_convert_rect_indexed_half(const unsigned char *src, unsigned int pitch, unsigned char *dst) {
+    tafi_convert_rect_indexed_lut(src, pitch, tafi_lut_pixel_half, dst);
+}
+
+void tafi_convert_polar_indexed(const unsigned char *src, unsigned int pitch, unsigned char *dst) {
+    unsigned int s;
+
+    for (s = 0; s < TAFI_SECTOR_COUNT; s++)
+        memcpy(dst + s * TAFI_SECTOR_LED_COUNT, src + s * pitch, TAFI_SECTOR_LED_COUNT);
+}
+
+void tafi_convert_indexed(const unsigned char *src, const u8 (*palette)[3], unsigned char *dst) {
+    const u8 *rgb;
+    unsigned int s;
+    unsigned int l;
+
+    for (s = 0; s < TAFI_SECTOR_COUNT; s++) {
+        for (l = 0; l < TAFI_SECTOR_LED_COUNT; l++) {
+            rgb = palette[*src++];
+            dst[0] = tafi_convert_channel(rgb[2], l);
+            dst[1] = tafi_convert_channel(rgb[0], l);
+            dst[2] = tafi_convert_channel(rgb[1], l);
+            dst += TAFI_LED_COLOR_FIELD_COUNT;
+        }
+    }
+}
+
+bool tafi_convert_deep(const u16 *src, unsigned char *dst, u8 *frac) {
+    const u16 *lut;
+    unsigned int level;
+    unsigned int s;
+    unsigned int l;
+    unsigned int c;
+    u8 any = 0;
+
+    for (s = 0; s < TAFI_SECTOR_COUNT; s++) {
+        for (l = 0; l < TAFI_SECTOR_LED_COUNT; l++) {
+            for (c = 0; c < TAFI_LED_COLOR_FIELD_COUNT; c++) {
+                // interpolate between the table's points, 256 values apart
+                lut = &tafi_lut_deep[l][*src >> 8];
+                level = lut[0] + (((lut[1] - lut[0]) * (*src & 0xff)) >> 8);
+                src++;
+                // the top step has nothing to round up to
+                if (level >= 0x7f00)
+                    level = 0x7f00;
+                *dst++ = (level >> 8) | 0x80;
+                *frac = level & 0xff;
+                any |= *frac++;
+            }
+        }
+    }
+
+    return any != 0;
+}
+
+void tafi_convert_dither(const unsigned char *base, const u8 *frac, u8 *error, unsigned char *dst) {
+    unsigned int sum;
+    unsigned int i;
+
+    // first order in time: carry a step whenever the error wraps
+    for (i = 0; i < TAFI_DATA_BUF_LEN; i++) {
+        sum = error[i] + frac[i];
+        error[i] = sum;
+        dst[i] = base[i] + (sum >> 8);
+    }
+}
+
+unsigned int tafi_convert_sectors_to_ranges(const unsigned long *dirty_sectors, struct tafi_range *ranges) {
+    unsigned int start;
+    unsigned int end = 0;
+    unsigned int count = 0;
+
+    for (;;) {
+        start = find_next_bit(dirty_sectors, TAFI_SECTOR_COUNT, end);
+        if (start >= TAFI_SECTOR_COUNT)
+            break;
+        end = find_next_zero_bit(dirty_sectors, TAFI_SECTOR_COUNT, start);
+        ranges[count].offset = start * TAFI_SECTOR_BUF_LEN;
+        ranges[count].len = (end - start) * TAFI_SECTOR_BUF_LEN;
+        count++;
+    }
+
+    return count;
+}
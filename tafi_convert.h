@@ -0,0 +1,138 @@
+/**
+ *  tafi_convert.h -- The Amazing Fan Idea driver
+ *  Cartesian to polar conversion into the native wire layout.
+ * 
+ *      (C) 2017 Harindu Perera
+ *  
+ *  This file is subject to the terms and conditions of the GNU General Public
+ *  License. See the file COPYING in the main directory of this archive for
+ *  more details.
+ */
+
+#ifndef TAFI_CONVERT
+#define TAFI_CONVERT
+
+#include <linux/types.h>
+
+#include "tafi_ioctl.h"
+#include "tafi_fb.h"
+
+// Byte layout of a source pixel.
+struct tafi_convert_format {
+    unsigned int cpp;       // bytes per pixel
+    unsigned int red;       // byte offsets of the channels within a pixel
+    unsigned int green;
+    unsigned int blue;
+};
+
+// A source image: TAFI_FB_XRES x TAFI_FB_YRES pixels, pitch bytes per line.
+struct tafi_convert_src {
+    const unsigned char *vaddr;
+    unsigned int pitch;
+    const struct tafi_convert_format *format;
+};
+
+// Damaged area of the source image, end coordinates exclusive.
+struct tafi_convert_clip {
+    unsigned int x1, y1;
+    unsigned int x2, y2;
+};
+
+// Reads the RGB value of pixel (x, y) of an arbitrary source image.
+typedef void (*tafi_convert_sample_t)(const void *priv, unsigned int x, unsigned int y, unsigned char *rgb);
+
+extern const struct tafi_convert_format tafi_convert_rgb888;
+
+/**
+ * Pick the conversion kernels. Must be called before any conversion.
+ */
+void tafi_convert_init(void);
+
+/**
+ * Convert every LED that samples a pixel inside clip into dst, a native
+ * frame of TAFI_DATA_BUF_LEN bytes. A NULL clip converts the whole image.
+ * Sectors that were touched are set in dirty_sectors, if given.
+ * Returns the number of touched sectors.
+ */
+unsigned int tafi_convert_rect(const struct tafi_convert_src *src, const struct tafi_convert_clip *clip,
+    unsigned char *dst, unsigned long *dirty_sectors);
+
+/**
+ * Convert only sectors first to first + count - 1 of the image into the
+ * same sectors of dst.
+ */
+void tafi_convert_rect_sectors(const struct tafi_convert_src *src, unsigned int first, unsigned int count,
+    unsigned char *dst);
+
+/**
+ * Convert the whole image sampled half a sector later than
+ * tafi_convert_rect() does, for the odd revolutions of angular
+ * interleaving.
+ */
+void tafi_convert_rect_half(const struct tafi_convert_src *src, unsigned char *dst);
+
+/**
+ * Convert an image already in native polar layout, one line of
+ * TAFI_SECTOR_LED_COUNT pixels per sector, applying only the brightness
+ * correction and the wire framing.
+ */
+void tafi_convert_polar(const unsigned char *src, unsigned int pitch, const struct tafi_convert_format *format,
+    unsigned char *dst);
+
+/**
+ * Polar counterpart of tafi_convert_rect_sectors().
+ */
+void tafi_convert_polar_sectors(const unsigned char *src, unsigned int pitch,
+    const struct tafi_convert_format *format, unsigned int first, unsigned int count, unsigned char *dst);
+
+/**
+ * Convert a width x height image of any layout into dst by sampling only
+ * the pixels that are actually displayed, nearest neighbour scaled.
+ */
+void tafi_convert_sampled(unsigned int width, unsigned int height, tafi_convert_sample_t sample, const void *priv,
+    unsigned char *dst);
+
+/**
+ * Sample an 8 bit indexed image of TAFI_FB_XRES x TAFI_FB_YRES pixels into
+ * an indexed frame, one palette index per LED.
+ */
+void tafi_convert_rect_indexed(const unsigned char *src, unsigned int pitch, unsigned char *dst);
+
+/**
+ * Indexed counterpart of tafi_convert_rect_half().
+ */
+void tafi_convert_rect_indexed_half(const unsigned char *src, unsigned int pitch, unsigned char *dst);
+
+/**
+ * Copy an 8 bit indexed image in native polar layout into an indexed frame.
+ */
+void tafi_convert_polar_indexed(const unsigned char *src, unsigned int pitch, unsigned char *dst);
+
+/**
+ * Expand an indexed frame into dst, a native frame, with a palette of
+ * TAFI_PALETTE_SIZE RGB entries.
+ */
+void tafi_convert_indexed(const unsigned char *src, const u8 (*palette)[3], unsigned char *dst);
+
+/**
+ * Convert a native frame of 16 bit channel values, in wire channel order
+ * and before brightness correction, into dst. The fraction of a wire step
+ * each byte of dst falls short by goes into frac, in 1/256 steps.
+ * Returns false if every fraction is 0, so the frame needs no dithering.
+ */
+bool tafi_convert_deep(const u16 *src, unsigned char *dst, u8 *frac);
+
+/**
+ * Produce the next transmission of a frame made by tafi_convert_deep(),
+ * diffusing each channel's fraction over successive transmissions through
+ * its error accumulator.
+ */
+void tafi_convert_dither(const unsigned char *base, const u8 *frac, u8 *error, unsigned char *dst);
+
+/**
+ * Turn a sector bitmap into byte ranges of the native frame for
+ * tafi_set_color_ranges(). Returns the number of ranges written.
+ */
+unsigned int tafi_convert_sectors_to_ranges(const unsigned long *dirty_sectors, struct tafi_range *ranges);
+
+#endif
@@ -0,0 +1,45 @@
+/**
+ *  tafi_convert_neon.c -- The Amazing Fan Idea driver
+ *  NEON conversion kernels. Called between kernel_neon_begin() and
+ *  kernel_neon_end() only, see tafi_convert_simd.c.
+ *
+ *      (C) 2017 Harindu Perera
+ *
+ *  This file is subject to the terms and conditions of the GNU General Public
+ *  License. See the file COPYING in the main directory of this archive for
+ *  more details.
+ */
+
+#include <arm_neon.h>
+
+#include "tafi_convert_simd.h"
+
+static inline uint8x16_t tafi_convert_tbl(uint8x16_t in, uint8x16_t mask) {
+#ifdef __aarch64__
+    return vqtbl1q_u8(in, mask);
+#else
+    uint8x8x2_t table = { { vget_low_u8(in), vget_high_u8(in) } };
+
+    return vcombine_u8(vtbl2_u8(table, vget_low_u8(mask)), vtbl2_u8(table, vget_high_u8(mask)));
+#endif
+}
+
+void tafi_convert_shuffle_neon(const struct tafi_convert_shuffle *shuffle, const unsigned char *src,
+    unsigned char *dst) {
+
+    uint8x16_t mask = vld1q_u8(shuffle->mask);
+    const unsigned char *in;
+    unsigned char *out;
+    unsigned int row;
+    unsigned int chunk;
+
+    for (row = 0; row < shuffle->rows; row++) {
+        in = src + row * shuffle->src_pitch;
+        out = dst + row * shuffle->dst_pitch;
+        for (chunk = 0; chunk < shuffle->chunks; chunk++) {
+            vst1q_u8(out, tafi_convert_tbl(vld1q_u8(in), mask));
+            in += shuffle->src_step;
+            out += shuffle->dst_step;
+        }
+    }
+}
@@ -0,0 +1,130 @@
+/**
+ *  tafi_convert_simd.c -- The Amazing Fan Idea driver
+ *  Runtime selection of the vector conversion kernels.
+ *
+ *  Only the channel swizzle is vectorised. The brightness correction is a
+ *  separate 256 entry table per LED, and the LEDs change every three bytes,
+ *  so it stays a scalar lookup.
+ *
+ *      (C) 2017 Harindu Perera
+ *
+ *  This file is subject to the terms and conditions of the GNU General Public
+ *  License. See the file COPYING in the main directory of this archive for
+ *  more details.
+ */
+
+#include <linux/kernel.h>
+#include <linux/module.h>
+#include <linux/string.h>
+#include <asm/simd.h>
+
+#if defined(CONFIG_KERNEL_MODE_NEON)
+#include <asm/neon.h>
+#define TAFI_CONVERT_SIMD_NAME "neon"
+#elif defined(CONFIG_X86)
+#include <asm/cpufeature.h>
+#include <asm/fpu/api.h>
+#define TAFI_CONVERT_SIMD_NAME "ssse3"
+#endif
+
+#include "tafi_common.h"
+#include "tafi_convert.h"
+#include "tafi_convert_simd.h"
+
+static bool convert_simd = true;
+module_param(convert_simd, bool, 0644);
+MODULE_PARM_DESC(convert_simd, "Use vector conversion kernels where the CPU supports them");
+
+static bool tafi_convert_simd_available;
+
+#ifdef CONFIG_X86
+/*
+ * The kernel is built without SSE, so nothing but these statements touches
+ * the vector registers between kernel_fpu_begin() and kernel_fpu_end() and
+ * the mask can stay in xmm7, the same way lib/raid6 keeps its constants.
+ */
+static void tafi_convert_shuffle_ssse3(const struct tafi_convert_shuffle *shuffle, const unsigned char *src,
+    unsigned char *dst) {
+
+    const unsigned char *in;
+    unsigned char *out;
+    unsigned int row;
+    unsigned int chunk;
+
+    asm volatile("movdqu %0, %%xmm7" : : "m" (shuffle->mask));
+
+    for (row = 0; row < shuffle->rows; row++) {
+        in = src + row * shuffle->src_pitch;
+        out = dst + row * shuffle->dst_pitch;
+        for (chunk = 0; chunk < shuffle->chunks; chunk++) {
+            asm volatile("movdqu %1, %%xmm0\n\t"
+                         "pshufb %%xmm7, %%xmm0\n\t"
+                         "movdqu %%xmm0, %0"
+                         : "=m" (*(unsigned char (*)[16]) out)
+                         : "m" (*(const unsigned char (*)[16]) in));
+            in += shuffle->src_step;
+            out += shuffle->dst_step;
+        }
+    }
+}
+#endif
+
+void tafi_convert_simd_init(void) {
+#if defined(CONFIG_KERNEL_MODE_NEON)
+    tafi_convert_simd_available = cpu_has_neon();
+#elif defined(CONFIG_X86)
+    tafi_convert_simd_available = boot_cpu_has(X86_FEATURE_SSSE3);
+#endif
+
+#ifdef TAFI_CONVERT_SIMD_NAME
+    printk(KERN_INFO TAFI_LOG_PREFIX"conversion kernels: %s.",
+        tafi_convert_simd_available ? TAFI_CONVERT_SIMD_NAME : "scalar");
+#endif
+}
+
+unsigned int tafi_convert_simd_swizzle(const unsigned char *src, unsigned int pitch,
+    const struct tafi_convert_format *format, unsigned int rows, unsigned int pixels, unsigned char *dst) {
+
+    struct tafi_convert_shuffle shuffle;
+    unsigned int step;
+    unsigned int p;
+
+    if (!tafi_convert_simd_available || !READ_ONCE(convert_simd) || !may_use_simd())
+        return 0;
+
+    // packed 24 and 32 bit pixels, 5 or 4 of them per chunk
+    if (format->cpp != 3 && format->cpp != 4)
+        return 0;
+    step = 16 / format->cpp;
+
+    // the last chunk still has to read and write 16 bytes within the row
+    if (pixels * TAFI_LED_COLOR_FIELD_COUNT < 16)
+        return 0;
+
+    memset(shuffle.mask, 0x80, sizeof(shuffle.mask));
+    for (p = 0; p < step; p++) {
+        shuffle.mask[p * 3 + 0] = p * format->cpp + format->blue;
+        shuffle.mask[p * 3 + 1] = p * format->cpp + format->red;
+        shuffle.mask[p * 3 + 2] = p * format->cpp + format->green;
+    }
+    shuffle.rows = rows;
+    shuffle.chunks = (pixels * TAFI_LED_COLOR_FIELD_COUNT - 16) / (step * TAFI_LED_COLOR_FIELD_COUNT) + 1;
+    shuffle.src_pitch = pitch;
+    shuffle.src_step = step * format->cpp;
+    shuffle.dst_pitch = pixels * TAFI_LED_COLOR_FIELD_COUNT;
+    shuffle.dst_step = step * TAFI_LED_COLOR_FIELD_COUNT;
+
+#if defined(CONFIG_KERNEL_MODE_NEON)
+    kernel_neon_begin();
+    tafi_convert_shuffle_neon(&shuffle, src, dst);
+    kernel_neon_end();
+#elif defined(CONFIG_X86)
+    kernel_fpu_begin();
+    tafi_convert_shuffle_ssse3(&shuffle, src, dst);
+    kernel_fpu_end();
+#else
+    return 0;
+#endif
+
+    return shuffle.chunks * step;
+}
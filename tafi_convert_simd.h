@@ -0,0 +1,51 @@
+/**
+ *  tafi_convert_simd.h -- The Amazing Fan Idea driver
+ *  Vector kernels for the conversion into the native wire layout.
+ *
+ *  The NEON kernels are built freestanding with the FPU enabled, so this
+ *  header must not pull in any kernel headers.
+ *
+ *      (C) 2017 Harindu Perera
+ *
+ *  This file is subject to the terms and conditions of the GNU General Public
+ *  License. See the file COPYING in the main directory of this archive for
+ *  more details.
+ */
+
+#ifndef TAFI_CONVERT_SIMD
+#define TAFI_CONVERT_SIMD
+
+struct tafi_convert_format;
+
+// A byte shuffle applied to every row of an image in 16 byte chunks. Each
+// chunk reads and writes 16 bytes but only advances by the step sizes, the
+// next chunk overwrites the spare bytes.
+struct tafi_convert_shuffle {
+    unsigned char mask[16];     // source byte of each output byte, 0x80 for 0
+    unsigned int rows;
+    unsigned int chunks;        // per row
+    unsigned int src_pitch;
+    unsigned int src_step;
+    unsigned int dst_pitch;
+    unsigned int dst_step;
+};
+
+void tafi_convert_shuffle_neon(const struct tafi_convert_shuffle *shuffle, const unsigned char *src,
+    unsigned char *dst);
+
+/**
+ * Pick the vector kernels supported by this CPU.
+ */
+void tafi_convert_simd_init(void);
+
+/**
+ * Swizzle the leading pixels of each row of an image into wire channel
+ * order, without brightness correction, with the best available kernel.
+ * Rows are pixels wide; dst rows are packed.
+ * Returns the number of pixels per row done, the rest is left to the
+ * caller.
+ */
+unsigned int tafi_convert_simd_swizzle(const unsigned char *src, unsigned int pitch,
+    const struct tafi_convert_format *format, unsigned int rows, unsigned int pixels, unsigned char *dst);
+
+#endif
@@ -13,6 +13,7 @@
 #include <linux/init.h>
 #include <linux/module.h>
 #include <linux/mutex.h>
+#include <linux/wait.h>
 
 // GPIO header
 #include <linux/gpio.h>
@@ -22,21 +23,63 @@
 
 // kThread/timer headers
 #include <linux/kthread.h>
-#include <linux/delay.h>
+#include <linux/hrtimer.h>
+#include <linux/cpumask.h>
+#include <linux/sched.h>
+#include <linux/sched/types.h>
 
 // For kmalloc
 #include <linux/slab.h>
+#include <linux/kref.h>
+#include <linux/spinlock.h>
+#include <linux/dma-mapping.h>
 
 #include "tafi_common.h"
 #include "tafi_ioctl.h"
 #include "tafi_bus.h"
 #include "tafi_chardev.h"
 #include "tafi_fb.h"
+#include "tafi_drm.h"
+#include "tafi_v4l2.h"
+#include "tafi_stats.h"
+#include "tafi_debugfs.h"
+#include "tafi_capture.h"
+#include "tafi_dmabuf.h"
+#include "tafi_convert.h"
+#include "tafi_transform.h"
+#include "tafi_palette.h"
+#include "tafi_clock.h"
+#include "tafi_present.h"
+#include "tafi_wire.h"
+#include "tafi_gen.h"
+#include "tafi_fade.h"
 
 // Thread settings
 #define TAFI_KTHREAD_NAME "tafi_main"
-#define TAFI_KTHREAD_SCHEDULER_PRIORITY MAX_RT_PRIO - 50
+// Highest SCHED_FIFO priority allowed, one below the default of threaded
+// IRQ handlers, MAX_RT_PRIO / 2, so the SPI controller's interrupt threads
+// can always preempt us.
+#define TAFI_KTHREAD_SCHEDULER_PRIORITY (MAX_RT_PRIO / 2 - 1)
+// Default SCHED_FIFO priority.
 #define TAFI_KTHREAD_PRIORITY 45
+// Delay of the odd revolutions of an interleaved frame, half a sector.
+#define TAFI_HALF_SECTOR_US (TAFI_FRAME_PERIOD_US / TAFI_SECTOR_COUNT / 2)
+
+static int thread_priority = TAFI_KTHREAD_PRIORITY;
+module_param(thread_priority, int, 0444);
+MODULE_PARM_DESC(thread_priority, "SCHED_FIFO priority of the transmit thread (0 = SCHED_OTHER)");
+
+static unsigned int idle_keepalive_ms;
+module_param(idle_keepalive_ms, uint, 0444);
+MODULE_PARM_DESC(idle_keepalive_ms, "Only retransmit unchanged frames this often, sleeping in between (0 = every period)");
+
+static int thread_cpu = -1;
+module_param(thread_cpu, int, 0444);
+MODULE_PARM_DESC(thread_cpu, "CPU the transmit thread is bound to (-1 = any)");
+
+static unsigned int pipeline_sectors = 10;
+module_param(pipeline_sectors, uint, 0644);
+MODULE_PARM_DESC(pipeline_sectors, "Sectors converted and sent as one piece by pipelined displays");
 
 static unsigned char BUF[5][TAFI_SECTOR_LED_COUNT][TAFI_LED_COLOR_FIELD_COUNT] = {
     {
@@ -110,47 +153,499 @@ static unsigned char BUF[5][TAFI_SECTOR_LED_COUNT][TAFI_LED_COLOR_FIELD_COUNT] =
 // Thread and timer
 
 ////////// DO NOT MANIPULATE THE VARIABLES BELOW DIRECTLY ////////////////
-// Global array for color data to be sent to LEDs.
-static unsigned char tafi_color_data_buf[TAFI_SECTOR_COUNT][TAFI_SECTOR_LED_COUNT][TAFI_LED_COLOR_FIELD_COUNT];
+// The frame currently on display. Published frames are never modified, so
+// they can be read without any lock once a reference is held.
+static struct tafi_frame *tafi_live_frame;
 
 // Dirty flag to see if we really need to write a new frame.
 static bool tafi_color_data_dirty;
 
-// Mutex to control access to color data buffer and the dirty flag.
+// Number of times the thread has picked up the buffer for transmission.
+static u64 tafi_color_data_pickups;
+
+// Frame to go live at a tick of the frame clock, see tafi_publish_frame_at().
+static struct tafi_frame *tafi_scheduled_frame;
+static u64 tafi_scheduled_tick;
+
+// Frames queued by tafi_queue_frame(), oldest at head. Each goes live in
+// turn as the thread picks up the next frame.
+static struct tafi_frame *tafi_fifo[TAFI_PRESENT_FIFO_MAX];
+static unsigned int tafi_fifo_head;
+static unsigned int tafi_fifo_count;
+// The live frame came from the queue, so the queue waits for it to fade in.
+static bool tafi_live_frame_queued;
+
+// Indexed frames are expanded here for transmission, only used by the thread.
+static unsigned char *tafi_thread_buf;
+
+// Dithering error of every wire byte, carried from one transmission to the
+// next, only used by the thread.
+static u8 tafi_dither_error[TAFI_DATA_BUF_LEN];
+
+// Display to be converted by the thread, instead of the live frame.
+static struct tafi_pipeline_source *tafi_pipeline_pending;
+
+// The only lock shared with the thread, protecting the live frame pointer,
+// the frame queue, the dirty flag and the pickup count. Held just for a
+// pointer swap.
+static DEFINE_SPINLOCK(tafi_live_frame_lock);
+
+// Serializes read-modify-publish updates of partial frames with every
+// other publication, so none is lost between the read and the publish.
 static struct mutex tafi_color_data_mutex;
 
+// Held by the thread while it may use a pipeline source.
+static DEFINE_MUTEX(tafi_pipeline_mutex);
+
+// Woken up every time the thread picks up the buffer.
+static DECLARE_WAIT_QUEUE_HEAD(tafi_color_data_pickup_wait);
+
+// Woken up every time the buffer becomes dirty, for the idle thread.
+static DECLARE_WAIT_QUEUE_HEAD(tafi_color_data_dirty_wait);
+
 ////////// DO NOT MANIPULATE THE VARIABLES ABOVE DIRECTLY ////////////////
 
+static struct kmem_cache *tafi_frame_cache;
+
+// Frames not yet released. Released frames are unmapped through the SPI
+// device, so it stays until this drops to 0.
+static atomic_t tafi_frame_count = ATOMIC_INIT(0);
+static DECLARE_WAIT_QUEUE_HEAD(tafi_frame_release_wait);
+
 // The global task.
 struct task_struct *tafi_task;
 
+// Thread timing statistics.
+static TAFI_HIST(tafi_wakeup_latency, "wakeup_latency");
+static TAFI_HIST(tafi_period_jitter, "period_jitter");
+static TAFI_COUNTER(tafi_thread_wakeups, "thread_wakeups");
+static TAFI_COUNTER(tafi_frames_transmitted, "frames_transmitted");
+static TAFI_COUNTER(tafi_keepalive_frames, "keepalive_frames");
+static TAFI_HIST(tafi_frame_setup, "frame_setup");
+static TAFI_HIST(tafi_frame_transfer, "frame_transfer");
+static TAFI_HIST(tafi_pipeline_first_piece, "pipeline_first_piece");
+
+/**
+ * Allocate an uninitialized frame, holding one reference.
+ */
+struct tafi_frame *tafi_frame_alloc(void) {
+    struct tafi_frame *frame;
+
+    frame = kmem_cache_alloc(tafi_frame_cache, GFP_KERNEL);
+    if (frame) {
+        atomic_inc(&tafi_frame_count);
+        kref_init(&frame->ref);
+        frame->dma = DMA_MAPPING_ERROR;
+        frame->indexed = false;
+        frame->dither = NULL;
+        frame->phase = NULL;
+        frame->fade = 0;
+    }
+    return frame;
+}
+
+static void tafi_frame_release(struct kref *ref) {
+    struct tafi_frame *frame = container_of(ref, struct tafi_frame, ref);
+
+    tafi_spi_unmap(frame->dma, TAFI_DATA_BUF_LEN);
+    kfree(frame->dither);
+    tafi_frame_put(frame->phase);
+    kmem_cache_free(tafi_frame_cache, frame);
+    if (atomic_dec_and_test(&tafi_frame_count))
+        wake_up(&tafi_frame_release_wait);
+}
+
+void tafi_frame_put(struct tafi_frame *frame) {
+    if (frame)
+        kref_put(&frame->ref, tafi_frame_release);
+}
+
+/**
+ * Get a reference to the frame currently on display.
+ */
+struct tafi_frame *tafi_frame_get_live(void) {
+    struct tafi_frame *frame;
+
+    spin_lock(&tafi_live_frame_lock);
+    frame = tafi_live_frame;
+    kref_get(&frame->ref);
+    spin_unlock(&tafi_live_frame_lock);
+    return frame;
+}
+
+/**
+ * Get a reference to the frame on display in native layout. An indexed
+ * frame is expanded with the current palette into a new frame.
+ * Returns NULL if there is no memory for that.
+ */
+struct tafi_frame *tafi_frame_get_live_native(void) {
+    struct tafi_frame *live;
+    struct tafi_frame *frame;
+
+    live = tafi_frame_get_live();
+    if (!live->indexed)
+        return live;
+
+    frame = tafi_frame_alloc();
+    if (frame)
+        tafi_palette_expand(live->data, frame->data);
+    tafi_frame_put(live);
+    return frame;
+}
+
+/**
+ * Map a frame for DMA, off the transmit path, once it is final.
+ */
+static void tafi_frame_map(struct tafi_frame *frame) {
+    if (!frame->indexed && !frame->dither)
+        frame->dma = tafi_spi_map(frame->data, TAFI_DATA_BUF_LEN);
+    if (frame->phase)
+        tafi_frame_map(frame->phase);
+}
+
+/**
+ * Undo tafi_frame_map(), for a frame that was not published after all.
+ */
+static void tafi_frame_unmap(struct tafi_frame *frame) {
+    tafi_spi_unmap(frame->dma, TAFI_DATA_BUF_LEN);
+    frame->dma = DMA_MAPPING_ERROR;
+    if (frame->phase)
+        tafi_frame_unmap(frame->phase);
+}
+
+static u64 tafi_make_live(struct tafi_frame *frame) {
+    struct tafi_frame *old;
+    u64 ticket;
+
+    spin_lock(&tafi_live_frame_lock);
+    old = tafi_live_frame;
+    tafi_live_frame = frame;
+    tafi_live_frame_queued = false;
+    tafi_pipeline_pending = NULL;
+    tafi_color_data_dirty = true;
+    ticket = tafi_color_data_pickups;
+    spin_unlock(&tafi_live_frame_lock);
+
+    tafi_frame_put(old);
+    wake_up(&tafi_color_data_dirty_wait);
+    return ticket;
+}
+
+/**
+ * Make a frame the one on display. Takes over the caller's reference, the
+ * frame must not be modified afterwards.
+ * Returns a ticket for tafi_wait_for_pickup().
+ */
+u64 tafi_publish_frame(struct tafi_frame *frame) {
+    u64 ticket;
+
+    tafi_frame_map(frame);
+    mutex_lock(&tafi_color_data_mutex);
+    ticket = tafi_make_live(frame);
+    mutex_unlock(&tafi_color_data_mutex);
+    return ticket;
+}
+
+/**
+ * Publish a frame when the frame clock reaches tick, so it is first
+ * transmitted on that tick, or right away if the tick has passed. A frame
+ * still waiting for its tick is replaced. Takes over the reference.
+ */
+void tafi_publish_frame_at(struct tafi_frame *frame, u64 tick) {
+    struct tafi_frame *old;
+
+    if (tick <= tafi_clock_seq()) {
+        tafi_publish_frame(frame);
+        return;
+    }
+
+    tafi_frame_map(frame);
+
+    spin_lock(&tafi_live_frame_lock);
+    old = tafi_scheduled_frame;
+    tafi_scheduled_frame = frame;
+    tafi_scheduled_tick = tick;
+    spin_unlock(&tafi_live_frame_lock);
+
+    tafi_frame_put(old);
+}
+
+/**
+ * Queue a frame to go live once every frame queued before it has been
+ * picked up, so each is transmitted at least once, in order. Waits while
+ * depth frames are queued, or returns -EAGAIN if nonblock is set. Takes
+ * over the reference unless it fails; a failed call leaves the frame
+ * unmapped, so the caller may still modify it and retry.
+ * The ticket for tafi_wait_for_pickup() goes to ticket.
+ */
+int tafi_queue_frame(struct tafi_frame *frame, unsigned int depth, bool nonblock, u64 *ticket) {
+    int ret;
+
+    depth = clamp_t(unsigned int, depth, 1, TAFI_PRESENT_FIFO_MAX);
+
+    for (;;) {
+        if (nonblock && READ_ONCE(tafi_fifo_count) >= depth)
+            return -EAGAIN;
+        ret = wait_event_interruptible(tafi_color_data_pickup_wait, READ_ONCE(tafi_fifo_count) < depth);
+        if (ret)
+            return ret;
+
+        // mapped only once there is room, mapping may sleep
+        tafi_frame_map(frame);
+        spin_lock(&tafi_live_frame_lock);
+        if (tafi_fifo_count < depth)
+            break;
+        // another client took the room first
+        spin_unlock(&tafi_live_frame_lock);
+        tafi_frame_unmap(frame);
+    }
+    // the pickup that takes it is the one after those of the frames ahead
+    *ticket = tafi_color_data_pickups + tafi_fifo_count;
+    tafi_fifo[(tafi_fifo_head + tafi_fifo_count) % TAFI_PRESENT_FIFO_MAX] = frame;
+    tafi_fifo_count++;
+    tafi_color_data_dirty = true;
+    spin_unlock(&tafi_live_frame_lock);
+
+    wake_up(&tafi_color_data_dirty_wait);
+    return 0;
+}
+
+/**
+ * Get a reference to the frame that will be on display last, the newest
+ * queued one or else the live one, in native layout.
+ * Returns NULL if there is no memory for that.
+ */
+struct tafi_frame *tafi_frame_get_newest_native(void) {
+    struct tafi_frame *newest;
+    struct tafi_frame *frame;
+
+    spin_lock(&tafi_live_frame_lock);
+    if (tafi_fifo_count == 0) {
+        spin_unlock(&tafi_live_frame_lock);
+        return tafi_frame_get_live_native();
+    }
+    newest = tafi_fifo[(tafi_fifo_head + tafi_fifo_count - 1) % TAFI_PRESENT_FIFO_MAX];
+    kref_get(&newest->ref);
+    spin_unlock(&tafi_live_frame_lock);
+
+    if (!newest->indexed)
+        return newest;
+
+    frame = tafi_frame_alloc();
+    if (frame)
+        tafi_palette_expand(newest->data, frame->data);
+    tafi_frame_put(newest);
+    return frame;
+}
+
+/**
+ * Make the scheduled frame live if its tick has come.
+ */
+static void tafi_publish_due(u64 tick) {
+    struct tafi_frame *frame = NULL;
+
+    spin_lock(&tafi_live_frame_lock);
+    if (tafi_scheduled_frame && tafi_scheduled_tick <= tick) {
+        frame = tafi_scheduled_frame;
+        tafi_scheduled_frame = NULL;
+    }
+    spin_unlock(&tafi_live_frame_lock);
+
+    if (frame)
+        tafi_make_live(frame);
+}
+
+/**
+ * Have the thread convert and send the next frame from a pipelined display,
+ * superseding the live frame. The result becomes the live frame unless
+ * something else is published in the meantime.
+ * Returns a ticket for tafi_wait_for_pickup().
+ */
+u64 tafi_pipeline_submit(struct tafi_pipeline_source *source) {
+    u64 ticket;
+
+    mutex_lock(&tafi_color_data_mutex);
+    spin_lock(&tafi_live_frame_lock);
+    tafi_pipeline_pending = source;
+    tafi_color_data_dirty = true;
+    ticket = tafi_color_data_pickups;
+    spin_unlock(&tafi_live_frame_lock);
+    mutex_unlock(&tafi_color_data_mutex);
+
+    wake_up(&tafi_color_data_dirty_wait);
+    return ticket;
+}
+
+/**
+ * Withdraw a pending submission. The thread no longer uses the source
+ * once this returns.
+ */
+void tafi_pipeline_cancel(struct tafi_pipeline_source *source) {
+    mutex_lock(&tafi_pipeline_mutex);
+    spin_lock(&tafi_live_frame_lock);
+    if (tafi_pipeline_pending == source)
+        tafi_pipeline_pending = NULL;
+    spin_unlock(&tafi_live_frame_lock);
+    mutex_unlock(&tafi_pipeline_mutex);
+}
+
+/**
+ * Make a frame converted by the thread the live one, unless another frame
+ * was published since expected was taken. Takes over the reference.
+ */
+static void tafi_replace_live_frame(struct tafi_frame *frame, struct tafi_frame *expected) {
+    struct tafi_frame *old = NULL;
+
+    frame->dma = tafi_spi_map(frame->data, TAFI_DATA_BUF_LEN);
+
+    spin_lock(&tafi_live_frame_lock);
+    if (tafi_live_frame == expected) {
+        old = tafi_live_frame;
+        tafi_live_frame = frame;
+        tafi_live_frame_queued = false;
+        frame = NULL;
+    }
+    spin_unlock(&tafi_live_frame_lock);
+
+    tafi_frame_put(old);
+    tafi_frame_put(frame);
+}
+
+/**
+ * Copy several ranges of a full-size frame into the internal color data
+ * buffer, at the same offsets, as one update.
+ * The update is built in a new frame from the live one and then published,
+ * so the thread never waits for the copy.
+ * Returns 0 and, if ticket is given, a ticket for tafi_wait_for_pickup()
+ * in it, or -ENOMEM if the update was dropped.
+ * Unsafe to call without bounds checking.
+ */
+int tafi_set_color_ranges(const void *frame, const struct tafi_range *ranges, unsigned int count, u64 *ticket) {
+    struct tafi_frame *live;
+    struct tafi_frame *next;
+    unsigned int i;
+    u64 pickup;
+
+    next = tafi_frame_alloc();
+    if (next == NULL) {
+        printk(KERN_ERR TAFI_LOG_PREFIX"failed to allocate memory for frame update.");
+        return -ENOMEM;
+    }
+
+    mutex_lock(&tafi_color_data_mutex);
+    live = tafi_frame_get_live_native();
+    if (live == NULL) {
+        mutex_unlock(&tafi_color_data_mutex);
+        tafi_frame_put(next);
+        printk(KERN_ERR TAFI_LOG_PREFIX"failed to allocate memory for frame update.");
+        return -ENOMEM;
+    }
+    memcpy(next->data, live->data, TAFI_DATA_BUF_LEN);
+    tafi_frame_put(live);
+    for (i = 0; i < count; i++) {
+        memcpy(next->data + ranges[i].offset,
+            (const unsigned char *) frame + ranges[i].offset, ranges[i].len);
+    }
+    tafi_frame_map(next);
+    pickup = tafi_make_live(next);
+    mutex_unlock(&tafi_color_data_mutex);
+    if (ticket)
+        *ticket = pickup;
+    return 0;
+}
+
 /**
  * Set the internal color data buffer contents.
  * Unsafe to call without bounds checking.
  */
 void tafi_set_color_data(void *buf, size_t len, loff_t offset) {
+    struct tafi_range range = { .offset = offset, .len = len };
+
     printk(KERN_INFO TAFI_LOG_PREFIX"setting color data...");
-    mutex_lock(&tafi_color_data_mutex);
-    memcpy(tafi_color_data_buf+offset, buf, len);
+    // the ranges are relative to the start of a frame
+    tafi_set_color_ranges((unsigned char *) buf - offset, &range, 1, NULL);
+}
+
+/**
+ * Have the thread send the frame on display again, e.g. because the
+ * palette of an indexed frame changed, even in idle mode.
+ * Returns a ticket for tafi_wait_for_pickup().
+ */
+u64 tafi_refresh(void) {
+    u64 ticket;
+
+    spin_lock(&tafi_live_frame_lock);
     tafi_color_data_dirty = true;
-    mutex_unlock(&tafi_color_data_mutex);
+    ticket = tafi_color_data_pickups;
+    spin_unlock(&tafi_live_frame_lock);
+
+    wake_up(&tafi_color_data_dirty_wait);
+    return ticket;
 }
 
 /**
- * Copy the color data buffer if dirty flag is set,
+ * Sleep until the thread has picked up the update that returned the ticket.
+ * Returns -ERESTARTSYS if interrupted by a signal.
+ */
+int tafi_wait_for_pickup(u64 ticket) {
+    return wait_event_interruptible(tafi_color_data_pickup_wait,
+        READ_ONCE(tafi_color_data_pickups) > ticket);
+}
+
+/**
+ * Number of times the thread has picked up the buffer so far.
+ */
+u64 tafi_color_data_pickup_count(void) {
+    return READ_ONCE(tafi_color_data_pickups);
+}
+
+/**
+ * Take a reference to the live frame if dirty flag is set,
  * and clear the dirty flag.
+ * Without an idle keepalive, or when force is set, the frame is always taken.
+ * A pending pipeline source is handed out as well, to be converted instead.
+ * The oldest queued frame, if any, goes live first and wins over both,
+ * unless fading is set and the live frame, still fading in, was queued
+ * itself; a frame published directly doesn't hold up the queue. A pending
+ * source then stays pending for the next pickup.
  */
-static bool tafi_cpy_data_and_reset_if_dirty(void *buf) {
-    bool ret = false;
+static struct tafi_frame *tafi_take_frame_and_reset_if_dirty(bool force, bool fading,
+    struct tafi_pipeline_source **source) {
 
-    mutex_lock(&tafi_color_data_mutex);
-    //if (tafi_color_data_dirty) {
-    memcpy(buf, tafi_color_data_buf, TAFI_DATA_BUF_LEN);
-        //tafi_color_data_dirty = false;
-    ret = true;
-    //}
-    mutex_unlock(&tafi_color_data_mutex);
-    return ret;
+    struct tafi_frame *frame;
+    struct tafi_frame *old = NULL;
+    u64 pickups;
+
+    spin_lock(&tafi_live_frame_lock);
+    *source = NULL;
+    if (tafi_fifo_count && !(fading && tafi_live_frame_queued)) {
+        old = tafi_live_frame;
+        tafi_live_frame = tafi_fifo[tafi_fifo_head];
+        tafi_live_frame_queued = true;
+        tafi_fifo_head = (tafi_fifo_head + 1) % TAFI_PRESENT_FIFO_MAX;
+        tafi_fifo_count--;
+        tafi_color_data_dirty = true;
+    } else {
+        *source = tafi_pipeline_pending;
+        tafi_pipeline_pending = NULL;
+    }
+    if (!tafi_color_data_dirty && idle_keepalive_ms && !force) {
+        spin_unlock(&tafi_live_frame_lock);
+        return NULL;
+    }
+    frame = tafi_live_frame;
+    kref_get(&frame->ref);
+    // the rest of the queue, and a source left pending, still have to be
+    // picked up
+    tafi_color_data_dirty = tafi_fifo_count > 0 || tafi_pipeline_pending;
+    pickups = ++tafi_color_data_pickups;
+    spin_unlock(&tafi_live_frame_lock);
+
+    tafi_frame_put(old);
+
+    wake_up_interruptible(&tafi_color_data_pickup_wait);
+    tafi_dmabuf_signal(pickups);
+    return frame;
 }
 
 /**
@@ -158,58 +653,267 @@ static bool tafi_cpy_data_and_reset_if_dirty(void *buf) {
  * Unsafe to call without bounds checking.
  */
 void tafi_get_color_data(void *buf, size_t len, loff_t offset) {
-    mutex_lock(&tafi_color_data_mutex);
-    memcpy(buf, tafi_color_data_buf+offset, len);
-    mutex_unlock(&tafi_color_data_mutex);
+    struct tafi_frame *frame;
+
+    frame = tafi_frame_get_live_native();
+    if (frame == NULL) {
+        memset(buf, 0, len);
+        return;
+    }
+    memcpy(buf, frame->data + offset, len);
+    tafi_frame_put(frame);
+}
+
+/**
+ * Idle until new content arrives, the keepalive deadline after the last
+ * transmission passes, or the thread is stopped.
+ * Returns true if the keepalive deadline was reached.
+ */
+static bool tafi_thread_idle(ktime_t last_transmit) {
+    s64 remaining_ms;
+
+    remaining_ms = idle_keepalive_ms - ktime_ms_delta(ktime_get(), last_transmit);
+    if (remaining_ms <= 0)
+        return true;
+
+    return !wait_event_interruptible_timeout(tafi_color_data_dirty_wait,
+        READ_ONCE(tafi_color_data_dirty) || kthread_should_stop(),
+        msecs_to_jiffies(remaining_ms));
 }
 
+/**
+ * Convert a frame from a pipelined display a group of sectors at a time,
+ * queueing each group for transmission before converting the next one.
+ * Must be called with the bus locked.
+ * This only overlaps conversion with the transfer of the frame it is
+ * part of; the update still waits for the next frame period to start.
+ * The controller's message pump must get a CPU while this thread
+ * converts, which on a single core takes a pump at a higher rt priority
+ * than thread_priority, otherwise the pieces go out one after another.
+ */
+static void tafi_thread_send_pipelined(struct tafi_pipeline_source *source, unsigned char *buf, ktime_t start) {
+    unsigned int group = clamp_t(unsigned int, READ_ONCE(pipeline_sectors), 1, TAFI_SECTOR_COUNT);
+    unsigned int first;
+    unsigned int count;
+
+    for (first = 0; first < TAFI_SECTOR_COUNT; first += count) {
+        count = min_t(unsigned int, group, TAFI_SECTOR_COUNT - first);
+        source->convert(source, first, count, buf);
+        if (first == 0)
+            tafi_hist_add(&tafi_pipeline_first_piece, ktime_to_ns(ktime_sub(ktime_get(), start)));
+        if (tafi_wire_queue_locked(buf, first, count) < 0) {
+            printk(KERN_ERR TAFI_LOG_PREFIX"failed to queue frame piece.");
+            // finish the frame anyway, it becomes the live one
+            source->convert(source, first + count, TAFI_SECTOR_COUNT - first - count, buf);
+            break;
+        }
+    }
 
+    tafi_data_queue_wait();
+}
 
 static int tafi_thread(void *data) {
     
-    // Internal buffer used to write the data to SPI.
-    // Stops blocking the actual buffer.
-    void *buf;
+    // Frame being transmitted, referenced so writers never block on it.
+    struct tafi_frame *frame;
+    // Frame being converted by the thread for a pipelined display.
+    struct tafi_frame *next;
+    // frame, or its odd phase on odd revolutions
+    struct tafi_frame *shown;
+    struct tafi_pipeline_source *source;
+    const unsigned char *buf;
+    // buf before transforms
+    const unsigned char *native;
+    dma_addr_t dma;
     unsigned char reset = 0;
     unsigned char term = 0xff;
     int i = 0;
-
-    buf = kmalloc(TAFI_DATA_BUF_LEN, GFP_KERNEL);
-    if (buf == NULL) {
-        printk(KERN_ERR TAFI_LOG_PREFIX"failed to allocate memory for internal display buffer.");
-        return -ENOMEM;
-    }
+    ktime_t setup;
+    ktime_t start;
+    ktime_t nominal;
+    ktime_t sent;
+    ktime_t last_start = 0;
+    ktime_t wakeup;
+    ktime_t deadline;
+    // interleaved frames transmitted, the odd ones show the odd phase
+    unsigned long transmissions = 0;
+    bool keepalive = true;
+    bool idled = false;
+    // the last frame is dithered or interleaved, so each transmission differs
+    bool varying = false;
 
     printk(KERN_INFO TAFI_LOG_PREFIX"thread running.");
 
     // check if the thread should stop
     while (!kthread_should_stop()) {
-        if (tafi_cpy_data_and_reset_if_dirty(buf)) {
+        tafi_counter_inc(&tafi_thread_wakeups);
+        tafi_publish_due(tafi_clock_seq());
+        mutex_lock(&tafi_pipeline_mutex);
+        frame = tafi_take_frame_and_reset_if_dirty(keepalive || varying, tafi_fade_active(), &source);
+        next = NULL;
+        varying = false;
+        if (source) {
+            next = tafi_frame_alloc();
+            if (next == NULL) {
+                printk(KERN_ERR TAFI_LOG_PREFIX"failed to allocate memory for pipelined frame.");
+                source = NULL;
+            }
+        }
+        if (frame) {
+            // every other transmission shows the phase sampled half a sector
+            // later, counted per frame sent so skipped ticks can't repeat a
+            // phase, and starts half a sector after the tick so it lands
+            // where it was sampled
+            shown = !next && frame->phase && (transmissions++ & 1) ? frame->phase : frame;
+            if (shown != frame) {
+                deadline = ktime_add_us(tafi_clock_last_tick(), TAFI_HALF_SECTOR_US);
+                set_current_state(TASK_UNINTERRUPTIBLE);
+                schedule_hrtimeout_range(&deadline, 0, HRTIMER_MODE_ABS);
+            }
+            buf = next ? next->data : shown->data;
+            dma = next ? DMA_MAPPING_ERROR : shown->dma;
+            tafi_counter_inc(&tafi_frames_transmitted);
+            if (keepalive && idle_keepalive_ms)
+                tafi_counter_inc(&tafi_keepalive_frames);
+            setup = ktime_get();
+            // the palette is applied once per frame, here
+            if (!next && shown->indexed) {
+                tafi_palette_expand(shown->data, tafi_thread_buf);
+                buf = tafi_thread_buf;
+                dma = DMA_MAPPING_ERROR;
+            } else if (!next && shown->dither) {
+                tafi_convert_dither(shown->data, shown->dither, tafi_dither_error, tafi_thread_buf);
+                buf = tafi_thread_buf;
+                dma = DMA_MAPPING_ERROR;
+            }
+            // a new frame may crossfade in, a pipelined one always cuts
+            if (!next && tafi_fade_apply(frame, buf, tafi_thread_buf) != buf) {
+                buf = tafi_thread_buf;
+                dma = DMA_MAPPING_ERROR;
+            }
+            native = buf;
+            // hold the bus for the whole frame
+            tafi_bus_lock();
+            start = ktime_get();
+            // the jitter is against the tick, not the delayed start
+            nominal = shown != frame ? ktime_sub_us(start, TAFI_HALF_SECTOR_US) : start;
+            if (last_start && !idled)
+                tafi_hist_add(&tafi_period_jitter,
+                    abs(ktime_to_ns(ktime_sub(nominal, last_start)) - (s64) TAFI_FRAME_PERIOD_US * NSEC_PER_USEC));
+            last_start = nominal;
             tafi_frame_begin();
+            sent = ktime_get();
+            tafi_hist_add(&tafi_frame_setup, ktime_to_ns(ktime_sub(sent, setup)));
             //tafi_data_write(&reset, 1);
             //tafi_data_write(buf+(i*TAFI_SECTOR_BUF_LEN), TAFI_SECTOR_BUF_LEN);
-            tafi_data_write(buf, TAFI_DATA_BUF_LEN);
+            if (source && !tafi_transform_active()) {
+                tafi_thread_send_pipelined(source, next->data, sent);
+            } else {
+                // transforms need the whole frame, so no pipelining
+                if (source)
+                    source->convert(source, 0, TAFI_SECTOR_COUNT, next->data);
+                buf = tafi_transform_write_locked(buf, dma);
+            }
             //tafi_data_write(&term, 1);
             tafi_frame_end();
+            tafi_bus_unlock();
+            tafi_hist_add(&tafi_frame_transfer, ktime_to_ns(ktime_sub(ktime_get(), sent)));
+            tafi_fade_sent(native);
+            tafi_capture_frame(buf, TAFI_DATA_BUF_LEN, start, ktime_get());
+#ifdef TAFI_DRM
+            tafi_drm_handle_vblank();
+#endif
+            if (next)
+                tafi_replace_live_frame(next, frame);
+            // a dithered, interleaved, fading or spinning frame can't idle,
+            // but it isn't uploaded again either
+            varying = !next && (frame->dither || frame->phase || tafi_fade_active() || tafi_transform_animated());
+            tafi_frame_put(frame);
         }
+        mutex_unlock(&tafi_pipeline_mutex);
         //i++;
         //i = i%150;
-        usleep_range(92600, 92600);
-    }
 
-    kfree(buf);
+        // static content, sleep until something changes, a scheduled frame
+        // has to be watched for its tick though
+        idled = idle_keepalive_ms && !varying && !READ_ONCE(tafi_color_data_dirty) &&
+            !READ_ONCE(tafi_scheduled_frame);
+        keepalive = idled && tafi_thread_idle(last_start);
+
+        // every frame starts on a tick of the frame clock
+        wakeup = tafi_clock_wait();
+        tafi_hist_add(&tafi_wakeup_latency, ktime_to_ns(ktime_sub(ktime_get(), wakeup)));
+    }
 
     printk(KERN_INFO TAFI_LOG_PREFIX"thread returning.");
     return 0;
 }
 
+/**
+ * Apply the configured scheduling policy and CPU affinity.
+ * Must be called before the thread is woken up for the first time.
+ */
+static int tafi_thread_setup(struct task_struct *task) {
+    struct sched_attr attr = {
+        .size = sizeof(attr),
+        .sched_policy = SCHED_FIFO,
+        .sched_priority = thread_priority,
+    };
+    int ret;
+
+    if (thread_cpu >= 0) {
+        if (thread_cpu >= nr_cpu_ids || !cpu_online(thread_cpu)) {
+            printk(KERN_ERR TAFI_LOG_PREFIX"thread CPU %d is not online.", thread_cpu);
+            return -EINVAL;
+        }
+        kthread_bind(task, thread_cpu);
+    }
+
+    if (thread_priority <= 0)
+        return 0;
+
+    if (thread_priority > TAFI_KTHREAD_SCHEDULER_PRIORITY) {
+        printk(KERN_INFO TAFI_LOG_PREFIX"thread priority capped at %d.", TAFI_KTHREAD_SCHEDULER_PRIORITY);
+        attr.sched_priority = TAFI_KTHREAD_SCHEDULER_PRIORITY;
+    }
+
+    ret = sched_setattr_nocheck(task, &attr);
+    if (ret < 0)
+        printk(KERN_ERR TAFI_LOG_PREFIX"failed to set thread scheduling policy.");
+    return ret;
+}
+
 static int tafi_thread_init(void) {
+    int ret;
+
     printk(KERN_INFO TAFI_LOG_PREFIX"thread starting...");
-    tafi_task = kthread_run(tafi_thread, NULL, TAFI_KTHREAD_NAME);
+    tafi_thread_buf = kmalloc(TAFI_DATA_BUF_LEN, GFP_KERNEL);
+    if (tafi_thread_buf == NULL)
+        return -ENOMEM;
+    tafi_stats_register_hist(&tafi_wakeup_latency);
+    tafi_stats_register_hist(&tafi_period_jitter);
+    tafi_stats_register_counter(&tafi_thread_wakeups);
+    tafi_stats_register_counter(&tafi_frames_transmitted);
+    tafi_stats_register_counter(&tafi_keepalive_frames);
+    tafi_stats_register_hist(&tafi_frame_setup);
+    tafi_stats_register_hist(&tafi_frame_transfer);
+    tafi_stats_register_hist(&tafi_pipeline_first_piece);
+
+    tafi_task = kthread_create(tafi_thread, NULL, TAFI_KTHREAD_NAME);
     if (IS_ERR(tafi_task)) {
         printk(KERN_INFO TAFI_LOG_PREFIX"thread starting failed.");
+        kfree(tafi_thread_buf);
         return PTR_ERR(tafi_task);
     }
+
+    ret = tafi_thread_setup(tafi_task);
+    if (ret < 0) {
+        kthread_stop(tafi_task);
+        kfree(tafi_thread_buf);
+        return ret;
+    }
+
+    wake_up_process(tafi_task);
     printk(KERN_INFO TAFI_LOG_PREFIX"thread started.");
     return 0;
 }
@@ -221,6 +925,7 @@ static void tafi_thread_exit(void) {
     if (ret != -EINTR) {
         printk(KERN_INFO TAFI_LOG_PREFIX"thread stopped.");
     }
+    kfree(tafi_thread_buf);
 }
 
 
@@ -247,58 +952,145 @@ static int __init tafi_init(void) {
         return ret;
     }
 
+    // cache aligned, frames are mapped for DMA; objects take the size and
+    // alignment of struct tafi_frame, so its data has its own cache lines
+    tafi_frame_cache = KMEM_CACHE(tafi_frame, SLAB_HWCACHE_ALIGN);
+    if (tafi_frame_cache == NULL) {
+        ret = -ENOMEM;
+        goto err_spi;
+    }
+
+    tafi_live_frame = tafi_frame_alloc();
+    if (tafi_live_frame == NULL) {
+        ret = -ENOMEM;
+        goto err_frame_cache;
+    }
+
     // init the initial data buffer
     // this serves as a diagnostic screen as well as a security measure
     // to prevent kernel space memory leaking into user space via an 
     // initial read of the buffer.
     while (i < TAFI_SECTOR_COUNT) {
+        unsigned char *sector = tafi_live_frame->data + i * TAFI_SECTOR_BUF_LEN;
+
         if (i < 50) {
-            memcpy(tafi_color_data_buf[i], BUF[0], TAFI_SECTOR_BUF_LEN);
+            memcpy(sector, BUF[0], TAFI_SECTOR_BUF_LEN);
         } else if (i < 100) {
-            memcpy(tafi_color_data_buf[i], BUF[1], TAFI_SECTOR_BUF_LEN);
+            memcpy(sector, BUF[1], TAFI_SECTOR_BUF_LEN);
         }
          else {
-            memcpy(tafi_color_data_buf[i], BUF[2], TAFI_SECTOR_BUF_LEN);
+            memcpy(sector, BUF[2], TAFI_SECTOR_BUF_LEN);
         }
         i++;
     }
+    tafi_live_frame->dma = tafi_spi_map(tafi_live_frame->data, TAFI_DATA_BUF_LEN);
 
     // init mutex
     mutex_init(&tafi_color_data_mutex);
 
+    // conversion tables, must be ready before any display device is up
+    tafi_convert_init();
+    tafi_palette_init();
+
+    // diagnostics, must be up before the thread starts transmitting
+    tafi_debugfs_init();
+    tafi_stats_init();
+    tafi_present_init();
+    ret = tafi_capture_init();
+    if (ret < 0)
+        goto err_capture;
+
+    // init dma-buf frame ring
+    ret = tafi_dmabuf_init();
+    if (ret < 0)
+        goto err_capture;
+
+    // geometric transforms, applied by the thread
+    ret = tafi_transform_init();
+    if (ret < 0)
+        goto err_dmabuf;
+
+    // wire compression, applied by the thread
+    ret = tafi_wire_init();
+    if (ret < 0)
+        goto err_transform;
+
+    // crossfades, blended by the thread
+    ret = tafi_fade_init();
+    if (ret < 0)
+        goto err_wire;
+
+    // frame clock, internal or from the sync input
+    ret = tafi_clock_init();
+    if (ret < 0)
+        goto err_fade;
+
     // start thread
     ret = tafi_thread_init();
-    if (ret < 0) {
-        tafi_gpio_exit();
-        tafi_spi_exit();
-         mutex_destroy(&tafi_color_data_mutex);
-        return ret;
-    }
+    if (ret < 0)
+        goto err_clock;
 
     // init chardev
     ret = tafi_chardev_init();
-     if (ret < 0) {
-        tafi_gpio_exit();
-        tafi_spi_exit();
-        tafi_thread_exit();
-        mutex_destroy(&tafi_color_data_mutex);
-        return ret;
-    }
+    if (ret < 0)
+        goto err_thread;
 
+#ifdef TAFI_DRM
+    ret = tafi_drm_init();
+#else
     ret = tafi_fb_init();
-    if (ret < 0) {
-        tafi_chardev_exit();
-        tafi_gpio_exit();
-        tafi_spi_exit();
-        tafi_thread_exit();
-        mutex_destroy(&tafi_color_data_mutex);
-        return ret;
-    }
+#endif
+    if (ret < 0)
+        goto err_chardev;
+
+#ifdef TAFI_V4L2
+    ret = tafi_v4l2_init();
+    if (ret < 0)
+        goto err_display;
+#endif
+
+    // load generator, a client like any other
+    tafi_gen_init();
 
     // create sysfs ctl device
     // init FB (maybe)
     printk(KERN_INFO TAFI_LOG_PREFIX"staring done.");
     return 0;
+
+#ifdef TAFI_V4L2
+err_display:
+#ifdef TAFI_DRM
+    tafi_drm_exit();
+#else
+    tafi_fb_exit();
+#endif
+#endif
+err_chardev:
+    tafi_chardev_exit();
+err_thread:
+    tafi_thread_exit();
+err_clock:
+    tafi_clock_exit();
+err_fade:
+    tafi_fade_exit();
+err_wire:
+    tafi_wire_exit();
+err_transform:
+    tafi_transform_exit();
+err_dmabuf:
+    tafi_dmabuf_exit();
+err_capture:
+    tafi_debugfs_exit();
+    tafi_stats_exit();
+    tafi_capture_exit();
+    mutex_destroy(&tafi_color_data_mutex);
+    tafi_frame_put(tafi_live_frame);
+err_frame_cache:
+    kmem_cache_destroy(tafi_frame_cache);
+err_spi:
+    tafi_gpio_exit();
+    tafi_spi_exit();
+    return ret;
 }
 
 /**
@@ -307,15 +1099,51 @@ static int __init tafi_init(void) {
 static void __exit tafi_exit(void) {
     printk(KERN_INFO TAFI_LOG_PREFIX"stopping...");
 
+    // stop the load generator first, it publishes frames
+    tafi_gen_exit();
+
     // stuff to do
+#ifdef TAFI_V4L2
+    // stop video output device
+    tafi_v4l2_exit();
+#endif
+
     // stop framebuffer device
+#ifdef TAFI_DRM
+    tafi_drm_exit();
+#else
     tafi_fb_exit();
+#endif
 
     // stop character device
     tafi_chardev_exit();
 
     // stop thread
     tafi_thread_exit();
+    tafi_clock_exit();
+    tafi_fade_exit();
+    tafi_wire_exit();
+    tafi_transform_exit();
+
+    // release dma-buf frame ring and pending fences
+    tafi_dmabuf_exit();
+
+    // remove diagnostics
+    tafi_debugfs_exit();
+    tafi_stats_exit();
+    tafi_capture_exit();
+
+    // release the last frames, unmapping them while SPI is still up
+    while (tafi_fifo_count) {
+        tafi_frame_put(tafi_fifo[tafi_fifo_head]);
+        tafi_fifo_head = (tafi_fifo_head + 1) % TAFI_PRESENT_FIFO_MAX;
+        tafi_fifo_count--;
+    }
+    tafi_frame_put(tafi_scheduled_frame);
+    tafi_frame_put(tafi_live_frame);
+    // and wait for those still held elsewhere, e.g. by a file being closed
+    wait_event(tafi_frame_release_wait, atomic_read(&tafi_frame_count) == 0);
+    kmem_cache_destroy(tafi_frame_cache);
 
     // de-init GPIO and SPI
     tafi_gpio_exit();
@@ -0,0 +1,42 @@
+/**
+ *  tafi_debugfs.c -- The Amazing Fan Idea driver
+ *  Debugfs directory shared by the driver's diagnostic interfaces.
+ * 
+ *      (C) 2017 Harindu Perera
+ *  
+ *  This file is subject to the terms and conditions of the GNU General Public
+ *  License. See the file COPYING in the main directory of this archive for
+ *  more details.
+ */
+
+#include <linux/err.h>
+
+#include "tafi_common.h"
+#include "tafi_debugfs.h"
+
+static struct dentry *tafi_debugfs_root;
+
+/**
+ * Create the debugfs directory.
+ * A missing debugfs is not fatal, the diagnostic files are simply not created.
+ */
+int tafi_debugfs_init(void) {
+    tafi_debugfs_root = debugfs_create_dir(TAFI_DEBUGFS_DIR_NAME, NULL);
+    if (IS_ERR_OR_NULL(tafi_debugfs_root)) {
+        printk(KERN_INFO TAFI_LOG_PREFIX"debugfs not available, diagnostics disabled.");
+        tafi_debugfs_root = NULL;
+    }
+    return 0;
+}
+
+/**
+ * Remove the debugfs directory and everything created below it.
+ */
+void tafi_debugfs_exit(void) {
+    debugfs_remove_recursive(tafi_debugfs_root);
+    tafi_debugfs_root = NULL;
+}
+
+struct dentry *tafi_debugfs_dir(void) {
+    return tafi_debugfs_root;
+}
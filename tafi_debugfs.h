@@ -0,0 +1,26 @@
+/**
+ *  tafi_debugfs.h -- The Amazing Fan Idea driver
+ *  Debugfs directory shared by the driver's diagnostic interfaces.
+ * 
+ *      (C) 2017 Harindu Perera
+ *  
+ *  This file is subject to the terms and conditions of the GNU General Public
+ *  License. See the file COPYING in the main directory of this archive for
+ *  more details.
+ */
+
+#ifndef TAFI_DEBUGFS
+#define TAFI_DEBUGFS
+
+#include <linux/debugfs.h>
+
+#define TAFI_DEBUGFS_DIR_NAME "tafi"
+
+int tafi_debugfs_init(void);
+
+void tafi_debugfs_exit(void);
+
+// The driver's debugfs directory, or NULL if debugfs is unavailable.
+struct dentry *tafi_debugfs_dir(void);
+
+#endif
@@ -0,0 +1,448 @@
+/**
+ *  tafi_dmabuf.c -- The Amazing Fan Idea driver
+ *  DMA-BUF export of the frame buffers and import of external frames.
+ *
+ *  Exported buffers wrap the framebuffer video memory or one of the slots
+ *  of the native frame ring. Imported buffers are read once, after their
+ *  exclusive fence has signalled, and the caller gets a fence back that
+ *  signals when the transmit thread has picked the frame up. Not every
+ *  exporter maps its memory into the kernel, udmabuf doesn't on the kernels
+ *  this builds on, so frames are copied out of the pages of an attachment
+ *  unless the exporter does.
+ * 
+ *      (C) 2017 Harindu Perera
+ *  
+ *  This file is subject to the terms and conditions of the GNU General Public
+ *  License. See the file COPYING in the main directory of this archive for
+ *  more details.
+ */
+
+#include <linux/dma-fence.h>
+#include <linux/dma-mapping.h>
+#include <linux/dma-resv.h>
+#include <linux/file.h>
+#include <linux/list.h>
+#include <linux/mm.h>
+#include <linux/module.h>
+#include <linux/scatterlist.h>
+#include <linux/slab.h>
+#include <linux/spinlock.h>
+#include <linux/sync_file.h>
+#include <linux/vmalloc.h>
+
+#include "tafi_common.h"
+#include "tafi_ioctl.h"
+#include "tafi_dmabuf.h"
+#include "tafi_bus.h"
+#include "tafi_present.h"
+
+#define TAFI_DMABUF_FRAME_SIZE PAGE_ALIGN(TAFI_DATA_BUF_LEN)
+
+// An exported piece of vmalloc_user() memory.
+struct tafi_dmabuf_buffer {
+    void *vaddr;
+    size_t size;
+    void (*flush)(void *priv);
+    void *priv;
+};
+
+// A fence that signals once the thread has picked up an update. Its seqno
+// is the update's ticket, the pickup count it waits for.
+struct tafi_fence {
+    struct dma_fence base;
+    struct list_head node;
+};
+
+// The native frame ring.
+static void *tafi_dmabuf_ring[TAFI_DMABUF_RING_FRAMES];
+
+// Fence contexts, one for published frames and one for queued ones. The
+// tickets of each only grow, those of queued frames are ahead of the pickup
+// count by the frames queued before them.
+#define TAFI_FENCE_CONTEXT_PUBLISHED 0
+#define TAFI_FENCE_CONTEXT_QUEUED 1
+#define TAFI_FENCE_CONTEXTS 2
+
+static u64 tafi_fence_context;
+static DEFINE_SPINLOCK(tafi_fence_lock);
+
+// Fences not yet signalled, in seqno order across both contexts.
+static LIST_HEAD(tafi_fence_list);
+static DEFINE_SPINLOCK(tafi_fence_list_lock);
+
+// Exported buffers
+
+static struct sg_table *tafi_dmabuf_map(struct dma_buf_attachment *attach, enum dma_data_direction dir) {
+    struct tafi_dmabuf_buffer *buffer = attach->dmabuf->priv;
+    unsigned int page_count = buffer->size >> PAGE_SHIFT;
+    struct page **pages;
+    struct sg_table *sgt;
+    unsigned int i;
+    int ret;
+
+    pages = kmalloc_array(page_count, sizeof(*pages), GFP_KERNEL);
+    if (pages == NULL)
+        return ERR_PTR(-ENOMEM);
+    for (i = 0; i < page_count; i++)
+        pages[i] = vmalloc_to_page(buffer->vaddr + (i << PAGE_SHIFT));
+
+    sgt = kzalloc(sizeof(*sgt), GFP_KERNEL);
+    if (sgt == NULL) {
+        ret = -ENOMEM;
+        goto err_pages;
+    }
+
+    ret = sg_alloc_table_from_pages(sgt, pages, page_count, 0, buffer->size, GFP_KERNEL);
+    if (ret)
+        goto err_sgt;
+
+    if (!dma_map_sg(attach->dev, sgt->sgl, sgt->nents, dir)) {
+        ret = -ENOMEM;
+        goto err_table;
+    }
+
+    kfree(pages);
+    return sgt;
+
+err_table:
+    sg_free_table(sgt);
+err_sgt:
+    kfree(sgt);
+err_pages:
+    kfree(pages);
+    return ERR_PTR(ret);
+}
+
+static void tafi_dmabuf_unmap(struct dma_buf_attachment *attach, struct sg_table *sgt, enum dma_data_direction dir) {
+    dma_unmap_sg(attach->dev, sgt->sgl, sgt->nents, dir);
+    sg_free_table(sgt);
+    kfree(sgt);
+}
+
+static void tafi_dmabuf_release(struct dma_buf *dmabuf) {
+    kfree(dmabuf->priv);
+}
+
+static int tafi_dmabuf_mmap(struct dma_buf *dmabuf, struct vm_area_struct *vma) {
+    struct tafi_dmabuf_buffer *buffer = dmabuf->priv;
+
+    return remap_vmalloc_range(vma, buffer->vaddr, vma->vm_pgoff);
+}
+
+static void *tafi_dmabuf_vmap(struct dma_buf *dmabuf) {
+    struct tafi_dmabuf_buffer *buffer = dmabuf->priv;
+
+    return buffer->vaddr;
+}
+
+static int tafi_dmabuf_begin_cpu_access(struct dma_buf *dmabuf, enum dma_data_direction dir) {
+    return 0;
+}
+
+/**
+ * CPU writes through the dma-buf are done, push the contents to the display.
+ */
+static int tafi_dmabuf_end_cpu_access(struct dma_buf *dmabuf, enum dma_data_direction dir) {
+    struct tafi_dmabuf_buffer *buffer = dmabuf->priv;
+
+    if (dir != DMA_FROM_DEVICE && buffer->flush)
+        buffer->flush(buffer->priv);
+    return 0;
+}
+
+static const struct dma_buf_ops tafi_dmabuf_ops = {
+    .map_dma_buf = tafi_dmabuf_map,
+    .unmap_dma_buf = tafi_dmabuf_unmap,
+    .release = tafi_dmabuf_release,
+    .mmap = tafi_dmabuf_mmap,
+    .vmap = tafi_dmabuf_vmap,
+    .begin_cpu_access = tafi_dmabuf_begin_cpu_access,
+    .end_cpu_access = tafi_dmabuf_end_cpu_access,
+};
+
+struct dma_buf *tafi_dmabuf_export_vmalloc(void *vaddr, size_t size, void (*flush)(void *priv), void *priv) {
+    DEFINE_DMA_BUF_EXPORT_INFO(exp_info);
+    struct tafi_dmabuf_buffer *buffer;
+    struct dma_buf *dmabuf;
+
+    buffer = kzalloc(sizeof(*buffer), GFP_KERNEL);
+    if (buffer == NULL)
+        return ERR_PTR(-ENOMEM);
+    buffer->vaddr = vaddr;
+    buffer->size = PAGE_ALIGN(size);
+    buffer->flush = flush;
+    buffer->priv = priv;
+
+    exp_info.ops = &tafi_dmabuf_ops;
+    exp_info.size = buffer->size;
+    exp_info.flags = O_RDWR;
+    exp_info.priv = buffer;
+
+    dmabuf = dma_buf_export(&exp_info);
+    if (IS_ERR(dmabuf))
+        kfree(buffer);
+    return dmabuf;
+}
+
+static void tafi_dmabuf_flush_frame(void *priv) {
+    tafi_set_color_data(priv, TAFI_DATA_BUF_LEN, 0);
+}
+
+/**
+ * Export a slot of the native frame ring.
+ */
+int tafi_dmabuf_export_frame(struct tafi_dmabuf_export *args) {
+    struct dma_buf *dmabuf;
+    int fd;
+
+    if (args->index >= TAFI_DMABUF_RING_FRAMES)
+        return -EINVAL;
+    if (args->flags & ~(O_CLOEXEC | O_ACCMODE))
+        return -EINVAL;
+
+    dmabuf = tafi_dmabuf_export_vmalloc(tafi_dmabuf_ring[args->index], TAFI_DMABUF_FRAME_SIZE,
+        tafi_dmabuf_flush_frame, tafi_dmabuf_ring[args->index]);
+    if (IS_ERR(dmabuf))
+        return PTR_ERR(dmabuf);
+
+    fd = dma_buf_fd(dmabuf, args->flags);
+    if (fd < 0) {
+        dma_buf_put(dmabuf);
+        return fd;
+    }
+
+    args->fd = fd;
+    return 0;
+}
+
+// Fences
+
+static const char *tafi_fence_get_driver_name(struct dma_fence *fence) {
+    return TAFI_DRIVER_NAME;
+}
+
+static const char *tafi_fence_get_timeline_name(struct dma_fence *fence) {
+    return "pickup";
+}
+
+static const struct dma_fence_ops tafi_fence_ops = {
+    .get_driver_name = tafi_fence_get_driver_name,
+    .get_timeline_name = tafi_fence_get_timeline_name,
+};
+
+/**
+ * Add a fence to the pending list at its seqno. Takes over the reference.
+ */
+static void tafi_fence_add(struct tafi_fence *fence) {
+    struct tafi_fence *prev;
+
+    spin_lock(&tafi_fence_list_lock);
+    // most fences are the newest, so look from the end
+    list_for_each_entry_reverse(prev, &tafi_fence_list, node) {
+        if (prev->base.seqno <= fence->base.seqno)
+            break;
+    }
+    list_add(&fence->node, &prev->node);
+    spin_unlock(&tafi_fence_list_lock);
+}
+
+void tafi_dmabuf_signal(u64 pickups) {
+    struct tafi_fence *fence, *tmp;
+    LIST_HEAD(ready);
+
+    if (list_empty_careful(&tafi_fence_list))
+        return;
+
+    spin_lock(&tafi_fence_list_lock);
+    list_for_each_entry_safe(fence, tmp, &tafi_fence_list, node) {
+        // the rest wait for later pickups
+        if (fence->base.seqno >= pickups)
+            break;
+        list_move_tail(&fence->node, &ready);
+    }
+    spin_unlock(&tafi_fence_list_lock);
+
+    list_for_each_entry_safe(fence, tmp, &ready, node) {
+        list_del(&fence->node);
+        dma_fence_signal(&fence->base);
+        dma_fence_put(&fence->base);
+    }
+}
+
+// Imported buffers
+
+/**
+ * Copy len bytes at offset out of a dma-buf, through the exporter's kernel
+ * mapping if it has one, otherwise out of the pages of an attachment,
+ * which every exporter supports. CPU access must have been begun.
+ */
+static int tafi_dmabuf_read(struct dma_buf *dmabuf, unsigned long offset, void *dst, size_t len) {
+    struct dma_buf_attachment *attach;
+    struct sg_table *sgt;
+    void *vaddr;
+    int ret = 0;
+
+    vaddr = dma_buf_vmap(dmabuf);
+    if (vaddr) {
+        memcpy(dst, (unsigned char *) vaddr + offset, len);
+        dma_buf_vunmap(dmabuf, vaddr);
+        return 0;
+    }
+
+    attach = dma_buf_attach(dmabuf, tafi_spi_import_device());
+    if (IS_ERR(attach))
+        return PTR_ERR(attach);
+
+    sgt = dma_buf_map_attachment(attach, DMA_TO_DEVICE);
+    if (IS_ERR(sgt)) {
+        ret = PTR_ERR(sgt);
+        goto err_detach;
+    }
+
+    // the table still lists the pages, however the mapping merged them
+    if (sg_pcopy_to_buffer(sgt->sgl, sgt->orig_nents, dst, len, offset) != len)
+        ret = -EINVAL;
+
+    dma_buf_unmap_attachment(attach, sgt, DMA_TO_DEVICE);
+err_detach:
+    dma_buf_detach(dmabuf, attach);
+    return ret;
+}
+
+/**
+ * Copy a native frame out of a dma-buf and present it for a client.
+ */
+int tafi_dmabuf_queue(struct tafi_dmabuf_queue *args, struct tafi_presenter *present, bool nonblock) {
+    struct dma_buf *dmabuf;
+    struct tafi_frame *frame;
+    struct tafi_fence *fence;
+    struct sync_file *sync;
+    unsigned int context;
+    u64 ticket;
+    long lret;
+    int ret;
+    int fd;
+
+    if (args->flags)
+        return -EINVAL;
+
+    dmabuf = dma_buf_get(args->fd);
+    if (IS_ERR(dmabuf))
+        return PTR_ERR(dmabuf);
+
+    if (args->offset > dmabuf->size || dmabuf->size - args->offset < TAFI_DATA_BUF_LEN) {
+        ret = -EINVAL;
+        goto err_put;
+    }
+
+    // let the producer finish writing first
+    lret = dma_resv_wait_timeout_rcu(dmabuf->resv, false, true, MAX_SCHEDULE_TIMEOUT);
+    if (lret < 0) {
+        ret = lret;
+        goto err_put;
+    }
+
+    frame = tafi_frame_alloc();
+    if (frame == NULL) {
+        ret = -ENOMEM;
+        goto err_put;
+    }
+
+    ret = dma_buf_begin_cpu_access(dmabuf, DMA_FROM_DEVICE);
+    if (ret)
+        goto err_frame_put;
+    ret = tafi_dmabuf_read(dmabuf, args->offset, frame->data, TAFI_DATA_BUF_LEN);
+    dma_buf_end_cpu_access(dmabuf, DMA_FROM_DEVICE);
+    if (ret)
+        goto err_frame_put;
+    dma_buf_put(dmabuf);
+
+    // everything that can fail is set up before the frame is presented,
+    // which can't be undone
+    fence = kzalloc(sizeof(*fence), GFP_KERNEL);
+    if (fence == NULL) {
+        ret = -ENOMEM;
+        goto err_frame;
+    }
+    // the seqno is the ticket, set once presented; nothing can see the
+    // fence before it is on the list
+    context = present->mode == TAFI_PRESENT_FIFO ? TAFI_FENCE_CONTEXT_QUEUED : TAFI_FENCE_CONTEXT_PUBLISHED;
+    dma_fence_init(&fence->base, &tafi_fence_ops, &tafi_fence_lock, tafi_fence_context + context, 0);
+
+    fd = get_unused_fd_flags(O_CLOEXEC);
+    if (fd < 0) {
+        ret = fd;
+        goto err_fence;
+    }
+
+    sync = sync_file_create(&fence->base);
+    if (sync == NULL) {
+        ret = -ENOMEM;
+        goto err_fd;
+    }
+
+    ret = tafi_present_frame(present, frame, nonblock, &ticket);
+    if (ret)
+        goto err_sync;
+
+    // the list keeps the initial reference until the fence is signalled
+    fence->base.seqno = ticket;
+    tafi_fence_add(fence);
+
+    fd_install(fd, sync->file);
+    args->fence_fd = fd;
+
+    // the thread may have picked the frame up already
+    tafi_dmabuf_signal(tafi_color_data_pickup_count());
+    return 0;
+
+err_sync:
+    fput(sync->file);
+err_fd:
+    put_unused_fd(fd);
+err_fence:
+    dma_fence_put(&fence->base);
+err_frame:
+    tafi_frame_put(frame);
+    return ret;
+
+err_frame_put:
+    tafi_frame_put(frame);
+err_put:
+    dma_buf_put(dmabuf);
+    return ret;
+}
+
+/**
+ * Allocate the native frame ring.
+ */
+int tafi_dmabuf_init(void) {
+    int i;
+
+    tafi_fence_context = dma_fence_context_alloc(TAFI_FENCE_CONTEXTS);
+
+    for (i = 0; i < TAFI_DMABUF_RING_FRAMES; i++) {
+        tafi_dmabuf_ring[i] = vmalloc_user(TAFI_DMABUF_FRAME_SIZE);
+        if (tafi_dmabuf_ring[i] == NULL) {
+            printk(KERN_ERR TAFI_LOG_PREFIX"failed to allocate memory for dma-buf frame ring.");
+            tafi_dmabuf_exit();
+            return -ENOMEM;
+        }
+    }
+    return 0;
+}
+
+/**
+ * Free the ring and signal any fences still pending.
+ * The module cannot be unloaded while exported dma-bufs are alive.
+ */
+void tafi_dmabuf_exit(void) {
+    int i;
+
+    tafi_dmabuf_signal(U64_MAX);
+
+    for (i = 0; i < TAFI_DMABUF_RING_FRAMES; i++) {
+        vfree(tafi_dmabuf_ring[i]);
+        tafi_dmabuf_ring[i] = NULL;
+    }
+}
@@ -0,0 +1,38 @@
+/**
+ *  tafi_dmabuf.h -- The Amazing Fan Idea driver
+ *  DMA-BUF export of the frame buffers and import of external frames.
+ * 
+ *      (C) 2017 Harindu Perera
+ *  
+ *  This file is subject to the terms and conditions of the GNU General Public
+ *  License. See the file COPYING in the main directory of this archive for
+ *  more details.
+ */
+
+#ifndef TAFI_DMABUF
+#define TAFI_DMABUF
+
+#include <linux/dma-buf.h>
+
+#include "tafi_ioctl.h"
+
+struct tafi_presenter;
+
+int tafi_dmabuf_init(void);
+
+void tafi_dmabuf_exit(void);
+
+/**
+ * Wrap vmalloc_user() memory in a new dma-buf.
+ * flush is called after CPU writes through the dma-buf have ended.
+ */
+struct dma_buf *tafi_dmabuf_export_vmalloc(void *vaddr, size_t size, void (*flush)(void *priv), void *priv);
+
+int tafi_dmabuf_export_frame(struct tafi_dmabuf_export *args);
+
+int tafi_dmabuf_queue(struct tafi_dmabuf_queue *args, struct tafi_presenter *present, bool nonblock);
+
+// Signal the fences of all updates picked up so far.
+void tafi_dmabuf_signal(u64 pickups);
+
+#endif
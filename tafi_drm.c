@@ -0,0 +1,371 @@
+/**
+ *  tafi_drm.c -- The Amazing Fan Idea driver
+ *  DRM/KMS display driver, an alternative to the fbdev device.
+ *
+ *  A single simple display pipe with a fixed 80x80 mode. Buffers are GEM
+ *  shmem objects. Only the damaged part of each update is converted to the
+ *  native layout and only the touched sectors are committed. Vblank events
+ *  are driven by the transmit thread, so a page flip completes when the
+ *  frame has actually been sent to the fan.
+ * 
+ *      (C) 2017 Harindu Perera
+ *  
+ *  This file is subject to the terms and conditions of the GNU General Public
+ *  License. See the file COPYING in the main directory of this archive for
+ *  more details.
+ */
+
+#include <linux/dma-buf.h>
+#include <linux/dma-mapping.h>
+#include <linux/module.h>
+#include <linux/platform_device.h>
+#include <linux/spinlock.h>
+
+#include <drm/drm_atomic_helper.h>
+#include <drm/drm_damage_helper.h>
+#include <drm/drm_drv.h>
+#include <drm/drm_fb_helper.h>
+#include <drm/drm_fourcc.h>
+#include <drm/drm_gem_framebuffer_helper.h>
+#include <drm/drm_gem_shmem_helper.h>
+#include <drm/drm_managed.h>
+#include <drm/drm_modeset_helper_vtables.h>
+#include <drm/drm_probe_helper.h>
+#include <drm/drm_simple_kms_helper.h>
+#include <drm/drm_vblank.h>
+
+#include "tafi_common.h"
+#include "tafi_ioctl.h"
+#include "tafi_convert.h"
+#include "tafi_drm.h"
+
+struct tafi_drm {
+    struct drm_device drm;
+    struct drm_simple_display_pipe pipe;
+    struct drm_connector connector;
+    bool vblank_enabled;
+    // Native frame the damage is converted into, and the ranges to commit.
+    unsigned char frame[TAFI_DATA_BUF_LEN];
+    struct tafi_range ranges[TAFI_SECTOR_COUNT];
+};
+
+static struct platform_device *tafi_drm_pdev;
+
+// The registered device, for the vblank hook of the transmit thread.
+static struct tafi_drm *tafi_drm_active;
+static DEFINE_SPINLOCK(tafi_drm_active_lock);
+
+static const u32 tafi_drm_formats[] = {
+    DRM_FORMAT_XRGB8888,
+    DRM_FORMAT_RGB888,
+};
+
+// Byte layouts of the DRM formats, which are little endian.
+static const struct tafi_convert_format tafi_drm_xrgb8888 = {
+    .cpp = 4,
+    .red = 2,
+    .green = 1,
+    .blue = 0,
+};
+
+static const struct tafi_convert_format tafi_drm_rgb888 = {
+    .cpp = 3,
+    .red = 2,
+    .green = 1,
+    .blue = 0,
+};
+
+static const struct drm_display_mode tafi_drm_mode = {
+    DRM_MODE("80x80", DRM_MODE_TYPE_DRIVER, TAFI_DRM_MODE_CLOCK,
+        TAFI_FB_XRES, TAFI_FB_XRES, TAFI_FB_XRES, TAFI_FB_XRES, 0,
+        TAFI_FB_YRES, TAFI_FB_YRES, TAFI_FB_YRES, TAFI_FB_YRES, 0, 0)
+};
+
+static inline struct tafi_drm *to_tafi_drm(struct drm_device *drm) {
+    return container_of(drm, struct tafi_drm, drm);
+}
+
+/**
+ * Convert the damaged rectangle of a framebuffer and commit the sectors it
+ * touched.
+ */
+static void tafi_drm_flush(struct tafi_drm *tdev, struct drm_framebuffer *fb, const struct drm_rect *rect) {
+    struct drm_gem_object *gem = drm_gem_fb_get_obj(fb, 0);
+    struct dma_buf_attachment *import_attach = gem->import_attach;
+    DECLARE_BITMAP(dirty_sectors, TAFI_SECTOR_COUNT);
+    struct tafi_convert_src src;
+    struct tafi_convert_clip clip;
+    unsigned int count;
+    void *vaddr;
+    int idx;
+
+    if (!drm_dev_enter(fb->dev, &idx))
+        return;
+
+    if (import_attach && dma_buf_begin_cpu_access(import_attach->dmabuf, DMA_FROM_DEVICE))
+        goto out_exit;
+
+    vaddr = drm_gem_shmem_vmap(gem);
+    if (IS_ERR_OR_NULL(vaddr))
+        goto out_access;
+
+    src.vaddr = (unsigned char *) vaddr + fb->offsets[0];
+    src.pitch = fb->pitches[0];
+    src.format = fb->format->format == DRM_FORMAT_XRGB8888 ? &tafi_drm_xrgb8888 : &tafi_drm_rgb888;
+
+    clip.x1 = clamp(rect->x1, 0, TAFI_FB_XRES);
+    clip.y1 = clamp(rect->y1, 0, TAFI_FB_YRES);
+    clip.x2 = clamp(rect->x2, 0, TAFI_FB_XRES);
+    clip.y2 = clamp(rect->y2, 0, TAFI_FB_YRES);
+
+    bitmap_zero(dirty_sectors, TAFI_SECTOR_COUNT);
+    if (tafi_convert_rect(&src, &clip, tdev->frame, dirty_sectors)) {
+        count = tafi_convert_sectors_to_ranges(dirty_sectors, tdev->ranges);
+        tafi_set_color_ranges(tdev->frame, tdev->ranges, count, NULL);
+    }
+
+    drm_gem_shmem_vunmap(gem, vaddr);
+out_access:
+    if (import_attach)
+        dma_buf_end_cpu_access(import_attach->dmabuf, DMA_FROM_DEVICE);
+out_exit:
+    drm_dev_exit(idx);
+}
+
+// Display pipe
+
+static enum drm_mode_status tafi_drm_pipe_mode_valid(struct drm_simple_display_pipe *pipe, const struct drm_display_mode *mode) {
+    if (mode->hdisplay != TAFI_FB_XRES || mode->vdisplay != TAFI_FB_YRES)
+        return MODE_BAD;
+    return MODE_OK;
+}
+
+static void tafi_drm_pipe_enable(struct drm_simple_display_pipe *pipe, struct drm_crtc_state *crtc_state, struct drm_plane_state *plane_state) {
+    struct tafi_drm *tdev = to_tafi_drm(pipe->crtc.dev);
+    struct drm_framebuffer *fb = plane_state->fb;
+    struct drm_rect rect;
+
+    drm_crtc_vblank_on(&pipe->crtc);
+
+    if (fb) {
+        drm_rect_init(&rect, 0, 0, fb->width, fb->height);
+        tafi_drm_flush(tdev, fb, &rect);
+    }
+}
+
+/**
+ * Blank the display when the pipe is turned off.
+ */
+static void tafi_drm_pipe_disable(struct drm_simple_display_pipe *pipe) {
+    struct tafi_drm *tdev = to_tafi_drm(pipe->crtc.dev);
+    struct tafi_range range = { .offset = 0, .len = TAFI_DATA_BUF_LEN };
+
+    drm_crtc_vblank_off(&pipe->crtc);
+
+    memset(tdev->frame, 0x80, TAFI_DATA_BUF_LEN);
+    tafi_set_color_ranges(tdev->frame, &range, 1, NULL);
+}
+
+static void tafi_drm_pipe_update(struct drm_simple_display_pipe *pipe, struct drm_plane_state *old_state) {
+    struct tafi_drm *tdev = to_tafi_drm(pipe->crtc.dev);
+    struct drm_plane_state *state = pipe->plane.state;
+    struct drm_crtc *crtc = &pipe->crtc;
+    struct drm_pending_vblank_event *event;
+    struct drm_rect rect;
+
+    if (state->fb && crtc->state->active && drm_atomic_helper_damage_merged(old_state, state, &rect))
+        tafi_drm_flush(tdev, state->fb, &rect);
+
+    // completes on the next frame the thread transmits
+    event = crtc->state->event;
+    if (event) {
+        crtc->state->event = NULL;
+        spin_lock_irq(&crtc->dev->event_lock);
+        if (drm_crtc_vblank_get(crtc) == 0)
+            drm_crtc_arm_vblank_event(crtc, event);
+        else
+            drm_crtc_send_vblank_event(crtc, event);
+        spin_unlock_irq(&crtc->dev->event_lock);
+    }
+}
+
+static int tafi_drm_pipe_enable_vblank(struct drm_simple_display_pipe *pipe) {
+    struct tafi_drm *tdev = to_tafi_drm(pipe->crtc.dev);
+
+    WRITE_ONCE(tdev->vblank_enabled, true);
+    return 0;
+}
+
+static void tafi_drm_pipe_disable_vblank(struct drm_simple_display_pipe *pipe) {
+    struct tafi_drm *tdev = to_tafi_drm(pipe->crtc.dev);
+
+    WRITE_ONCE(tdev->vblank_enabled, false);
+}
+
+static const struct drm_simple_display_pipe_funcs tafi_drm_pipe_funcs = {
+    .mode_valid = tafi_drm_pipe_mode_valid,
+    .enable = tafi_drm_pipe_enable,
+    .disable = tafi_drm_pipe_disable,
+    .update = tafi_drm_pipe_update,
+    .prepare_fb = drm_gem_fb_simple_display_pipe_prepare_fb,
+    .enable_vblank = tafi_drm_pipe_enable_vblank,
+    .disable_vblank = tafi_drm_pipe_disable_vblank,
+};
+
+void tafi_drm_handle_vblank(void) {
+    unsigned long flags;
+
+    spin_lock_irqsave(&tafi_drm_active_lock, flags);
+    if (tafi_drm_active && READ_ONCE(tafi_drm_active->vblank_enabled))
+        drm_crtc_handle_vblank(&tafi_drm_active->pipe.crtc);
+    spin_unlock_irqrestore(&tafi_drm_active_lock, flags);
+}
+
+// Connector
+
+static int tafi_drm_connector_get_modes(struct drm_connector *connector) {
+    struct drm_display_mode *mode;
+
+    mode = drm_mode_duplicate(connector->dev, &tafi_drm_mode);
+    if (!mode)
+        return 0;
+
+    mode->type |= DRM_MODE_TYPE_PREFERRED;
+    drm_mode_set_name(mode);
+    drm_mode_probed_add(connector, mode);
+    return 1;
+}
+
+static const struct drm_connector_helper_funcs tafi_drm_connector_helper_funcs = {
+    .get_modes = tafi_drm_connector_get_modes,
+};
+
+static const struct drm_connector_funcs tafi_drm_connector_funcs = {
+    .reset = drm_atomic_helper_connector_reset,
+    .fill_modes = drm_helper_probe_single_connector_modes,
+    .destroy = drm_connector_cleanup,
+    .atomic_duplicate_state = drm_atomic_helper_connector_duplicate_state,
+    .atomic_destroy_state = drm_atomic_helper_connector_destroy_state,
+};
+
+// Device
+
+static const struct drm_mode_config_funcs tafi_drm_mode_config_funcs = {
+    .fb_create = drm_gem_fb_create_with_dirty,
+    .atomic_check = drm_atomic_helper_check,
+    .atomic_commit = drm_atomic_helper_commit,
+};
+
+DEFINE_DRM_GEM_FOPS(tafi_drm_fops);
+
+static struct drm_driver tafi_drm_driver = {
+    .driver_features = DRIVER_MODESET | DRIVER_GEM | DRIVER_ATOMIC,
+    .fops = &tafi_drm_fops,
+    DRM_GEM_SHMEM_DRIVER_OPS,
+    .name = TAFI_DRM_DRIVER_NAME,
+    .desc = TAFI_DRM_DRIVER_DESC,
+    .date = TAFI_DRM_DRIVER_DATE,
+    .major = TAFI_DRM_DRIVER_MAJOR,
+    .minor = TAFI_DRM_DRIVER_MINOR,
+};
+
+static int tafi_drm_probe(struct platform_device *pdev) {
+    struct tafi_drm *tdev;
+    struct drm_device *drm;
+    int ret;
+
+    tdev = devm_drm_dev_alloc(&pdev->dev, &tafi_drm_driver, struct tafi_drm, drm);
+    if (IS_ERR(tdev))
+        return PTR_ERR(tdev);
+    drm = &tdev->drm;
+
+    // needed to attach to imported dma-bufs
+    ret = dma_coerce_mask_and_coherent(drm->dev, DMA_BIT_MASK(64));
+    if (ret)
+        return ret;
+
+    ret = drmm_mode_config_init(drm);
+    if (ret)
+        return ret;
+
+    drm->mode_config.min_width = TAFI_FB_XRES;
+    drm->mode_config.max_width = TAFI_FB_XRES;
+    drm->mode_config.min_height = TAFI_FB_YRES;
+    drm->mode_config.max_height = TAFI_FB_YRES;
+    drm->mode_config.preferred_depth = 24;
+    drm->mode_config.funcs = &tafi_drm_mode_config_funcs;
+
+    ret = drm_connector_init(drm, &tdev->connector, &tafi_drm_connector_funcs, DRM_MODE_CONNECTOR_SPI);
+    if (ret)
+        return ret;
+    drm_connector_helper_add(&tdev->connector, &tafi_drm_connector_helper_funcs);
+
+    ret = drm_simple_display_pipe_init(drm, &tdev->pipe, &tafi_drm_pipe_funcs,
+        tafi_drm_formats, ARRAY_SIZE(tafi_drm_formats), NULL, &tdev->connector);
+    if (ret)
+        return ret;
+
+    drm_plane_enable_fb_damage_clips(&tdev->pipe.plane);
+
+    ret = drm_vblank_init(drm, 1);
+    if (ret)
+        return ret;
+
+    drm_mode_config_reset(drm);
+    platform_set_drvdata(pdev, drm);
+
+    ret = drm_dev_register(drm, 0);
+    if (ret)
+        return ret;
+
+    spin_lock_irq(&tafi_drm_active_lock);
+    tafi_drm_active = tdev;
+    spin_unlock_irq(&tafi_drm_active_lock);
+
+    // keep /dev/fbN around for legacy clients
+    drm_fbdev_generic_setup(drm, 24);
+
+    printk(KERN_INFO TAFI_LOG_PREFIX"DRM device registered.");
+    return 0;
+}
+
+static int tafi_drm_remove(struct platform_device *pdev) {
+    struct drm_device *drm = platform_get_drvdata(pdev);
+
+    spin_lock_irq(&tafi_drm_active_lock);
+    tafi_drm_active = NULL;
+    spin_unlock_irq(&tafi_drm_active_lock);
+
+    drm_dev_unplug(drm);
+    drm_atomic_helper_shutdown(drm);
+    return 0;
+}
+
+static struct platform_driver tafi_drm_platform_driver = {
+    .probe = tafi_drm_probe,
+    .remove = tafi_drm_remove,
+    .driver = {
+        .name = TAFI_DRM_DRIVER_NAME,
+    },
+};
+
+int tafi_drm_init(void) {
+    int ret;
+
+    ret = platform_driver_register(&tafi_drm_platform_driver);
+    if (ret)
+        return ret;
+
+    tafi_drm_pdev = platform_device_register_simple(TAFI_DRM_DRIVER_NAME, -1, NULL, 0);
+    if (IS_ERR(tafi_drm_pdev)) {
+        platform_driver_unregister(&tafi_drm_platform_driver);
+        return PTR_ERR(tafi_drm_pdev);
+    }
+
+    return 0;
+}
+
+void tafi_drm_exit(void) {
+    platform_device_unregister(tafi_drm_pdev);
+    platform_driver_unregister(&tafi_drm_platform_driver);
+}
@@ -0,0 +1,32 @@
+/**
+ *  tafi_drm.h -- The Amazing Fan Idea driver
+ *  DRM/KMS display driver, an alternative to the fbdev device.
+ * 
+ *      (C) 2017 Harindu Perera
+ *  
+ *  This file is subject to the terms and conditions of the GNU General Public
+ *  License. See the file COPYING in the main directory of this archive for
+ *  more details.
+ */
+
+#ifndef TAFI_DRM_HDR
+#define TAFI_DRM_HDR
+
+#define TAFI_DRM_DRIVER_NAME "tafi_drm"
+#define TAFI_DRM_DRIVER_DESC "The Amazing Fan Idea PoV display"
+#define TAFI_DRM_DRIVER_DATE "20170601"
+#define TAFI_DRM_DRIVER_MAJOR 1
+#define TAFI_DRM_DRIVER_MINOR 0
+
+// Pixel clock of the fixed 80x80 mode in kHz, chosen so that the mode
+// refreshes at the ~10.8 Hz the fan actually spins at.
+#define TAFI_DRM_MODE_CLOCK 69
+
+int tafi_drm_init(void);
+
+void tafi_drm_exit(void);
+
+// Called by the transmit thread after every frame, drives vblank events.
+void tafi_drm_handle_vblank(void);
+
+#endif
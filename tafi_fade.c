@@ -0,0 +1,118 @@
+/**
+ *  tafi_fade.c -- The Amazing Fan Idea driver
+ *  Crossfades between frames, blended by the transmit thread.
+ *
+ *  A frame published with a fade of N is not cut to but blended in over
+ *  its first N transmissions, from whatever was sent just before it, a
+ *  fade cut short included. The blend runs on native frames, after
+ *  conversion and before transforms, as a fixed point weighted average of
+ *  every wire byte: the top bit set on both sides stays set, and the 7 bit
+ *  levels move linearly, so no step needs converting again. Whatever the
+ *  thread sends is kept as the start of the next fade.
+ *
+ *      (C) 2017 Harindu Perera
+ *
+ *  This file is subject to the terms and conditions of the GNU General Public
+ *  License. See the file COPYING in the main directory of this archive for
+ *  more details.
+ */
+
+#include <linux/kernel.h>
+#include <linux/ktime.h>
+#include <linux/slab.h>
+#include <linux/string.h>
+
+#include "tafi_common.h"
+#include "tafi_stats.h"
+#include "tafi_wire.h"
+#include "tafi_fade.h"
+
+// Blend weights are in 1/256.
+#define TAFI_FADE_WEIGHT_SHIFT 8
+
+// Content the running fade starts from, and the last content sent. Both
+// only used by the thread, swapped when a fade starts.
+static unsigned char *tafi_fade_from;
+static unsigned char *tafi_fade_last;
+
+// Frame the fade state belongs to, referenced so it is never mistaken for
+// a new one at the same address.
+static struct tafi_frame *tafi_fade_frame;
+static unsigned int tafi_fade_step;
+static unsigned int tafi_fade_steps;
+
+static TAFI_HIST(tafi_fade_blend_time, "fade_blend");
+
+/**
+ * Whether the frame on display is still fading in, so it differs on every
+ * transmission.
+ */
+bool tafi_fade_active(void) {
+    return tafi_fade_step < tafi_fade_steps;
+}
+
+/**
+ * Blend buf, the native content of frame, into dst, TAFI_DATA_BUF_LEN
+ * bytes that may be buf itself, while frame fades in. A frame seen for the
+ * first time starts its fade, if it has one.
+ * Returns what to send, buf or dst.
+ */
+const unsigned char *tafi_fade_apply(struct tafi_frame *frame, const unsigned char *buf, unsigned char *dst) {
+    unsigned int weight;
+    unsigned int i;
+    ktime_t start;
+
+    if (frame != tafi_fade_frame) {
+        tafi_frame_put(tafi_fade_frame);
+        kref_get(&frame->ref);
+        tafi_fade_frame = frame;
+        tafi_fade_step = 0;
+        tafi_fade_steps = frame->fade;
+        if (tafi_fade_steps)
+            swap(tafi_fade_from, tafi_fade_last);
+    }
+
+    if (!tafi_fade_active())
+        return buf;
+
+    start = ktime_get();
+    tafi_fade_step++;
+    weight = (tafi_fade_step << TAFI_FADE_WEIGHT_SHIFT) / tafi_fade_steps;
+    for (i = 0; i < TAFI_DATA_BUF_LEN; i++)
+        dst[i] = (tafi_fade_from[i] * ((1 << TAFI_FADE_WEIGHT_SHIFT) - weight) + buf[i] * weight)
+            >> TAFI_FADE_WEIGHT_SHIFT;
+    tafi_hist_add(&tafi_fade_blend_time, ktime_to_ns(ktime_sub(ktime_get(), start)));
+    return dst;
+}
+
+/**
+ * Remember a native frame the thread has sent, before transforms, as the
+ * start of the next fade.
+ */
+void tafi_fade_sent(const unsigned char *buf) {
+    memcpy(tafi_fade_last, buf, TAFI_DATA_BUF_LEN);
+}
+
+int tafi_fade_init(void) {
+    tafi_fade_from = kmalloc(TAFI_DATA_BUF_LEN, GFP_KERNEL);
+    tafi_fade_last = kmalloc(TAFI_DATA_BUF_LEN, GFP_KERNEL);
+    if (tafi_fade_from == NULL || tafi_fade_last == NULL) {
+        kfree(tafi_fade_from);
+        kfree(tafi_fade_last);
+        return -ENOMEM;
+    }
+    memset(tafi_fade_last, TAFI_WIRE_OFF, TAFI_DATA_BUF_LEN);
+
+    tafi_stats_register_hist(&tafi_fade_blend_time);
+    return 0;
+}
+
+/**
+ * Must be called after the thread has stopped.
+ */
+void tafi_fade_exit(void) {
+    tafi_frame_put(tafi_fade_frame);
+    tafi_fade_frame = NULL;
+    kfree(tafi_fade_from);
+    kfree(tafi_fade_last);
+}
@@ -0,0 +1,29 @@
+/**
+ *  tafi_fade.h -- The Amazing Fan Idea driver
+ *  Crossfades between frames, blended by the transmit thread.
+ *
+ *      (C) 2017 Harindu Perera
+ *
+ *  This file is subject to the terms and conditions of the GNU General Public
+ *  License. See the file COPYING in the main directory of this archive for
+ *  more details.
+ */
+
+#ifndef TAFI_FADE_HDR
+#define TAFI_FADE_HDR
+
+#include <linux/types.h>
+
+#include "tafi_ioctl.h"
+
+int tafi_fade_init(void);
+
+void tafi_fade_exit(void);
+
+bool tafi_fade_active(void);
+
+const unsigned char *tafi_fade_apply(struct tafi_frame *frame, const unsigned char *buf, unsigned char *dst);
+
+void tafi_fade_sent(const unsigned char *buf);
+
+#endif
@@ -18,6 +18,7 @@
  */
 
 #include <linux/kernel.h>
+#include <linux/module.h>
 #include <linux/errno.h>
 #include <linux/string.h>
 #include <linux/mm.h>
@@ -25,13 +26,17 @@
 #include <linux/slab.h>
 #include <linux/delay.h>
 #include <linux/interrupt.h>
+#include <linux/ktime.h>
 #include <linux/platform_device.h>
 #include <asm/page.h>
 
 #include "tafi_ioctl.h"
 #include "tafi_fb.h"
-#include "tafi_fb_lut.h"
+#include "tafi_convert.h"
 #include "tafi_common.h"
+#include "tafi_dmabuf.h"
+#include "tafi_palette.h"
+#include "tafi_stats.h"
     /*
      *  RAM we reserve for the frame buffer. This defines the maximum screen
      *  size
@@ -41,14 +46,37 @@
 
 #define VIDEOMEMSIZE	(20*1024)	/* 12 KB */
 
-static void *videomemory;
 static u_long videomemorysize = VIDEOMEMSIZE;
 
-static unsigned char shadow_mem[VIDEOMEMSIZE];
+static bool polar_fb;
+module_param(polar_fb, bool, 0444);
+MODULE_PARM_DESC(polar_fb, "Also register a framebuffer in native polar layout");
 
-static unsigned char square_buf[TAFI_FB_XRES][TAFI_FB_YRES][3];
+static bool pipeline;
+module_param(pipeline, bool, 0444);
+MODULE_PARM_DESC(pipeline, "Convert framebuffer updates piecewise on the transmit thread");
 
-static struct platform_device *tafi_fb_device;
+static bool angular_interleave;
+module_param(angular_interleave, bool, 0644);
+MODULE_PARM_DESC(angular_interleave, "Sample the Cartesian framebuffer half a sector later on odd revolutions");
+
+static TAFI_HIST(tafi_fb_convert_even, "fb_convert_even");
+static TAFI_HIST(tafi_fb_convert_odd, "fb_convert_odd");
+
+/*
+ *  Per device state. Device 0 is the Cartesian framebuffer, device 1 the
+ *  optional polar one.
+ */
+struct tafi_fb_par {
+	struct fb_info *info;
+	void *videomemory;
+	bool polar;
+	struct tafi_pipeline_source pipeline;
+	struct fb_deferred_io defio;
+	u32 pseudo_palette[16];
+};
+
+static struct platform_device *tafi_fb_device[TAFI_FB_DEVICE_COUNT];
 
 static const struct fb_videomode tafi_fb_default = {
 	.xres =		TAFI_FB_XRES,
@@ -89,6 +117,20 @@ static struct fb_var_screeninfo tafi_fb_var = {
 	},
 };
 
+/*
+ *  The polar mode has one line per sector and one pixel per LED, which is
+ *  exactly the layout of the data on the wire.
+ */
+static const struct fb_videomode tafi_fb_polar_default = {
+	.xres =		TAFI_FB_POLAR_XRES,
+	.yres =		TAFI_FB_POLAR_YRES,
+	.left_margin =	0,
+	.right_margin =	0,
+	.upper_margin =	0,
+	.lower_margin =	0,
+	.vmode =	FB_VMODE_NONINTERLACED,
+};
+
 static struct fb_fix_screeninfo tafi_fb_fix = {
 	.id =		"TAFIFBDEVICE",
 	.type =		FB_TYPE_PACKED_PIXELS,
@@ -103,30 +145,28 @@ static int tafi_fb_write(struct fb_info *info, const char __user *buf, size_t co
 static int tafi_fb_check_var(struct fb_var_screeninfo *var, struct fb_info *info);
 static int tafi_fb_set_par(struct fb_info *info);
 static int tafi_fb_setcolreg(u_int regno, u_int red, u_int green, u_int blue, u_int transp, struct fb_info *info);
+static int tafi_fb_setcmap(struct fb_cmap *cmap, struct fb_info *info);
 static int tafi_fb_pan_display(struct fb_var_screeninfo *var, struct fb_info *info);
 static int tafi_fb_mmap(struct fb_info *info, struct vm_area_struct *vma);
-
-static void tafi_fb_copy_to_device(void);
+static int tafi_fb_ioctl(struct fb_info *info, unsigned int cmd, unsigned long arg);
 
 static struct fb_ops tafi_fb_ops = {
 	.fb_read        = fb_sys_read,
 	.fb_write       = tafi_fb_write,
-//	.fb_check_var	= tafi_fb_check_var,
+	.fb_check_var	= tafi_fb_check_var,
 	.fb_set_par	= tafi_fb_set_par,
 	.fb_setcolreg	= tafi_fb_setcolreg,
+	.fb_setcmap	= tafi_fb_setcmap,
 	.fb_pan_display	= tafi_fb_pan_display,
 	.fb_fillrect	= sys_fillrect,
 	.fb_copyarea	= sys_copyarea,
 	.fb_imageblit	= sys_imageblit,
 	.fb_mmap	= tafi_fb_mmap,
+	.fb_ioctl	= tafi_fb_ioctl,
 };
 
 static void tafi_fb_deferred_io(struct fb_info *info, struct list_head *pagelist);
-
-static struct fb_deferred_io tafi_fb_defio = {
-	.delay		= HZ,
-	.deferred_io	= tafi_fb_deferred_io,
-};
+static void tafi_fb_update(struct fb_info *info);
 
 /*
  *  Internal routines
@@ -149,74 +189,65 @@ static u_long get_line_length(int xres_virtual, int bpp) {
      *  data from it to check this var. 
      */
 
-// static int tafi_fb_check_var(struct fb_var_screeninfo *var, struct fb_info *info) {
-// 	u_long line_length;
-
-// 	/*
-// 	 *  FB_VMODE_CONUPDATE and FB_VMODE_SMOOTH_XPAN are equal!
-// 	 *  as FB_VMODE_SMOOTH_XPAN is only used internally
-// 	 */
-
-// 	if (var->vmode & FB_VMODE_CONUPDATE) {
-// 		var->vmode |= FB_VMODE_YWRAP;
-// 		var->xoffset = info->var.xoffset;
-// 		var->yoffset = info->var.yoffset;
-// 	}
-
-// 	/*
-// 	 *  Some very basic checks
-// 	 */
-// 	if (var->xres != 80)
-// 		var->xres = 80;
-// 	if (var->yres != 80)
-// 		var->yres = 80;
-// 	if (var->xres > var->xres_virtual)
-// 		var->xres_virtual = var->xres;
-// 	if (var->yres > var->yres_virtual)
-// 		var->yres_virtual = var->yres;
-	
-// 	if (var->bits_per_pixel != 24) 
-// 		return -EINVAL;
-
-// 	if (var->xres_virtual < var->xoffset + var->xres)
-// 		var->xres_virtual = var->xoffset + var->xres;
-// 	if (var->yres_virtual < var->yoffset + var->yres)
-// 		var->yres_virtual = var->yoffset + var->yres;
-
-// 	/*
-// 	 *  Memory limit
-// 	 */
-// 	line_length =
-// 	    get_line_length(var->xres_virtual, var->bits_per_pixel);
-// 	if (line_length * var->yres_virtual > videomemorysize)
-// 		return -ENOMEM;
-
-// 	// RGB 888
-// 	var->red.offset = 8;
-// 	var->red.length = 8;
-// 	var->green.offset = 0;
-// 	var->green.length = 8;
-// 	var->blue.offset = 16;
-// 	var->blue.length = 8;
-// 	// No transparency
-// 	var->transp.offset = 0;
-// 	var->transp.length = 0;
-
-// 	var->red.msb_right = 0;
-// 	var->green.msb_right = 0;
-// 	var->blue.msb_right = 0;
-// 	var->transp.msb_right = 0;
-
-// 	return 0;
-// }
+static int tafi_fb_check_var(struct fb_var_screeninfo *var, struct fb_info *info) {
+	u_long line_length;
+
+	/*
+	 *  The geometry is fixed by the blade, only the depth can change:
+	 *  24 bpp truecolor, or 8 bpp pseudocolor through the palette.
+	 */
+	var->xres = var->xres_virtual = info->mode->xres;
+	var->yres = var->yres_virtual = info->mode->yres;
+	var->xoffset = 0;
+	var->yoffset = 0;
+
+	if (var->bits_per_pixel <= 8)
+		var->bits_per_pixel = 8;
+	else
+		var->bits_per_pixel = TAFI_FB_BPP;
+
+	/*
+	 *  Memory limit
+	 */
+	line_length = get_line_length(var->xres_virtual, var->bits_per_pixel);
+	if (line_length * var->yres_virtual > videomemorysize)
+		return -ENOMEM;
+
+	if (var->bits_per_pixel == 8) {
+		var->red.offset = 0;
+		var->green.offset = 0;
+		var->blue.offset = 0;
+	} else {
+		// RGB 888
+		var->red.offset = 0;
+		var->green.offset = 8;
+		var->blue.offset = 16;
+	}
+	var->red.length = 8;
+	var->green.length = 8;
+	var->blue.length = 8;
+	// No transparency
+	var->transp.offset = 0;
+	var->transp.length = 0;
+
+	var->red.msb_right = 0;
+	var->green.msb_right = 0;
+	var->blue.msb_right = 0;
+	var->transp.msb_right = 0;
+
+	return 0;
+}
 
 /* This routine actually sets the video mode. It's in here where we
  * the hardware state info->par and fix which can be affected by the 
  * change in par. For this driver it doesn't do much. 
  */
 static int tafi_fb_set_par(struct fb_info *info) {
+	info->fix.visual = info->var.bits_per_pixel == 8 ?
+		FB_VISUAL_PSEUDOCOLOR : FB_VISUAL_TRUECOLOR;
 	info->fix.line_length = get_line_length(info->var.xres_virtual,
 						info->var.bits_per_pixel);
+	tafi_fb_update(info);
 	return 0;
 }
 
@@ -226,7 +257,19 @@ static int tafi_fb_set_par(struct fb_info *info) {
  *  entries in the var structure). Return != 0 for invalid regno.
 */
 static int tafi_fb_setcolreg(u_int regno, u_int red, u_int green, u_int blue, u_int transp, struct fb_info *info) {
-	
+	u8 entry[1][3];
+
+	/* the display's palette, applied from the next frame on */
+	if (info->fix.visual == FB_VISUAL_PSEUDOCOLOR) {
+		if (regno >= TAFI_PALETTE_SIZE)
+			return 1;
+		entry[0][0] = red >> 8;
+		entry[0][1] = green >> 8;
+		entry[0][2] = blue >> 8;
+		tafi_palette_set((const u8 (*)[3]) entry, regno, 1);
+		return 0;
+	}
+
 	if (regno >= 16)	/* no. of hw registers */
 		return 1;
 
@@ -249,6 +292,38 @@ static int tafi_fb_setcolreg(u_int regno, u_int red, u_int green, u_int blue, u_
 	return 0;
 }
 
+/*
+ *  Load a whole colour map at once, so a palette animation step never
+ *  shows up half applied.
+ */
+static int tafi_fb_setcmap(struct fb_cmap *cmap, struct fb_info *info) {
+	u8 (*entries)[3];
+	u_int i;
+
+	if (info->fix.visual != FB_VISUAL_PSEUDOCOLOR) {
+		for (i = 0; i < cmap->len; i++)
+			if (tafi_fb_setcolreg(cmap->start + i, cmap->red[i], cmap->green[i],
+					      cmap->blue[i], 0, info))
+				return -EINVAL;
+		return 0;
+	}
+
+	if (cmap->start >= TAFI_PALETTE_SIZE || cmap->len > TAFI_PALETTE_SIZE - cmap->start)
+		return -EINVAL;
+
+	entries = kmalloc_array(cmap->len, sizeof(*entries), GFP_KERNEL);
+	if (!entries)
+		return -ENOMEM;
+	for (i = 0; i < cmap->len; i++) {
+		entries[i][0] = cmap->red[i] >> 8;
+		entries[i][1] = cmap->green[i] >> 8;
+		entries[i][2] = cmap->blue[i] >> 8;
+	}
+	tafi_palette_set((const u8 (*)[3]) entries, cmap->start, cmap->len);
+	kfree(entries);
+	return 0;
+}
+
 static int tafi_fb_pan_display(struct fb_var_screeninfo *var, struct fb_info *info) {
 	if (var->vmode & FB_VMODE_YWRAP) {
 		if (var->yoffset >= info->var.yres_virtual ||
@@ -268,68 +343,114 @@ static int tafi_fb_pan_display(struct fb_var_screeninfo *var, struct fb_info *in
 	return 0;
 }
 
-static void tafi_fb_copy_to_device(void) {
-	void *data;
-	unsigned int p;
-	unsigned int x;
-	unsigned int y;
-	unsigned int s;
-	unsigned int l;
-	unsigned int i;
+/*
+ * Called by the transmit thread for each piece of a pipelined update.
+ */
+static void tafi_fb_pipeline_convert(struct tafi_pipeline_source *source, unsigned int first,
+	unsigned int count, unsigned char *dst) {
+
+	struct tafi_fb_par *par = container_of(source, struct tafi_fb_par, pipeline);
+	struct tafi_convert_src src = {
+		.vaddr = par->videomemory,
+		.pitch = par->info->fix.line_length,
+		.format = &tafi_convert_rgb888,
+	};
+
+	if (par->polar)
+		tafi_convert_polar_sectors(src.vaddr, src.pitch, src.format, first, count, dst);
+	else
+		tafi_convert_rect_sectors(&src, first, count, dst);
+}
 
-	printk(KERN_INFO TAFI_LOG_PREFIX"copy data.");
+/*
+ *  Whether updates get a second frame for the odd revolutions, sampled
+ *  half a sector later. Polar pixels already are the sectors, there is
+ *  nothing in between to sample.
+ */
+static bool tafi_fb_interleaved(struct tafi_fb_par *par) {
+	return !par->polar && READ_ONCE(angular_interleave);
+}
 
-	data = kmalloc(TAFI_DATA_BUF_LEN, GFP_KERNEL);
-	if (data == NULL) {
-		printk(KERN_INFO TAFI_LOG_PREFIX"cannot reserve memory for FB ioctl");
-		return;
+/*
+ *  Convert the video memory into frame, sampled half a sector later if
+ *  half is set, and account the time to that phase.
+ */
+static void tafi_fb_convert(struct fb_info *info, bool half, struct tafi_frame *frame) {
+	struct tafi_fb_par *par = info->par;
+	struct tafi_convert_src src = {
+		.vaddr = par->videomemory,
+		.pitch = info->fix.line_length,
+		.format = &tafi_convert_rgb888,
+	};
+	ktime_t start = ktime_get();
+
+	/* 8 bpp pixels stay palette indices until the thread sends them */
+	if (info->var.bits_per_pixel == 8) {
+		frame->indexed = true;
+		if (par->polar)
+			tafi_convert_polar_indexed(src.vaddr, src.pitch, frame->data);
+		else if (half)
+			tafi_convert_rect_indexed_half(src.vaddr, src.pitch, frame->data);
+		else
+			tafi_convert_rect_indexed(src.vaddr, src.pitch, frame->data);
 	}
+	/* polar pixels only need brightness correction on their way to the wire */
+	else if (par->polar)
+		tafi_convert_polar(src.vaddr, src.pitch, src.format, frame->data);
+	else if (half)
+		tafi_convert_rect_half(&src, frame->data);
+	else
+		tafi_convert_rect(&src, NULL, frame->data, NULL);
 
-	memcpy(square_buf, shadow_mem, TAFI_FB_XRES * TAFI_FB_YRES * 3);
+	tafi_hist_add(half ? &tafi_fb_convert_odd : &tafi_fb_convert_even,
+		ktime_to_ns(ktime_sub(ktime_get(), start)));
+}
 
-	for (s = 0; s < TAFI_SECTOR_COUNT; s++) {
-		for (l = 0; l < TAFI_SECTOR_LED_COUNT; l++) {
-			x = TAFI_FB_DEV_LUT[s][l][0];
-			y = TAFI_FB_DEV_LUT[s][l][1];
-			for (i = 0; i < TAFI_LED_COLOR_FIELD_COUNT; i++) {
-				p = s * TAFI_SECTOR_LED_COUNT * TAFI_LED_COLOR_FIELD_COUNT + l * TAFI_LED_COLOR_FIELD_COUNT + i;
-				*((unsigned char *)(data+p)) = (TAFI_FB_LED_BRIGHTNESS_LUT[square_buf[x][y][(i+2)%3]][l] >> 1) | 0x80;
-			}
-		}
+/*
+ *  Push the contents of the video memory to the display. The pixels are
+ *  read straight from the video memory and converted into a new frame,
+ *  which is handed to the transmit thread without being copied again.
+ */
+static void tafi_fb_update(struct fb_info *info) {
+	struct tafi_fb_par *par = info->par;
+	bool interleaved = tafi_fb_interleaved(par);
+	struct tafi_frame *frame;
+
+	/*
+	 *  The thread converts the first sectors just before sending them, in
+	 *  one phase only, so interleaved updates are converted here.
+	 */
+	if (pipeline && info->var.bits_per_pixel != 8 && !interleaved) {
+		tafi_pipeline_submit(&par->pipeline);
+		return;
 	}
 
-	printk(KERN_INFO TAFI_LOG_PREFIX"copy data 2.");
-	tafi_set_color_data(data, TAFI_DATA_BUF_LEN, (loff_t *) 0);
-	printk(KERN_INFO TAFI_LOG_PREFIX"copy data 3.");
-	kfree(data);
-}
+	frame = tafi_frame_alloc();
+	if (frame == NULL) {
+		printk(KERN_INFO TAFI_LOG_PREFIX"cannot reserve memory for FB update");
+		return;
+	}
+	tafi_fb_convert(info, false, frame);
 
-static void tafi_fb_copy_to_shadow(const unsigned char *vfb_mem, uint32_t byte_offset, uint32_t byte_width) {
-	unsigned char *addr0 = (unsigned char *)(vfb_mem + byte_offset);
-	unsigned char *addr1 = (unsigned char *)(shadow_mem + byte_offset);
-	int j = byte_width;
-	uint32_t k; 
-	while (j--) {
-		*(addr1 + j) = *(addr0 + j);
+	/* without memory for the odd phase every revolution shows the even one */
+	if (interleaved) {
+		frame->phase = tafi_frame_alloc();
+		if (frame->phase)
+			tafi_fb_convert(info, true, frame->phase);
 	}
+
+	tafi_publish_frame(frame);
 }
 
 static void tafi_fb_deferred_io(struct fb_info *info, struct list_head *pagelist) {
 	printk(KERN_INFO TAFI_LOG_PREFIX"defio triggered");
-	struct page *cur;
-	struct fb_deferred_io *fbdefio = info->fbdefio;
-	// list_for_each_entry(cur, &fbdefio->pagelist, lru) {
-	// 	tafi_fb_copy_to_shadow((unsigned char *) info->fix.smem_start, cur->index << PAGE_SHIFT, PAGE_SIZE);
-	// }
-	tafi_fb_copy_to_shadow((unsigned char *) info->fix.smem_start, 0, TAFI_FB_XRES*TAFI_FB_YRES*3);
-	tafi_fb_copy_to_device();
+	tafi_fb_update(info);
 }
 
 static ssize_t tafi_fb_write(struct fb_info *info, const char __user *buf, size_t count, loff_t *ppos) {
 	ssize_t ret;
 	ret = fb_sys_write(info, buf, count, ppos);
-	tafi_fb_copy_to_shadow((unsigned char *) info->fix.smem_start, 0, TAFI_FB_XRES*TAFI_FB_YRES*3);
-	tafi_fb_copy_to_device();
+	tafi_fb_update(info);
 	return ret;
 }
 
@@ -340,12 +461,54 @@ static int tafi_fb_mmap(struct fb_info *info, struct vm_area_struct *vma) {
 	return remap_vmalloc_range(vma, (void *)info->fix.smem_start, vma->vm_pgoff);
 }
 
+/*
+ *  Called when CPU writes through an exported dma-buf have ended.
+ */
+static void tafi_fb_dmabuf_flush(void *priv) {
+	tafi_fb_update(priv);
+}
+
+static int tafi_fb_ioctl(struct fb_info *info, unsigned int cmd, unsigned long arg) {
+	void __user *argp = (void __user *) arg;
+	struct tafi_fb_par *par = info->par;
+	struct tafi_dmabuf_export args;
+	struct dma_buf *dmabuf;
+	int fd;
+
+	switch (cmd) {
+	case TAFI_FBIO_DMABUF_EXPORT:
+		if (copy_from_user(&args, argp, sizeof(args)))
+			return -EFAULT;
+		if (args.flags & ~(O_CLOEXEC | O_ACCMODE))
+			return -EINVAL;
+
+		dmabuf = tafi_dmabuf_export_vmalloc(par->videomemory, videomemorysize, tafi_fb_dmabuf_flush, info);
+		if (IS_ERR(dmabuf))
+			return PTR_ERR(dmabuf);
+
+		fd = dma_buf_fd(dmabuf, args.flags);
+		if (fd < 0) {
+			dma_buf_put(dmabuf);
+			return fd;
+		}
+
+		args.fd = fd;
+		if (copy_to_user(argp, &args, sizeof(args)))
+			return -EFAULT;
+		return 0;
+	default:
+		return -ENOTTY;
+	}
+}
+
 /*
  *  Initialisation
  */
 
 static int tafi_fb_probe(struct platform_device *dev) {
 	struct fb_info *info;
+	struct tafi_fb_par *par;
+	void *videomemory;
 	unsigned int size = PAGE_ALIGN(videomemorysize);
 	int retval = -ENOMEM;
 
@@ -355,24 +518,39 @@ static int tafi_fb_probe(struct platform_device *dev) {
 	if (!(videomemory = vmalloc_32_user(size)))
 		return retval;
 
-	info = framebuffer_alloc(sizeof(u32) * 256, &dev->dev);
+	info = framebuffer_alloc(sizeof(struct tafi_fb_par), &dev->dev);
 	if (!info)
 		goto err;
 
+	par = info->par;
+	par->info = info;
+	par->videomemory = videomemory;
+	par->polar = dev->id == TAFI_FB_POLAR_DEVICE_ID;
+	par->pipeline.convert = tafi_fb_pipeline_convert;
+
 	info->screen_base = (char __iomem *)videomemory;
 	info->fbops = &tafi_fb_ops;
-	info->mode = &tafi_fb_default;
 
 	info->var = tafi_fb_var;
-
-	tafi_fb_fix.smem_start = (unsigned long) videomemory;
-	tafi_fb_fix.smem_len = videomemorysize;
 	info->fix = tafi_fb_fix;
-	info->pseudo_palette = info->par;
-	info->par = NULL;
+	if (par->polar) {
+		info->mode = &tafi_fb_polar_default;
+		info->var.xres = info->var.xres_virtual = TAFI_FB_POLAR_XRES;
+		info->var.yres = info->var.yres_virtual = TAFI_FB_POLAR_YRES;
+		strlcpy(info->fix.id, "TAFIPOLARFB", sizeof(info->fix.id));
+	} else {
+		info->mode = &tafi_fb_default;
+	}
+
+	info->fix.smem_start = (unsigned long) videomemory;
+	info->fix.smem_len = videomemorysize;
+	info->fix.line_length = get_line_length(info->var.xres_virtual, info->var.bits_per_pixel);
+	info->pseudo_palette = par->pseudo_palette;
 	info->flags = FBINFO_FLAG_DEFAULT;
 
-	info->fbdefio = &tafi_fb_defio;
+	par->defio.delay = HZ;
+	par->defio.deferred_io = tafi_fb_deferred_io;
+	info->fbdefio = &par->defio;
 	fb_deferred_io_init(info);
 
 	retval = fb_alloc_cmap(&info->cmap, 256, 0);
@@ -384,13 +562,13 @@ static int tafi_fb_probe(struct platform_device *dev) {
 		goto err2;
 	platform_set_drvdata(dev, info);
 
-	fb_info(info, "Desperate Housewife frame buffer device, using %ldK of video memory\n",
-		videomemorysize >> 10);
+	fb_info(info, "Desperate Housewife %s frame buffer device, using %ldK of video memory\n",
+		par->polar ? "polar" : "Cartesian", videomemorysize >> 10);
 	return 0;
 err2:
 	fb_dealloc_cmap(&info->cmap);
-	fb_deferred_io_cleanup(info);
 err1:
+	fb_deferred_io_cleanup(info);
 	framebuffer_release(info);
 err:
 	vfree(videomemory);
@@ -399,11 +577,14 @@ err:
 
 static int tafi_fb_remove(struct platform_device *dev) {
 	struct fb_info *info = platform_get_drvdata(dev);
+	struct tafi_fb_par *par;
 
 	if (info) {
+		par = info->par;
 		fb_deferred_io_cleanup(info);
 		unregister_framebuffer(info);
-		vfree(videomemory);
+		tafi_pipeline_cancel(&par->pipeline);
+		vfree(par->videomemory);
 		fb_dealloc_cmap(&info->cmap);
 		framebuffer_release(info);
 	}
@@ -420,27 +601,42 @@ static struct platform_driver tafi_fb_driver = {
 
 int tafi_fb_init(void) {
 	int ret = 0;
+	int count = polar_fb ? TAFI_FB_DEVICE_COUNT : 1;
+	int i;
+
+	tafi_stats_register_hist(&tafi_fb_convert_even);
+	tafi_stats_register_hist(&tafi_fb_convert_odd);
 
 	ret = platform_driver_register(&tafi_fb_driver);
+	if (ret)
+		return ret;
 
-	if (!ret) {
-		tafi_fb_device = platform_device_alloc("tafi_fb", 0);
+	for (i = 0; i < count; i++) {
+		tafi_fb_device[i] = platform_device_alloc("tafi_fb", i);
 
-		if (tafi_fb_device)
-			ret = platform_device_add(tafi_fb_device);
+		if (tafi_fb_device[i])
+			ret = platform_device_add(tafi_fb_device[i]);
 		else
 			ret = -ENOMEM;
 
 		if (ret) {
-			platform_device_put(tafi_fb_device);
-			platform_driver_unregister(&tafi_fb_driver);
+			platform_device_put(tafi_fb_device[i]);
+			tafi_fb_device[i] = NULL;
+			tafi_fb_exit();
+			return ret;
 		}
 	}
 
-	return ret;
+	return 0;
 }
 
 void tafi_fb_exit(void) {
-	platform_device_unregister(tafi_fb_device);
+	int i;
+
+	for (i = 0; i < TAFI_FB_DEVICE_COUNT; i++) {
+		if (tafi_fb_device[i])
+			platform_device_unregister(tafi_fb_device[i]);
+		tafi_fb_device[i] = NULL;
+	}
 	platform_driver_unregister(&tafi_fb_driver);
 }
\ No newline at end of file
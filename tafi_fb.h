@@ -13,15 +13,22 @@
 // Required for the copy from user function
 #include <asm/uaccess.h>
 
+#include "tafi_ioctl.h"
+
 #ifndef TAFI_FB
 #define TAFI_FB
 
-#define TAFI_FB_XRES 80
-#define TAFI_FB_YRES 80
+// Native polar mode: one line per sector, one pixel per LED.
+#define TAFI_FB_POLAR_XRES TAFI_SECTOR_LED_COUNT
+#define TAFI_FB_POLAR_YRES TAFI_SECTOR_COUNT
 
 // bits per pixel
 #define TAFI_FB_BPP 24
 
+// Platform device ids of the Cartesian and the optional polar framebuffer.
+#define TAFI_FB_POLAR_DEVICE_ID 1
+#define TAFI_FB_DEVICE_COUNT 2
+
 int tafi_fb_init(void);
 void tafi_fb_exit(void);
 
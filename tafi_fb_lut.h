@@ -1,431 +0,0 @@
-/**
- *  tafi_fb_lut.h -- The Amazing Fan Idea driver
- *  Lookup tables for framebuffer device.
- * 
- *      (C) 2017 Harindu Perera
- *  
- *  This file is subject to the terms and conditions of the GNU General Public
- *  License. See the file COPYING in the main directory of this archive for
- *  more details.
- */
-
-#include "tafi_ioctl.h"
-
-#ifndef TAFI_FB_LUT_HDR
-#define TAFI_FB_LUT_HDR
-int TAFI_FB_DEV_LUT[TAFI_SECTOR_COUNT][TAFI_SECTOR_LED_COUNT][2] = 
-{
-    { {39, 77}, {39, 73}, {39, 69}, {39, 65}, {38, 61}, {38, 57}, {38, 53}, {38, 49}, {38, 45}, {38, 41}, {38, 39}, {38, 35}, {38, 31}, {38,27}, {38, 23}, {38, 19}, {37, 15}, {37, 11}, {37, 7}, {37, 3} },
-    { {40, 77}, {40, 73}, {40, 69}, {40, 65}, {39, 61}, {39, 57}, {39, 53}, {39, 49}, {38, 45}, {38, 41}, {38, 39}, {38, 35}, {37, 31}, {37,27}, {37, 23}, {37, 19}, {36, 15}, {36, 11}, {36, 7}, {36, 3} },
-    { {42, 77}, {41, 73}, {41, 69}, {41, 65}, {40, 61}, {40, 57}, {39, 53}, {39, 49}, {38, 45}, {38, 41}, {38, 39}, {37, 35}, {37, 31}, {37,27}, {36, 23}, {36, 19}, {35, 15}, {35, 11}, {34, 7}, {34, 3} },
-    { {43, 77}, {43, 73}, {42, 69}, {42, 65}, {41, 61}, {40, 57}, {40, 53}, {39, 49}, {39, 45}, {38, 41}, {38, 39}, {37, 35}, {37, 31}, {36,27}, {35, 23}, {35, 19}, {34, 15}, {34, 11}, {33, 7}, {32, 3} },
-    { {45, 76}, {44, 72}, {43, 69}, {42, 65}, {42, 61}, {41, 57}, {40, 53}, {39, 49}, {39, 45}, {38, 41}, {38, 39}, {37, 35}, {36, 31}, {35,27}, {35, 23}, {34, 19}, {33, 15}, {32, 12}, {32, 8}, {31, 4} },
-    { {46, 76}, {45, 72}, {44, 68}, {43, 64}, {43, 60}, {42, 57}, {41, 53}, {40, 49}, {39, 45}, {38, 41}, {38, 39}, {37, 35}, {36, 31}, {35,27}, {34, 23}, {33, 20}, {32, 16}, {31, 12}, {30, 8}, {29, 4} },
-    { {48, 76}, {47, 72}, {46, 68}, {44, 64}, {43, 60}, {42, 56}, {41, 53}, {40, 49}, {39, 45}, {38, 41}, {37, 39}, {36, 35}, {35, 31}, {34,28}, {33, 24}, {32, 20}, {31, 16}, {30, 12}, {29, 8}, {28, 4} },
-    { {49, 75}, {48, 71}, {47, 68}, {45, 64}, {44, 60}, {43, 56}, {42, 52}, {40, 49}, {39, 45}, {38, 41}, {37, 39}, {36, 35}, {35, 31}, {34,28}, {32, 24}, {31, 20}, {30, 16}, {29, 12}, {27, 9}, {26, 5} },
-    { {51, 75}, {49, 71}, {48, 67}, {46, 63}, {45, 60}, {44, 56}, {42, 52}, {41, 48}, {39, 45}, {38, 41}, {37, 39}, {36, 35}, {35, 32}, {33,28}, {32, 24}, {30, 20}, {29, 17}, {28, 13}, {26, 9}, {25, 5} },
-    { {52, 74}, {50, 70}, {49, 67}, {47, 63}, {46, 59}, {44, 56}, {43, 52}, {41, 48}, {40, 45}, {38, 41}, {37, 39}, {36, 35}, {34, 32}, {33,28}, {31, 24}, {29, 21}, {28, 17}, {26, 13}, {25, 10}, {23, 6} },
-    { {53, 74}, {52, 70}, {50, 66}, {48, 63}, {47, 59}, {45, 55}, {43, 52}, {41, 48}, {40, 45}, {38, 41}, {37, 39}, {35, 36}, {34, 32}, {32,28}, {30, 25}, {29, 21}, {27, 17}, {25, 14}, {24, 10}, {22, 7} },
-    { {55, 73}, {53, 69}, {51, 66}, {49, 62}, {47, 59}, {45, 55}, {44, 52}, {42, 48}, {40, 45}, {38, 41}, {37, 39}, {35, 36}, {33, 32}, {32,29}, {30, 25}, {28, 22}, {26, 18}, {24, 14}, {22, 11}, {20, 7} },
-    { {56, 72}, {54, 69}, {52, 65}, {50, 62}, {48, 58}, {46, 55}, {44, 51}, {42, 48}, {40, 44}, {38, 41}, {37, 39}, {35, 36}, {33, 32}, {31,29}, {29, 25}, {27, 22}, {25, 18}, {23, 15}, {21, 12}, {19, 8} },
-    { {57, 71}, {55, 68}, {53, 65}, {51, 61}, {49, 58}, {47, 55}, {44, 51}, {42, 48}, {40, 44}, {38, 41}, {37, 39}, {35, 36}, {33, 33}, {30,29}, {28, 26}, {26, 22}, {24, 19}, {22, 16}, {20, 12}, {18, 9} },
-    { {59, 71}, {56, 67}, {54, 64}, {52, 61}, {49, 57}, {47, 54}, {45, 51}, {43, 48}, {40, 44}, {38, 41}, {37, 39}, {35, 36}, {32, 33}, {30,30}, {28, 26}, {25, 23}, {23, 20}, {21, 16}, {19, 13}, {16, 10} },
-    { {60, 70}, {57, 66}, {55, 63}, {53, 60}, {50, 57}, {48, 54}, {45, 51}, {43, 47}, {40, 44}, {38, 41}, {37, 39}, {34, 36}, {32, 33}, {30,30}, {27, 27}, {25, 23}, {22, 20}, {20, 17}, {17, 14}, {15, 11} },
-    { {61, 69}, {58, 66}, {56, 63}, {53, 59}, {51, 56}, {48, 53}, {46, 50}, {43, 47}, {41, 44}, {38, 41}, {37, 39}, {34, 36}, {32, 33}, {29,30}, {27, 27}, {24, 24}, {21, 21}, {19, 18}, {16, 15}, {14, 12} },
-    { {62, 68}, {59, 65}, {57, 62}, {54, 59}, {51, 56}, {49, 53}, {46, 50}, {43, 47}, {41, 44}, {38, 41}, {37, 40}, {34, 37}, {31, 34}, {29,31}, {26, 28}, {23, 25}, {21, 22}, {18, 19}, {15, 16}, {13, 13} },
-    { {63, 67}, {60, 64}, {58, 61}, {55, 58}, {52, 55}, {49, 52}, {46, 50}, {44, 47}, {41, 44}, {38, 41}, {37, 40}, {34, 37}, {31, 34}, {28,31}, {25, 28}, {23, 25}, {20, 22}, {17, 20}, {14, 17}, {11, 14} },
-    { {64, 66}, {61, 63}, {58, 60}, {55, 57}, {53, 55}, {50, 52}, {47, 49}, {44, 46}, {41, 44}, {38, 41}, {37, 40}, {34, 37}, {31, 34}, {28,31}, {25, 29}, {22, 26}, {19, 23}, {16, 20}, {13, 18}, {10, 15} },
-    { {65, 65}, {62, 62}, {59, 59}, {56, 57}, {53, 54}, {50, 51}, {47, 49}, {44, 46}, {41, 44}, {38, 41}, {36, 40}, {33, 37}, {30, 34}, {27,32}, {24, 29}, {21, 27}, {18, 24}, {15, 21}, {12, 19}, {9, 16} },
-    { {66, 63}, {63, 61}, {60, 58}, {57, 56}, {54, 53}, {51, 51}, {47, 48}, {44, 46}, {41, 43}, {38, 41}, {36, 40}, {33, 37}, {30, 35}, {27,32}, {24, 30}, {21, 27}, {18, 25}, {14, 22}, {11, 20}, {8, 17} },
-    { {67, 62}, {64, 60}, {61, 57}, {57, 55}, {54, 53}, {51, 50}, {48, 48}, {44, 46}, {41, 43}, {38, 41}, {36, 40}, {33, 37}, {30, 35}, {27,33}, {23, 30}, {20, 28}, {17, 26}, {14, 23}, {10, 21}, {7, 19} },
-    { {68, 61}, {65, 59}, {61, 56}, {58, 54}, {55, 52}, {51, 50}, {48, 48}, {45, 45}, {41, 43}, {38, 41}, {36, 40}, {33, 38}, {30, 35}, {26,33}, {23, 31}, {20, 29}, {16, 27}, {13, 24}, {10, 22}, {6, 20} },
-    { {69, 60}, {65, 58}, {62, 56}, {59, 53}, {55, 51}, {52, 49}, {48, 47}, {45, 45}, {41, 43}, {38, 41}, {36, 40}, {33, 38}, {29, 36}, {26,34}, {23, 32}, {19, 30}, {16, 28}, {12, 25}, {9, 23}, {5, 21} },
-    { {70, 58}, {66, 56}, {63, 54}, {59, 53}, {56, 51}, {52, 49}, {49, 47}, {45, 45}, {42, 43}, {38, 41}, {36, 40}, {33, 38}, {29, 36}, {26,34}, {22, 32}, {19, 30}, {15, 28}, {12, 27}, {8, 25}, {5, 23} },
-    { {70, 57}, {67, 55}, {63, 53}, {59, 52}, {56, 50}, {52, 48}, {49, 46}, {45, 45}, {42, 43}, {38, 41}, {36, 40}, {33, 38}, {29, 37}, {25,35}, {22, 33}, {18, 31}, {15, 29}, {11, 28}, {8, 26}, {4, 24} },
-    { {71, 56}, {67, 54}, {64, 52}, {60, 51}, {56, 49}, {53, 48}, {49, 46}, {45, 44}, {42, 43}, {38, 41}, {36, 40}, {33, 39}, {29, 37}, {25,35}, {22, 34}, {18, 32}, {14, 30}, {11, 29}, {7, 27}, {3, 26} },
-    { {71, 54}, {68, 53}, {64, 51}, {60, 50}, {57, 48}, {53, 47}, {49, 45}, {45, 44}, {42, 42}, {38, 41}, {36, 40}, {32, 39}, {29, 37}, {25,36}, {21, 34}, {18, 33}, {14, 31}, {10, 30}, {6, 28}, {3, 27} },
-    { {72, 53}, {68, 52}, {64, 50}, {61, 49}, {57, 48}, {53, 46}, {49, 45}, {46, 44}, {42, 42}, {38, 41}, {36, 40}, {32, 39}, {29, 38}, {25,36}, {21, 35}, {17, 34}, {13, 32}, {10, 31}, {6, 30}, {2, 29} },
-    { {72, 51}, {69, 50}, {65, 49}, {61, 48}, {57, 47}, {53, 46}, {49, 44}, {46, 43}, {42, 42}, {38, 41}, {36, 40}, {32, 39}, {28, 38}, {25,37}, {21, 36}, {17, 35}, {13, 33}, {9, 32}, {5, 31}, {2, 30} },
-    { {73, 50}, {69, 49}, {65, 48}, {61, 47}, {57, 46}, {53, 45}, {50, 44}, {46, 43}, {42, 42}, {38, 41}, {36, 41}, {32, 40}, {28, 39}, {24,38}, {21, 37}, {17, 36}, {13, 35}, {9, 34}, {5, 33}, {1, 32} },
-    { {73, 48}, {69, 48}, {65, 47}, {61, 46}, {58, 45}, {54, 44}, {50, 43}, {46, 43}, {42, 42}, {38, 41}, {36, 41}, {32, 40}, {28, 39}, {24,38}, {20, 37}, {16, 36}, {13, 36}, {9, 35}, {5, 34}, {1, 33} },
-    { {73, 47}, {70, 46}, {66, 46}, {62, 45}, {58, 44}, {54, 44}, {50, 43}, {46, 42}, {42, 42}, {38, 41}, {36, 41}, {32, 40}, {28, 39}, {24,39}, {20, 38}, {16, 37}, {12, 37}, {8, 36}, {4, 35}, {1, 35} },
-    { {74, 46}, {70, 45}, {66, 45}, {62, 44}, {58, 44}, {54, 43}, {50, 43}, {46, 42}, {42, 42}, {38, 41}, {36, 41}, {32, 40}, {28, 40}, {24,39}, {20, 39}, {16, 38}, {12, 38}, {8, 37}, {4, 37}, {0, 36} },
-    { {74, 44}, {70, 44}, {66, 43}, {62, 43}, {58, 43}, {54, 42}, {50, 42}, {46, 42}, {42, 41}, {38, 41}, {36, 41}, {32, 40}, {28, 40}, {24,40}, {20, 39}, {16, 39}, {12, 39}, {8, 38}, {4, 38}, {0, 38} },
-    { {74, 43}, {70, 42}, {66, 42}, {62, 42}, {58, 42}, {54, 42}, {50, 42}, {46, 41}, {42, 41}, {38, 41}, {36, 41}, {32, 41}, {28, 41}, {24,40}, {20, 40}, {16, 40}, {12, 40}, {8, 40}, {4, 40}, {0, 39} },
-    { {74, 41}, {70, 41}, {66, 41}, {62, 41}, {58, 41}, {54, 41}, {50, 41}, {46, 41}, {42, 41}, {38, 41}, {36, 41}, {32, 41}, {28, 41}, {24,41}, {20, 41}, {16, 41}, {12, 41}, {8, 41}, {4, 41}, {0, 41} },
-    { {74, 39}, {70, 40}, {66, 40}, {62, 40}, {58, 40}, {54, 40}, {50, 40}, {46, 41}, {42, 41}, {38, 41}, {36, 41}, {32, 41}, {28, 41}, {24,42}, {20, 42}, {16, 42}, {12, 42}, {8, 42}, {4, 42}, {0, 43} },
-    { {74, 38}, {70, 38}, {66, 39}, {62, 39}, {58, 39}, {54, 40}, {50, 40}, {46, 40}, {42, 41}, {38, 41}, {36, 41}, {32, 42}, {28, 42}, {24,42}, {20, 43}, {16, 43}, {12, 43}, {8, 44}, {4, 44}, {0, 44} },
-    { {74, 36}, {70, 37}, {66, 37}, {62, 38}, {58, 38}, {54, 39}, {50, 39}, {46, 40}, {42, 40}, {38, 41}, {36, 41}, {32, 42}, {28, 42}, {24,43}, {20, 43}, {16, 44}, {12, 44}, {8, 45}, {4, 45}, {0, 46} },
-    { {73, 35}, {70, 36}, {66, 36}, {62, 37}, {58, 38}, {54, 38}, {50, 39}, {46, 40}, {42, 40}, {38, 41}, {36, 41}, {32, 42}, {28, 43}, {24,43}, {20, 44}, {16, 45}, {12, 45}, {8, 46}, {4, 47}, {1, 47} },
-    { {73, 34}, {69, 34}, {65, 35}, {61, 36}, {58, 37}, {54, 38}, {50, 39}, {46, 39}, {42, 40}, {38, 41}, {36, 41}, {32, 42}, {28, 43}, {24,44}, {20, 45}, {16, 46}, {13, 46}, {9, 47}, {5, 48}, {1, 49} },
-    { {73, 32}, {69, 33}, {65, 34}, {61, 35}, {57, 36}, {53, 37}, {50, 38}, {46, 39}, {42, 40}, {38, 41}, {36, 41}, {32, 42}, {28, 43}, {24,44}, {21, 45}, {17, 46}, {13, 47}, {9, 48}, {5, 49}, {1, 50} },
-    { {72, 31}, {69, 32}, {65, 33}, {61, 34}, {57, 35}, {53, 36}, {49, 38}, {46, 39}, {42, 40}, {38, 41}, {36, 42}, {32, 43}, {28, 44}, {25,45}, {21, 46}, {17, 47}, {13, 49}, {9, 50}, {5, 51}, {2, 52} },
-    { {72, 29}, {68, 30}, {64, 32}, {61, 33}, {57, 34}, {53, 36}, {49, 37}, {46, 38}, {42, 40}, {38, 41}, {36, 42}, {32, 43}, {29, 44}, {25,46}, {21, 47}, {17, 48}, {13, 50}, {10, 51}, {6, 52}, {2, 53} },
-    { {71, 28}, {68, 29}, {64, 31}, {60, 32}, {57, 34}, {53, 35}, {49, 37}, {45, 38}, {42, 40}, {38, 41}, {36, 42}, {32, 43}, {29, 45}, {25,46}, {21, 48}, {18, 49}, {14, 51}, {10, 52}, {6, 54}, {3, 55} },
-    { {71, 26}, {67, 28}, {64, 30}, {60, 31}, {56, 33}, {53, 34}, {49, 36}, {45, 38}, {42, 39}, {38, 41}, {36, 42}, {33, 43}, {29, 45}, {25,47}, {22, 48}, {18, 50}, {14, 52}, {11, 53}, {7, 55}, {3, 56} },
-    { {70, 25}, {67, 27}, {63, 29}, {59, 30}, {56, 32}, {52, 34}, {49, 36}, {45, 37}, {42, 39}, {38, 41}, {36, 42}, {33, 44}, {29, 45}, {25,47}, {22, 49}, {18, 51}, {15, 53}, {11, 54}, {8, 56}, {4, 58} },
-    { {70, 24}, {66, 26}, {63, 28}, {59, 29}, {56, 31}, {52, 33}, {49, 35}, {45, 37}, {42, 39}, {38, 41}, {36, 42}, {33, 44}, {29, 46}, {26,48}, {22, 50}, {19, 52}, {15, 54}, {12, 55}, {8, 57}, {5, 59} },
-    { {69, 22}, {65, 24}, {62, 26}, {59, 29}, {55, 31}, {52, 33}, {48, 35}, {45, 37}, {41, 39}, {38, 41}, {36, 42}, {33, 44}, {29, 46}, {26,48}, {23, 50}, {19, 52}, {16, 54}, {12, 57}, {9, 59}, {5, 61} },
-    { {68, 21}, {65, 23}, {61, 26}, {58, 28}, {55, 30}, {51, 32}, {48, 34}, {45, 37}, {41, 39}, {38, 41}, {36, 42}, {33, 44}, {30, 47}, {26,49}, {23, 51}, {20, 53}, {16, 55}, {13, 58}, {10, 60}, {6, 62} },
-    { {67, 20}, {64, 22}, {61, 25}, {57, 27}, {54, 29}, {51, 32}, {48, 34}, {44, 36}, {41, 39}, {38, 41}, {36, 42}, {33, 45}, {30, 47}, {27,49}, {23, 52}, {20, 54}, {17, 56}, {14, 59}, {10, 61}, {7, 63} },
-    { {66, 19}, {63, 21}, {60, 24}, {57, 26}, {54, 29}, {51, 31}, {47, 34}, {44, 36}, {41, 39}, {38, 41}, {36, 42}, {33, 45}, {30, 47}, {27,50}, {24, 52}, {21, 55}, {18, 57}, {14, 60}, {11, 62}, {8, 65} },
-    { {65, 17}, {62, 20}, {59, 23}, {56, 25}, {53, 28}, {50, 31}, {47, 33}, {44, 36}, {41, 38}, {38, 41}, {36, 42}, {33, 45}, {30, 48}, {27,50}, {24, 53}, {21, 55}, {18, 58}, {15, 61}, {12, 63}, {9, 66} },
-    { {64, 16}, {61, 19}, {58, 22}, {55, 25}, {53, 27}, {50, 30}, {47, 33}, {44, 36}, {41, 38}, {38, 41}, {37, 42}, {34, 45}, {31, 48}, {28,51}, {25, 53}, {22, 56}, {19, 59}, {16, 62}, {13, 64}, {10, 67} },
-    { {63, 15}, {60, 18}, {58, 21}, {55, 24}, {52, 27}, {49, 30}, {46, 32}, {44, 35}, {41, 38}, {38, 41}, {37, 42}, {34, 45}, {31, 48}, {28,51}, {25, 54}, {23, 57}, {20, 60}, {17, 62}, {14, 65}, {11, 68} },
-    { {62, 14}, {59, 17}, {57, 20}, {54, 23}, {51, 26}, {49, 29}, {46, 32}, {43, 35}, {41, 38}, {38, 41}, {37, 42}, {34, 45}, {31, 48}, {29,51}, {26, 54}, {23, 57}, {21, 60}, {18, 63}, {15, 66}, {13, 69} },
-    { {61, 13}, {58, 16}, {56, 19}, {53, 23}, {51, 26}, {48, 29}, {46, 32}, {43, 35}, {41, 38}, {38, 41}, {37, 43}, {34, 46}, {32, 49}, {29,52}, {27, 55}, {24, 58}, {21, 61}, {19, 64}, {16, 67}, {14, 70} },
-    { {60, 12}, {57, 16}, {55, 19}, {53, 22}, {50, 25}, {48, 28}, {45, 31}, {43, 35}, {40, 38}, {38, 41}, {37, 43}, {34, 46}, {32, 49}, {30,52}, {27, 55}, {25, 59}, {22, 62}, {20, 65}, {17, 68}, {15, 71} },
-    { {59, 11}, {56, 15}, {54, 18}, {52, 21}, {49, 25}, {47, 28}, {45, 31}, {43, 34}, {40, 38}, {38, 41}, {37, 43}, {35, 46}, {32, 49}, {30,52}, {28, 56}, {25, 59}, {23, 62}, {21, 66}, {19, 69}, {16, 72} },
-    { {57, 11}, {55, 14}, {53, 17}, {51, 21}, {49, 24}, {47, 27}, {44, 31}, {42, 34}, {40, 38}, {38, 41}, {37, 43}, {35, 46}, {33, 49}, {30,53}, {28, 56}, {26, 60}, {24, 63}, {22, 66}, {20, 70}, {18, 73} },
-    { {56, 10}, {54, 13}, {52, 17}, {50, 20}, {48, 24}, {46, 27}, {44, 31}, {42, 34}, {40, 38}, {38, 41}, {37, 43}, {35, 46}, {33, 50}, {31,53}, {29, 57}, {27, 60}, {25, 64}, {23, 67}, {21, 70}, {19, 74} },
-    { {55, 9}, {53, 13}, {51, 16}, {49, 20}, {47, 23}, {45, 27}, {44, 30}, {42, 34}, {40, 37}, {38, 41}, {37, 43}, {35, 46}, {33, 50}, {32, 53}, {30, 57}, {28, 60}, {26, 64}, {24, 68}, {22, 71}, {20, 75} },
-    { {53, 8}, {52, 12}, {50, 16}, {48, 19}, {47, 23}, {45, 27}, {43, 30}, {41, 34}, {40, 37}, {38, 41}, {37, 43}, {35, 46}, {34, 50}, {32, 54}, {30, 57}, {29, 61}, {27, 65}, {25, 68}, {24, 72}, {22, 75} },
-    { {52, 8}, {50, 12}, {49, 15}, {47, 19}, {46, 23}, {44, 26}, {43, 30}, {41, 34}, {40, 37}, {38, 41}, {37, 43}, {36, 47}, {34, 50}, {33, 54}, {31, 58}, {29, 61}, {28, 65}, {26, 69}, {25, 72}, {23, 76} },
-    { {51, 7}, {49, 11}, {48, 15}, {46, 19}, {45, 22}, {44, 26}, {42, 30}, {41, 34}, {39, 37}, {38, 41}, {37, 43}, {36, 47}, {35, 50}, {33, 54}, {32, 58}, {30, 62}, {29, 65}, {28, 69}, {26, 73}, {25, 77} },
-    { {49, 7}, {48, 11}, {47, 14}, {45, 18}, {44, 22}, {43, 26}, {42, 30}, {40, 33}, {39, 37}, {38, 41}, {37, 43}, {36, 47}, {35, 51}, {34, 54}, {32, 58}, {31, 62}, {30, 66}, {29, 70}, {27, 73}, {26, 77} },
-    { {48, 6}, {47, 10}, {46, 14}, {44, 18}, {43, 22}, {42, 26}, {41, 29}, {40, 33}, {39, 37}, {38, 41}, {37, 43}, {36, 47}, {35, 51}, {34, 54}, {33, 58}, {32, 62}, {31, 66}, {30, 70}, {29, 74}, {28, 78} },
-    { {46, 6}, {45, 10}, {44, 14}, {43, 18}, {43, 22}, {42, 25}, {41, 29}, {40, 33}, {39, 37}, {38, 41}, {38, 43}, {37, 47}, {36, 51}, {35, 55}, {34, 59}, {33, 62}, {32, 66}, {31, 70}, {30, 74}, {29, 78} },
-    { {45, 6}, {44, 10}, {43, 13}, {42, 17}, {42, 21}, {41, 25}, {40, 29}, {39, 33}, {39, 37}, {38, 41}, {38, 43}, {37, 47}, {36, 51}, {35, 55}, {35, 59}, {34, 63}, {33, 67}, {32, 70}, {32, 74}, {31, 78} },
-    { {43, 5}, {43, 9}, {42, 13}, {42, 17}, {41, 21}, {40, 25}, {40, 29}, {39, 33}, {39, 37}, {38, 41}, {38, 43}, {37, 47}, {37, 51}, {36, 55}, {35, 59}, {35, 63}, {34, 67}, {34, 71}, {33, 75}, {32, 79} },
-    { {42, 5}, {41, 9}, {41, 13}, {41, 17}, {40, 21}, {40, 25}, {39, 29}, {39, 33}, {38, 37}, {38, 41}, {38, 43}, {37, 47}, {37, 51}, {37, 55}, {36, 59}, {36, 63}, {35, 67}, {35, 71}, {34, 75}, {34, 79} },
-    { {40, 5}, {40, 9}, {40, 13}, {40, 17}, {39, 21}, {39, 25}, {39, 29}, {39, 33}, {38, 37}, {38, 41}, {38, 43}, {38, 47}, {37, 51}, {37, 55}, {37, 59}, {37, 63}, {36, 67}, {36, 71}, {36, 75}, {36, 79} },
-    { {39, 5}, {39, 9}, {39, 13}, {39, 17}, {38, 21}, {38, 25}, {38, 29}, {38, 33}, {38, 37}, {38, 41}, {38, 43}, {38, 47}, {38, 51}, {38, 55}, {38, 59}, {38, 63}, {37, 67}, {37, 71}, {37, 75}, {37, 79} },
-    { {37, 5}, {37, 9}, {37, 13}, {37, 17}, {38, 21}, {38, 25}, {38, 29}, {38, 33}, {38, 37}, {38, 41}, {38, 43}, {38, 47}, {38, 51}, {38, 55}, {38, 59}, {38, 63}, {39, 67}, {39, 71}, {39, 75}, {39, 79} },
-    { {36, 5}, {36, 9}, {36, 13}, {36, 17}, {37, 21}, {37, 25}, {37, 29}, {37, 33}, {38, 37}, {38, 41}, {38, 43}, {38, 47}, {39, 51}, {39, 55}, {39, 59}, {39, 63}, {40, 67}, {40, 71}, {40, 75}, {40, 79} },
-    { {34, 5}, {35, 9}, {35, 13}, {35, 17}, {36, 21}, {36, 25}, {37, 29}, {37, 33}, {38, 37}, {38, 41}, {38, 43}, {39, 47}, {39, 51}, {39, 55}, {40, 59}, {40, 63}, {41, 67}, {41, 71}, {42, 75}, {42, 79} },
-    { {33, 5}, {33, 9}, {34, 13}, {34, 17}, {35, 21}, {36, 25}, {36, 29}, {37, 33}, {37, 37}, {38, 41}, {38, 43}, {39, 47}, {39, 51}, {40, 55}, {41, 59}, {41, 63}, {42, 67}, {42, 71}, {43, 75}, {44, 79} },
-    { {31, 6}, {32, 10}, {33, 13}, {34, 17}, {34, 21}, {35, 25}, {36, 29}, {37, 33}, {37, 37}, {38, 41}, {38, 43}, {39, 47}, {40, 51}, {41, 55}, {41, 59}, {42, 63}, {43, 67}, {44, 70}, {44, 74}, {45, 78} },
-    { {30, 6}, {31, 10}, {32, 14}, {33, 18}, {33, 22}, {34, 25}, {35, 29}, {36, 33}, {37, 37}, {38, 41}, {38, 43}, {39, 47}, {40, 51}, {41, 55}, {42, 59}, {43, 62}, {44, 66}, {45, 70}, {46, 74}, {47, 78} },
-    { {28, 6}, {29, 10}, {30, 14}, {32, 18}, {33, 22}, {34, 26}, {35, 29}, {36, 33}, {37, 37}, {38, 41}, {39, 43}, {40, 47}, {41, 51}, {42, 54}, {43, 58}, {44, 62}, {45, 66}, {46, 70}, {47, 74}, {48, 78} },
-    { {27, 7}, {28, 11}, {29, 14}, {31, 18}, {32, 22}, {33, 26}, {34, 30}, {36, 33}, {37, 37}, {38, 41}, {39, 43}, {40, 47}, {41, 51}, {42, 54}, {44, 58}, {45, 62}, {46, 66}, {47, 70}, {49, 73}, {50, 77} },
-    { {25, 7}, {27, 11}, {28, 15}, {30, 19}, {31, 22}, {32, 26}, {34, 30}, {35, 34}, {37, 37}, {38, 41}, {39, 43}, {40, 47}, {41, 50}, {43, 54}, {44, 58}, {46, 62}, {47, 65}, {48, 69}, {50, 73}, {51, 77} },
-    { {24, 8}, {26, 12}, {27, 15}, {29, 19}, {30, 23}, {32, 26}, {33, 30}, {35, 34}, {36, 37}, {38, 41}, {39, 43}, {40, 47}, {42, 50}, {43, 54}, {45, 58}, {47, 61}, {48, 65}, {50, 69}, {51, 72}, {53, 76} },
-    { {23, 8}, {24, 12}, {26, 16}, {28, 19}, {29, 23}, {31, 27}, {33, 30}, {35, 34}, {36, 37}, {38, 41}, {39, 43}, {41, 46}, {42, 50}, {44, 54}, {46, 57}, {47, 61}, {49, 65}, {51, 68}, {52, 72}, {54, 75} },
-    { {21, 9}, {23, 13}, {25, 16}, {27, 20}, {29, 23}, {31, 27}, {32, 30}, {34, 34}, {36, 37}, {38, 41}, {39, 43}, {41, 46}, {43, 50}, {44, 53}, {46, 57}, {48, 60}, {50, 64}, {52, 68}, {54, 71}, {56, 75} },
-    { {20, 10}, {22, 13}, {24, 17}, {26, 20}, {28, 24}, {30, 27}, {32, 31}, {34, 34}, {36, 38}, {38, 41}, {39, 43}, {41, 46}, {43, 50}, {45,53}, {47, 57}, {49, 60}, {51, 64}, {53, 67}, {55, 70}, {57, 74} },
-    { {19, 11}, {21, 14}, {23, 17}, {25, 21}, {27, 24}, {29, 27}, {32, 31}, {34, 34}, {36, 38}, {38, 41}, {39, 43}, {41, 46}, {43, 49}, {46,53}, {48, 56}, {50, 60}, {52, 63}, {54, 66}, {56, 70}, {58, 73} },
-    { {17, 11}, {20, 15}, {22, 18}, {24, 21}, {27, 25}, {29, 28}, {31, 31}, {33, 34}, {36, 38}, {38, 41}, {39, 43}, {41, 46}, {44, 49}, {46,52}, {48, 56}, {51, 59}, {53, 62}, {55, 66}, {57, 69}, {60, 72} },
-    { {16, 12}, {19, 16}, {21, 19}, {23, 22}, {26, 25}, {28, 28}, {31, 31}, {33, 35}, {36, 38}, {38, 41}, {39, 43}, {42, 46}, {44, 49}, {46,52}, {49, 55}, {51, 59}, {54, 62}, {56, 65}, {59, 68}, {61, 71} },
-    { {15, 13}, {18, 16}, {20, 19}, {23, 23}, {25, 26}, {28, 29}, {30, 32}, {33, 35}, {35, 38}, {38, 41}, {39, 43}, {42, 46}, {44, 49}, {47,52}, {49, 55}, {52, 58}, {55, 61}, {57, 64}, {60, 67}, {62, 70} },
-    { {14, 14}, {17, 17}, {19, 20}, {22, 23}, {25, 26}, {27, 29}, {30, 32}, {33, 35}, {35, 38}, {38, 41}, {39, 42}, {42, 45}, {45, 48}, {47,51}, {50, 54}, {53, 57}, {55, 60}, {58, 63}, {61, 66}, {63, 69} },
-    { {13, 15}, {16, 18}, {18, 21}, {21, 24}, {24, 27}, {27, 30}, {30, 32}, {32, 35}, {35, 38}, {38, 41}, {39, 42}, {42, 45}, {45, 48}, {48,51}, {51, 54}, {53, 57}, {56, 60}, {59, 62}, {62, 65}, {65, 68} },
-    { {12, 16}, {15, 19}, {18, 22}, {21, 25}, {23, 27}, {26, 30}, {29, 33}, {32, 36}, {35, 38}, {38, 41}, {39, 42}, {42, 45}, {45, 48}, {48,51}, {51, 53}, {54, 56}, {57, 59}, {60, 62}, {63, 64}, {66, 67} },
-    { {11, 17}, {14, 20}, {17, 23}, {20, 25}, {23, 28}, {26, 31}, {29, 33}, {32, 36}, {35, 38}, {38, 41}, {40, 42}, {43, 45}, {46, 48}, {49,50}, {52, 53}, {55, 55}, {58, 58}, {61, 61}, {64, 63}, {67, 66} },
-    { {10, 19}, {13, 21}, {16, 24}, {19, 26}, {22, 29}, {25, 31}, {29, 34}, {32, 36}, {35, 39}, {38, 41}, {40, 42}, {43, 45}, {46, 47}, {49,50}, {52, 52}, {55, 55}, {58, 57}, {62, 60}, {65, 62}, {68, 65} },
-    { {9, 20}, {12, 22}, {15, 25}, {19, 27}, {22, 29}, {25, 32}, {28, 34}, {32, 36}, {35, 39}, {38, 41}, {40, 42}, {43, 45}, {46, 47}, {49, 49}, {53, 52}, {56, 54}, {59, 56}, {62, 59}, {66, 61}, {69, 63} },
-    { {8, 21}, {11, 23}, {15, 26}, {18, 28}, {21, 30}, {25, 32}, {28, 34}, {31, 37}, {35, 39}, {38, 41}, {40, 42}, {43, 44}, {46, 47}, {50, 49}, {53, 51}, {56, 53}, {60, 55}, {63, 58}, {66, 60}, {70, 62} },
-    { {7, 22}, {11, 24}, {14, 26}, {17, 29}, {21, 31}, {24, 33}, {28, 35}, {31, 37}, {35, 39}, {38, 41}, {40, 42}, {43, 44}, {47, 46}, {50, 48}, {53, 50}, {57, 52}, {60, 54}, {64, 57}, {67, 59}, {71, 61} },
-    { {6, 24}, {10, 26}, {13, 28}, {17, 29}, {20, 31}, {24, 33}, {27, 35}, {31, 37}, {34, 39}, {38, 41}, {40, 42}, {43, 44}, {47, 46}, {50, 48}, {54, 50}, {57, 52}, {61, 54}, {64, 55}, {68, 57}, {71, 59} },
-    { {6, 25}, {9, 27}, {13, 29}, {17, 30}, {20, 32}, {24, 34}, {27, 36}, {31, 37}, {34, 39}, {38, 41}, {40, 42}, {43, 44}, {47, 45}, {51, 47}, {54, 49}, {58, 51}, {61, 53}, {65, 54}, {68, 56}, {72, 58} },
-    { {5, 26}, {9, 28}, {12, 30}, {16, 31}, {20, 33}, {23, 34}, {27, 36}, {31, 38}, {34, 39}, {38, 41}, {40, 42}, {43, 43}, {47, 45}, {51, 47}, {54, 48}, {58, 50}, {62, 52}, {65, 53}, {69, 55}, {73, 56} },
-    { {5, 28}, {8, 29}, {12, 31}, {16, 32}, {19, 34}, {23, 35}, {27, 37}, {31, 38}, {34, 40}, {38, 41}, {40, 42}, {44, 43}, {47, 45}, {51, 46}, {55, 48}, {58, 49}, {62, 51}, {66, 52}, {70, 54}, {73, 55} },
-    { {4, 29}, {8, 30}, {12, 32}, {15, 33}, {19, 34}, {23, 36}, {27, 37}, {30, 38}, {34, 40}, {38, 41}, {40, 42}, {44, 43}, {47, 44}, {51, 46}, {55, 47}, {59, 48}, {63, 50}, {66, 51}, {70, 52}, {74, 53} },
-    { {4, 31}, {7, 32}, {11, 33}, {15, 34}, {19, 35}, {23, 36}, {27, 38}, {30, 39}, {34, 40}, {38, 41}, {40, 42}, {44, 43}, {48, 44}, {51, 45}, {55, 46}, {59, 47}, {63, 49}, {67, 50}, {71, 51}, {74, 52} },
-    { {3, 32}, {7, 33}, {11, 34}, {15, 35}, {19, 36}, {23, 37}, {26, 38}, {30, 39}, {34, 40}, {38, 41}, {40, 41}, {44, 42}, {48, 43}, {52, 44}, {55, 45}, {59, 46}, {63, 47}, {67, 48}, {71, 49}, {75, 50} },
-    { {3, 34}, {7, 34}, {11, 35}, {15, 36}, {18, 37}, {22, 38}, {26, 39}, {30, 39}, {34, 40}, {38, 41}, {40, 41}, {44, 42}, {48, 43}, {52, 44}, {56, 45}, {60, 46}, {63, 46}, {67, 47}, {71, 48}, {75, 49} },
-    { {3, 35}, {6, 36}, {10, 36}, {14, 37}, {18, 38}, {22, 38}, {26, 39}, {30, 40}, {34, 40}, {38, 41}, {40, 41}, {44, 42}, {48, 43}, {52, 43}, {56, 44}, {60, 45}, {64, 45}, {68, 46}, {72, 47}, {75, 47} },
-    { {2, 36}, {6, 37}, {10, 37}, {14, 38}, {18, 38}, {22, 39}, {26, 39}, {30, 40}, {34, 40}, {38, 41}, {40, 41}, {44, 42}, {48, 42}, {52, 43}, {56, 43}, {60, 44}, {64, 44}, {68, 45}, {72, 45}, {76, 46} },
-    { {2, 38}, {6, 38}, {10, 39}, {14, 39}, {18, 39}, {22, 40}, {26, 40}, {30, 40}, {34, 41}, {38, 41}, {40, 41}, {44, 42}, {48, 42}, {52, 42}, {56, 43}, {60, 43}, {64, 43}, {68, 44}, {72, 44}, {76, 44} },
-    { {2, 39}, {6, 40}, {10, 40}, {14, 40}, {18, 40}, {22, 40}, {26, 40}, {30, 41}, {34, 41}, {38, 41}, {40, 41}, {44, 41}, {48, 41}, {52, 42}, {56, 42}, {60, 42}, {64, 42}, {68, 42}, {72, 42}, {76, 43} },
-    { {2, 41}, {6, 41}, {10, 41}, {14, 41}, {18, 41}, {22, 41}, {26, 41}, {30, 41}, {34, 41}, {38, 41}, {40, 41}, {44, 41}, {48, 41}, {52, 41}, {56, 41}, {60, 41}, {64, 41}, {68, 41}, {72, 41}, {76, 41} },
-    { {2, 43}, {6, 42}, {10, 42}, {14, 42}, {18, 42}, {22, 42}, {26, 42}, {30, 41}, {34, 41}, {38, 41}, {40, 41}, {44, 41}, {48, 41}, {52, 40}, {56, 40}, {60, 40}, {64, 40}, {68, 40}, {72, 40}, {76, 39} },
-    { {2, 44}, {6, 44}, {10, 43}, {14, 43}, {18, 43}, {22, 42}, {26, 42}, {30, 42}, {34, 41}, {38, 41}, {40, 41}, {44, 40}, {48, 40}, {52, 40}, {56, 39}, {60, 39}, {64, 39}, {68, 38}, {72, 38}, {76, 38} },
-    { {2, 46}, {6, 45}, {10, 45}, {14, 44}, {18, 44}, {22, 43}, {26, 43}, {30, 42}, {34, 42}, {38, 41}, {40, 41}, {44, 40}, {48, 40}, {52, 39}, {56, 39}, {60, 38}, {64, 38}, {68, 37}, {72, 37}, {76, 36} },
-    { {3, 47}, {6, 46}, {10, 46}, {14, 45}, {18, 44}, {22, 44}, {26, 43}, {30, 42}, {34, 42}, {38, 41}, {40, 41}, {44, 40}, {48, 39}, {52, 39}, {56, 38}, {60, 37}, {64, 37}, {68, 36}, {72, 35}, {75, 35} },
-    { {3, 48}, {7, 48}, {11, 47}, {15, 46}, {18, 45}, {22, 44}, {26, 43}, {30, 43}, {34, 42}, {38, 41}, {40, 41}, {44, 40}, {48, 39}, {52, 38}, {56, 37}, {60, 36}, {63, 36}, {67, 35}, {71, 34}, {75, 33} },
-    { {3, 50}, {7, 49}, {11, 48}, {15, 47}, {19, 46}, {23, 45}, {26, 44}, {30, 43}, {34, 42}, {38, 41}, {40, 41}, {44, 40}, {48, 39}, {52, 38}, {55, 37}, {59, 36}, {63, 35}, {67, 34}, {71, 33}, {75, 32} },
-    { {4, 51}, {7, 50}, {11, 49}, {15, 48}, {19, 47}, {23, 46}, {27, 44}, {30, 43}, {34, 42}, {38, 41}, {40, 40}, {44, 39}, {48, 38}, {51, 37}, {55, 36}, {59, 35}, {63, 33}, {67, 32}, {71, 31}, {74, 30} },
-    { {4, 53}, {8, 52}, {12, 50}, {15, 49}, {19, 48}, {23, 46}, {27, 45}, {30, 44}, {34, 42}, {38, 41}, {40, 40}, {44, 39}, {47, 38}, {51, 36}, {55, 35}, {59, 34}, {63, 32}, {66, 31}, {70, 30}, {74, 29} },
-    { {5, 54}, {8, 53}, {12, 51}, {16, 50}, {19, 48}, {23, 47}, {27, 45}, {31, 44}, {34, 42}, {38, 41}, {40, 40}, {44, 39}, {47, 37}, {51, 36}, {55, 34}, {58, 33}, {62, 31}, {66, 30}, {70, 28}, {73, 27} },
-    { {5, 56}, {9, 54}, {12, 52}, {16, 51}, {20, 49}, {23, 48}, {27, 46}, {31, 44}, {34, 43}, {38, 41}, {40, 40}, {43, 39}, {47, 37}, {51, 35}, {54, 34}, {58, 32}, {62, 30}, {65, 29}, {69, 27}, {73, 26} },
-    { {6, 57}, {9, 55}, {13, 53}, {17, 52}, {20, 50}, {24, 48}, {27, 46}, {31, 45}, {34, 43}, {38, 41}, {40, 40}, {43, 38}, {47, 37}, {51, 35}, {54, 33}, {58, 31}, {61, 29}, {65, 28}, {68, 26}, {72, 24} },
-    { {6, 58}, {10, 56}, {13, 54}, {17, 53}, {20, 51}, {24, 49}, {27, 47}, {31, 45}, {34, 43}, {38, 41}, {40, 40}, {43, 38}, {47, 36}, {50, 34}, {54, 32}, {57, 30}, {61, 28}, {64, 27}, {68, 25}, {71, 23} },
-    { {7, 60}, {11, 58}, {14, 56}, {17, 53}, {21, 51}, {24, 49}, {28, 47}, {31, 45}, {35, 43}, {38, 41}, {40, 40}, {43, 38}, {47, 36}, {50, 34}, {53, 32}, {57, 30}, {60, 28}, {64, 25}, {67, 23}, {71, 21} },
-    { {8, 61}, {11, 59}, {15, 56}, {18, 54}, {21, 52}, {25, 50}, {28, 48}, {31, 45}, {35, 43}, {38, 41}, {40, 40}, {43, 38}, {46, 35}, {50, 33}, {53, 31}, {56, 29}, {60, 27}, {63, 24}, {66, 22}, {70, 20} },
-    { {9, 62}, {12, 60}, {15, 57}, {19, 55}, {22, 53}, {25, 50}, {28, 48}, {32, 46}, {35, 43}, {38, 41}, {40, 40}, {43, 37}, {46, 35}, {49, 33}, {53, 30}, {56, 28}, {59, 26}, {62, 23}, {66, 21}, {69, 19} },
-    { {10, 63}, {13, 61}, {16, 58}, {19, 56}, {22, 53}, {25, 51}, {29, 48}, {32, 46}, {35, 43}, {38, 41}, {40, 40}, {43, 37}, {46, 35}, {49,32}, {52, 30}, {55, 27}, {58, 25}, {62, 22}, {65, 20}, {68, 17} },
-    { {11, 65}, {14, 62}, {17, 59}, {20, 57}, {23, 54}, {26, 51}, {29, 49}, {32, 46}, {35, 44}, {38, 41}, {40, 40}, {43, 37}, {46, 34}, {49,32}, {52, 29}, {55, 27}, {58, 24}, {61, 21}, {64, 19}, {67, 16} },
-    { {12, 66}, {15, 63}, {18, 60}, {21, 57}, {23, 55}, {26, 52}, {29, 49}, {32, 46}, {35, 44}, {38, 41}, {39, 40}, {42, 37}, {45, 34}, {48,31}, {51, 29}, {54, 26}, {57, 23}, {60, 20}, {63, 18}, {66, 15} },
-    { {13, 67}, {16, 64}, {18, 61}, {21, 58}, {24, 55}, {27, 52}, {30, 50}, {32, 47}, {35, 44}, {38, 41}, {39, 40}, {42, 37}, {45, 34}, {48,31}, {51, 28}, {53, 25}, {56, 22}, {59, 20}, {62, 17}, {65, 14} },
-    { {14, 68}, {17, 65}, {19, 62}, {22, 59}, {25, 56}, {27, 53}, {30, 50}, {33, 47}, {35, 44}, {38, 41}, {39, 40}, {42, 37}, {45, 34}, {47,31}, {50, 28}, {53, 25}, {55, 22}, {58, 19}, {61, 16}, {63, 13} },
-    { {15, 69}, {18, 66}, {20, 63}, {23, 59}, {25, 56}, {28, 53}, {30, 50}, {33, 47}, {35, 44}, {38, 41}, {39, 39}, {42, 36}, {44, 33}, {47,30}, {49, 27}, {52, 24}, {55, 21}, {57, 18}, {60, 15}, {62, 12} },
-    { {16, 70}, {19, 66}, {21, 63}, {23, 60}, {26, 57}, {28, 54}, {31, 51}, {33, 47}, {36, 44}, {38, 41}, {39, 39}, {42, 36}, {44, 33}, {46,30}, {49, 27}, {51, 23}, {54, 20}, {56, 17}, {59, 14}, {61, 11} },
-    { {17, 71}, {20, 67}, {22, 64}, {24, 61}, {27, 57}, {29, 54}, {31, 51}, {33, 48}, {36, 44}, {38, 41}, {39, 39}, {41, 36}, {44, 33}, {46,30}, {48, 26}, {51, 23}, {53, 20}, {55, 16}, {57, 13}, {60, 10} },
-    { {19, 71}, {21, 68}, {23, 65}, {25, 61}, {27, 58}, {29, 55}, {32, 51}, {34, 48}, {36, 44}, {38, 41}, {39, 39}, {41, 36}, {43, 33}, {46,29}, {48, 26}, {50, 22}, {52, 19}, {54, 16}, {56, 12}, {58, 9} },
-    { {20, 72}, {22, 69}, {24, 65}, {26, 62}, {28, 58}, {30, 55}, {32, 51}, {34, 48}, {36, 44}, {38, 41}, {39, 39}, {41, 36}, {43, 32}, {45,29}, {47, 25}, {49, 22}, {51, 18}, {53, 15}, {55, 12}, {57, 8} },
-    { {21, 73}, {23, 69}, {25, 66}, {27, 62}, {29, 59}, {31, 55}, {32, 52}, {34, 48}, {36, 45}, {38, 41}, {39, 39}, {41, 36}, {43, 32}, {44,29}, {46, 25}, {48, 22}, {50, 18}, {52, 14}, {54, 11}, {56, 7} },
-    { {23, 74}, {24, 70}, {26, 66}, {28, 63}, {29, 59}, {31, 55}, {33, 52}, {35, 48}, {36, 45}, {38, 41}, {39, 39}, {41, 36}, {42, 32}, {44,28}, {46, 25}, {47, 21}, {49, 17}, {51, 14}, {52, 10}, {54, 7} },
-    { {24, 74}, {26, 70}, {27, 67}, {29, 63}, {30, 59}, {32, 56}, {33, 52}, {35, 48}, {36, 45}, {38, 41}, {39, 39}, {40, 35}, {42, 32}, {43,28}, {45, 24}, {47, 21}, {48, 17}, {50, 13}, {51, 10}, {53, 6} },
-    { {25, 75}, {27, 71}, {28, 67}, {30, 63}, {31, 60}, {32, 56}, {34, 52}, {35, 48}, {37, 45}, {38, 41}, {39, 39}, {40, 35}, {41, 32}, {43,28}, {44, 24}, {46, 20}, {47, 17}, {48, 13}, {50, 9}, {51, 5} },
-    { {27, 75}, {28, 71}, {29, 68}, {31, 64}, {32, 60}, {33, 56}, {34, 52}, {36, 49}, {37, 45}, {38, 41}, {39, 39}, {40, 35}, {41, 31}, {42,28}, {44, 24}, {45, 20}, {46, 16}, {47, 12}, {49, 9}, {50, 5} },
-    { {28, 76}, {29, 72}, {30, 68}, {32, 64}, {33, 60}, {34, 56}, {35, 53}, {36, 49}, {37, 45}, {38, 41}, {39, 39}, {40, 35}, {41, 31}, {42,28}, {43, 24}, {44, 20}, {45, 16}, {46, 12}, {47, 8}, {48, 4} },
-    { {30, 76}, {31, 72}, {32, 68}, {33, 64}, {33, 60}, {34, 57}, {35, 53}, {36, 49}, {37, 45}, {38, 41}, {38, 39}, {39, 35}, {40, 31}, {41,27}, {42, 23}, {43, 20}, {44, 16}, {45, 12}, {46, 8}, {47, 4} },
-    { {31, 76}, {32, 72}, {33, 69}, {34, 65}, {34, 61}, {35, 57}, {36, 53}, {37, 49}, {37, 45}, {38, 41}, {38, 39}, {39, 35}, {40, 31}, {41,27}, {41, 23}, {42, 19}, {43, 15}, {44, 12}, {44, 8}, {45, 4} },
-    { {33, 77}, {33, 73}, {34, 69}, {34, 65}, {35, 61}, {36, 57}, {36, 53}, {37, 49}, {37, 45}, {38, 41}, {38, 39}, {39, 35}, {39, 31}, {40,27}, {41, 23}, {41, 19}, {42, 15}, {42, 11}, {43, 7}, {44, 3} },
-    { {34, 77}, {35, 73}, {35, 69}, {35, 65}, {36, 61}, {36, 57}, {37, 53}, {37, 49}, {38, 45}, {38, 41}, {38, 39}, {39, 35}, {39, 31}, {39,27}, {40, 23}, {40, 19}, {41, 15}, {41, 11}, {42, 7}, {42, 3} },
-    { {36, 77}, {36, 73}, {36, 69}, {36, 65}, {37, 61}, {37, 57}, {37, 53}, {37, 49}, {38, 45}, {38, 41}, {38, 39}, {38, 35}, {39, 31}, {39,27}, {39, 23}, {39, 19}, {40, 15}, {40, 11}, {40, 7}, {40, 3} },
-    { {37, 77}, {37, 73}, {37, 69}, {37, 65}, {38, 61}, {38, 57}, {38, 53}, {38, 49}, {38, 45}, {38, 41}, {38, 39}, {38, 35}, {38, 31}, {38,27}, {38, 23}, {38, 19}, {39, 15}, {39, 11}, {39, 7}, {39, 3} }
-};
-
-unsigned char TAFI_FB_LED_BRIGHTNESS_LUT[256][TAFI_SECTOR_LED_COUNT] = 
-{
-    { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 },
-    { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1 },
-    { 1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 1, 2 },
-    { 2, 2, 2, 2, 2, 1, 1, 1, 1, 1, 1, 1, 1, 1, 2, 2, 2, 2, 2, 3 },
-    { 3, 3, 3, 3, 2, 2, 2, 2, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 4 },
-    { 4, 4, 4, 3, 3, 3, 2, 2, 2, 1, 2, 2, 2, 3, 3, 3, 4, 4, 4, 5 },
-    { 5, 5, 5, 4, 4, 3, 3, 3, 2, 2, 2, 2, 3, 3, 4, 4, 4, 5, 5, 6 },
-    { 6, 6, 5, 5, 4, 4, 3, 3, 3, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7 },
-    { 7, 7, 6, 6, 5, 5, 4, 4, 3, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 8 },
-    { 8, 8, 7, 6, 6, 5, 5, 4, 3, 3, 3, 4, 4, 5, 6, 6, 7, 7, 8, 9 },
-    { 9, 9, 8, 7, 7, 6, 5, 5, 4, 3, 4, 4, 5, 6, 6, 7, 8, 8, 9, 10 },
-    { 10, 9, 9, 8, 7, 6, 6, 5, 4, 4, 4, 5, 5, 6, 7, 8, 8, 9, 10, 11 },
-    { 11, 10, 10, 9, 8, 7, 6, 6, 5, 4, 4, 5, 6, 7, 8, 8, 9, 10, 11, 12 },
-    { 12, 11, 10, 9, 9, 8, 7, 6, 5, 4, 5, 6, 6, 7, 8, 9, 10, 11, 12, 13 },
-    { 13, 12, 11, 10, 9, 8, 7, 7, 6, 5, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14 },
-    { 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15 },
-    { 15, 14, 13, 12, 11, 10, 9, 8, 6, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 16 },
-    { 16, 15, 14, 13, 11, 10, 9, 8, 7, 6, 6, 7, 9, 10, 11, 12, 13, 14, 15, 17 },
-    { 17, 16, 15, 13, 12, 11, 10, 9, 7, 6, 7, 8, 9, 10, 12, 13, 14, 15, 16, 18 },
-    { 18, 17, 15, 14, 13, 12, 10, 9, 8, 6, 7, 8, 10, 11, 12, 13, 15, 16, 17, 19 },
-    { 19, 18, 16, 15, 14, 12, 11, 10, 8, 7, 8, 9, 10, 12, 13, 14, 16, 17, 18, 20 },
-    { 20, 18, 17, 16, 14, 13, 11, 10, 9, 7, 8, 9, 11, 12, 14, 15, 16, 18, 19, 21 },
-    { 21, 19, 18, 16, 15, 13, 12, 11, 9, 8, 8, 10, 11, 13, 14, 16, 17, 19, 20, 22 },
-    { 22, 20, 19, 17, 16, 14, 13, 11, 9, 8, 9, 10, 12, 13, 15, 16, 18, 19, 21, 23 },
-    { 23, 21, 20, 18, 16, 15, 13, 12, 10, 8, 9, 11, 12, 14, 16, 17, 19, 20, 22, 24 },
-    { 24, 22, 20, 19, 17, 15, 14, 12, 10, 9, 10, 11, 13, 15, 16, 18, 20, 21, 23, 25 },
-    { 25, 23, 21, 19, 18, 16, 14, 13, 11, 9, 10, 12, 13, 15, 17, 19, 20, 22, 24, 26 },
-    { 26, 24, 22, 20, 18, 17, 15, 13, 11, 9, 10, 12, 14, 16, 18, 19, 21, 23, 25, 27 },
-    { 27, 25, 23, 21, 19, 17, 15, 14, 12, 10, 11, 13, 14, 16, 18, 20, 22, 24, 26, 28 },
-    { 28, 26, 24, 22, 20, 18, 16, 14, 12, 10, 11, 13, 15, 17, 19, 21, 23, 25, 27, 29 },
-    { 29, 27, 25, 23, 21, 19, 17, 15, 13, 11, 12, 14, 16, 18, 20, 22, 24, 26, 28, 30 },
-    { 29, 27, 25, 23, 21, 19, 17, 15, 13, 11, 12, 14, 16, 18, 20, 22, 24, 26, 28, 31 },
-    { 30, 28, 26, 24, 22, 20, 18, 16, 13, 11, 12, 14, 17, 19, 21, 23, 25, 27, 29, 32 },
-    { 31, 29, 27, 25, 23, 20, 18, 16, 14, 12, 13, 15, 17, 19, 22, 24, 26, 28, 30, 33 },
-    { 32, 30, 28, 26, 23, 21, 19, 17, 14, 12, 13, 15, 18, 20, 22, 24, 27, 29, 31, 34 },
-    { 33, 31, 29, 26, 24, 22, 19, 17, 15, 12, 14, 16, 18, 21, 23, 25, 28, 30, 32, 35 },
-    { 34, 32, 30, 27, 25, 22, 20, 18, 15, 13, 14, 16, 19, 21, 24, 26, 28, 31, 33, 36 },
-    { 35, 33, 30, 28, 25, 23, 20, 18, 16, 13, 14, 17, 19, 22, 24, 27, 29, 32, 34, 37 },
-    { 36, 34, 31, 29, 26, 24, 21, 19, 16, 13, 15, 17, 20, 22, 25, 27, 30, 32, 35, 38 },
-    { 37, 35, 32, 29, 27, 24, 22, 19, 16, 14, 15, 18, 20, 23, 26, 28, 31, 33, 36, 39 },
-    { 38, 36, 33, 30, 28, 25, 22, 20, 17, 14, 16, 18, 21, 24, 26, 29, 32, 34, 37, 40 },
-    { 39, 36, 34, 31, 28, 25, 23, 20, 17, 15, 16, 19, 21, 24, 27, 30, 32, 35, 38, 41 },
-    { 40, 37, 35, 32, 29, 26, 23, 21, 18, 15, 16, 19, 22, 25, 28, 30, 33, 36, 39, 42 },
-    { 41, 38, 35, 32, 30, 27, 24, 21, 18, 15, 17, 20, 22, 25, 28, 31, 34, 37, 40, 43 },
-    { 42, 39, 36, 33, 30, 27, 24, 22, 19, 16, 17, 20, 23, 26, 29, 32, 35, 38, 41, 44 },
-    { 43, 40, 37, 34, 31, 28, 25, 22, 19, 16, 18, 21, 24, 27, 30, 33, 36, 39, 42, 45 },
-    { 44, 41, 38, 35, 32, 29, 26, 23, 19, 16, 18, 21, 24, 27, 30, 33, 36, 39, 42, 46 },
-    { 45, 42, 39, 36, 32, 29, 26, 23, 20, 17, 18, 21, 25, 28, 31, 34, 37, 40, 43, 47 },
-    { 46, 43, 40, 36, 33, 30, 27, 24, 20, 17, 19, 22, 25, 28, 32, 35, 38, 41, 44, 48 },
-    { 47, 44, 40, 37, 34, 31, 27, 24, 21, 17, 19, 22, 26, 29, 32, 35, 39, 42, 45, 49 },
-    { 48, 45, 41, 38, 35, 31, 28, 25, 21, 18, 20, 23, 26, 30, 33, 36, 40, 43, 46, 50 },
-    { 49, 45, 42, 39, 35, 32, 28, 25, 22, 18, 20, 23, 27, 30, 34, 37, 40, 44, 47, 51 },
-    { 50, 46, 43, 39, 36, 32, 29, 26, 22, 19, 20, 24, 27, 31, 34, 38, 41, 45, 48, 52 },
-    { 51, 47, 44, 40, 37, 33, 30, 26, 22, 19, 21, 24, 28, 31, 35, 38, 42, 45, 49, 53 },
-    { 52, 48, 45, 41, 37, 34, 30, 27, 23, 19, 21, 25, 28, 32, 36, 39, 43, 46, 50, 54 },
-    { 53, 49, 45, 42, 38, 34, 31, 27, 23, 20, 22, 25, 29, 33, 36, 40, 44, 47, 51, 55 },
-    { 54, 50, 46, 42, 39, 35, 31, 28, 24, 20, 22, 26, 29, 33, 37, 41, 44, 48, 52, 56 },
-    { 55, 51, 47, 43, 39, 36, 32, 28, 24, 20, 22, 26, 30, 34, 38, 41, 45, 49, 53, 57 },
-    { 56, 52, 48, 44, 40, 36, 32, 29, 25, 21, 23, 27, 30, 34, 38, 42, 46, 50, 54, 58 },
-    { 57, 53, 49, 45, 41, 37, 33, 29, 25, 21, 23, 27, 31, 35, 39, 43, 47, 51, 55, 59 },
-    { 58, 54, 50, 46, 42, 38, 34, 30, 26, 22, 24, 28, 32, 36, 40, 44, 48, 52, 56, 60 },
-    { 58, 54, 50, 46, 42, 38, 34, 30, 26, 22, 24, 28, 32, 36, 40, 44, 48, 52, 56, 61 },
-    { 59, 55, 51, 47, 43, 39, 35, 31, 26, 22, 24, 28, 33, 37, 41, 45, 49, 53, 57, 62 },
-    { 60, 56, 52, 48, 44, 39, 35, 31, 27, 23, 25, 29, 33, 37, 42, 46, 50, 54, 58, 63 },
-    { 61, 57, 53, 49, 44, 40, 36, 32, 27, 23, 25, 29, 34, 38, 42, 46, 51, 55, 59, 64 },
-    { 62, 58, 54, 49, 45, 41, 36, 32, 28, 23, 26, 30, 34, 39, 43, 47, 52, 56, 60, 65 },
-    { 63, 59, 55, 50, 46, 41, 37, 33, 28, 24, 26, 30, 35, 39, 44, 48, 52, 57, 61, 66 },
-    { 64, 60, 55, 51, 46, 42, 37, 33, 29, 24, 26, 31, 35, 40, 44, 49, 53, 58, 62, 67 },
-    { 65, 61, 56, 52, 47, 43, 38, 34, 29, 24, 27, 31, 36, 40, 45, 49, 54, 58, 63, 68 },
-    { 66, 62, 57, 52, 48, 43, 39, 34, 29, 25, 27, 32, 36, 41, 46, 50, 55, 59, 64, 69 },
-    { 67, 63, 58, 53, 49, 44, 39, 35, 30, 25, 28, 32, 37, 42, 46, 51, 56, 60, 65, 70 },
-    { 68, 63, 59, 54, 49, 44, 40, 35, 30, 26, 28, 33, 37, 42, 47, 52, 56, 61, 66, 71 },
-    { 69, 64, 60, 55, 50, 45, 40, 36, 31, 26, 28, 33, 38, 43, 48, 52, 57, 62, 67, 72 },
-    { 70, 65, 60, 55, 51, 46, 41, 36, 31, 26, 29, 34, 38, 43, 48, 53, 58, 63, 68, 73 },
-    { 71, 66, 61, 56, 51, 46, 41, 37, 32, 27, 29, 34, 39, 44, 49, 54, 59, 64, 69, 74 },
-    { 72, 67, 62, 57, 52, 47, 42, 37, 32, 27, 30, 35, 40, 45, 50, 54, 60, 65, 70, 75 },
-    { 73, 68, 63, 58, 53, 48, 43, 38, 32, 27, 30, 35, 40, 45, 50, 55, 60, 65, 70, 76 },
-    { 74, 69, 64, 59, 53, 48, 43, 38, 33, 28, 30, 35, 41, 46, 51, 56, 61, 66, 71, 77 },
-    { 75, 70, 65, 59, 54, 49, 44, 39, 33, 28, 31, 36, 41, 46, 52, 57, 62, 67, 72, 78 },
-    { 76, 71, 65, 60, 55, 50, 44, 39, 34, 28, 31, 36, 42, 47, 52, 57, 63, 68, 73, 79 },
-    { 77, 72, 66, 61, 56, 50, 45, 40, 34, 29, 32, 37, 42, 48, 53, 58, 64, 69, 74, 80 },
-    { 78, 72, 67, 62, 56, 51, 45, 40, 35, 29, 32, 37, 43, 48, 54, 59, 64, 70, 75, 81 },
-    { 79, 73, 68, 62, 57, 51, 46, 41, 35, 30, 32, 38, 43, 49, 54, 60, 65, 71, 76, 82 },
-    { 80, 74, 69, 63, 58, 52, 47, 41, 35, 30, 33, 38, 44, 49, 55, 60, 66, 71, 77, 83 },
-    { 81, 75, 70, 64, 58, 53, 47, 42, 36, 30, 33, 39, 44, 50, 56, 61, 67, 72, 78, 84 },
-    { 82, 76, 70, 65, 59, 53, 48, 42, 36, 31, 34, 39, 45, 51, 56, 62, 68, 73, 79, 85 },
-    { 83, 77, 71, 65, 60, 54, 48, 43, 37, 31, 34, 40, 45, 51, 57, 63, 68, 74, 80, 86 },
-    { 84, 78, 72, 66, 60, 55, 49, 43, 37, 31, 34, 40, 46, 52, 58, 63, 69, 75, 81, 87 },
-    { 85, 79, 73, 67, 61, 55, 49, 44, 38, 32, 35, 41, 46, 52, 58, 64, 70, 76, 82, 88 },
-    { 86, 80, 74, 68, 62, 56, 50, 44, 38, 32, 35, 41, 47, 53, 59, 65, 71, 77, 83, 89 },
-    { 87, 81, 75, 69, 62, 57, 51, 45, 39, 33, 36, 42, 48, 54, 60, 66, 72, 78, 84, 90 },
-    { 87, 81, 75, 69, 63, 57, 51, 45, 39, 33, 36, 42, 48, 54, 60, 66, 72, 78, 84, 91 },
-    { 88, 82, 76, 70, 64, 58, 52, 46, 39, 33, 36, 42, 49, 55, 61, 67, 73, 79, 85, 92 },
-    { 89, 83, 77, 71, 65, 58, 52, 46, 40, 34, 37, 43, 49, 55, 62, 68, 74, 80, 86, 93 },
-    { 90, 84, 78, 72, 65, 59, 53, 47, 40, 34, 37, 43, 50, 56, 62, 68, 75, 81, 87, 94 },
-    { 91, 85, 79, 72, 66, 60, 53, 47, 41, 34, 38, 44, 50, 57, 63, 69, 76, 82, 88, 95 },
-    { 92, 86, 80, 73, 67, 60, 54, 48, 41, 35, 38, 44, 51, 57, 64, 70, 76, 83, 89, 96 },
-    { 93, 87, 80, 74, 67, 61, 54, 48, 42, 35, 38, 45, 51, 58, 64, 71, 77, 84, 90, 97 },
-    { 94, 88, 81, 75, 68, 62, 55, 49, 42, 35, 39, 45, 52, 58, 65, 71, 78, 84, 91, 98 },
-    { 95, 89, 82, 75, 69, 62, 56, 49, 42, 36, 39, 46, 52, 59, 66, 72, 79, 85, 92, 99 },
-    { 96, 90, 83, 76, 70, 63, 56, 50, 43, 36, 40, 46, 53, 60, 66, 73, 80, 86, 93, 100 },
-    { 97, 90, 84, 77, 70, 63, 57, 50, 43, 37, 40, 47, 53, 60, 67, 74, 80, 87, 94, 101 },
-    { 98, 91, 85, 78, 71, 64, 57, 51, 44, 37, 40, 47, 54, 61, 68, 74, 81, 88, 95, 102 },
-    { 99, 92, 85, 78, 72, 65, 58, 51, 44, 37, 41, 48, 54, 61, 68, 75, 82, 89, 96, 103 },
-    { 100, 93, 86, 79, 72, 65, 58, 52, 45, 38, 41, 48, 55, 62, 69, 76, 83, 90, 97, 104 },
-    { 101, 94, 87, 80, 73, 66, 59, 52, 45, 38, 42, 49, 56, 63, 70, 77, 84, 91, 98, 105 },
-    { 102, 95, 88, 81, 74, 67, 60, 53, 45, 38, 42, 49, 56, 63, 70, 77, 84, 91, 98, 106 },
-    { 103, 96, 89, 82, 74, 67, 60, 53, 46, 39, 42, 49, 57, 64, 71, 78, 85, 92, 99, 107 },
-    { 104, 97, 90, 82, 75, 68, 61, 54, 46, 39, 43, 50, 57, 64, 72, 79, 86, 93, 100, 108 },
-    { 105, 98, 90, 83, 76, 69, 61, 54, 47, 39, 43, 50, 58, 65, 72, 79, 87, 94, 101, 109 },
-    { 106, 99, 91, 84, 77, 69, 62, 55, 47, 40, 44, 51, 58, 66, 73, 80, 88, 95, 102, 110 },
-    { 107, 99, 92, 85, 77, 70, 62, 55, 48, 40, 44, 51, 59, 66, 74, 81, 88, 96, 103, 111 },
-    { 108, 100, 93, 85, 78, 70, 63, 56, 48, 41, 44, 52, 59, 67, 74, 82, 89, 97, 104, 112 },
-    { 109, 101, 94, 86, 79, 71, 64, 56, 48, 41, 45, 52, 60, 67, 75, 82, 90, 97, 105, 113 },
-    { 110, 102, 95, 87, 79, 72, 64, 57, 49, 41, 45, 53, 60, 68, 76, 83, 91, 98, 106, 114 },
-    { 111, 103, 95, 88, 80, 72, 65, 57, 49, 42, 46, 53, 61, 69, 76, 84, 92, 99, 107, 115 },
-    { 112, 104, 96, 88, 81, 73, 65, 58, 50, 42, 46, 54, 61, 69, 77, 85, 92, 100, 108, 116 },
-    { 113, 105, 97, 89, 81, 74, 66, 58, 50, 42, 46, 54, 62, 70, 78, 85, 93, 101, 109, 117 },
-    { 114, 106, 98, 90, 82, 74, 66, 59, 51, 43, 47, 55, 62, 70, 78, 86, 94, 102, 110, 118 },
-    { 115, 107, 99, 91, 83, 75, 67, 59, 51, 43, 47, 55, 63, 71, 79, 87, 95, 103, 111, 119 },
-    { 116, 108, 100, 92, 84, 76, 68, 60, 52, 44, 48, 56, 64, 72, 80, 88, 96, 104, 112, 120 },
-    { 116, 108, 100, 92, 84, 76, 68, 60, 52, 44, 48, 56, 64, 72, 80, 88, 96, 104, 112, 121 },
-    { 117, 109, 101, 93, 85, 77, 69, 61, 52, 44, 48, 56, 65, 73, 81, 89, 97, 105, 113, 122 },
-    { 118, 110, 102, 94, 86, 77, 69, 61, 53, 45, 49, 57, 65, 73, 82, 90, 98, 106, 114, 123 },
-    { 119, 111, 103, 95, 86, 78, 70, 62, 53, 45, 49, 57, 66, 74, 82, 90, 99, 107, 115, 124 },
-    { 120, 112, 104, 95, 87, 79, 70, 62, 54, 45, 50, 58, 66, 75, 83, 91, 100, 108, 116, 125 },
-    { 121, 113, 105, 96, 88, 79, 71, 63, 54, 46, 50, 58, 67, 75, 84, 92, 100, 109, 117, 126 },
-    { 122, 114, 105, 97, 88, 80, 71, 63, 55, 46, 50, 59, 67, 76, 84, 93, 101, 110, 118, 127 },
-    { 123, 115, 106, 98, 89, 81, 72, 64, 55, 46, 51, 59, 68, 76, 85, 93, 102, 110, 119, 128 },
-    { 124, 116, 107, 98, 90, 81, 73, 64, 55, 47, 51, 60, 68, 77, 86, 94, 103, 111, 120, 129 },
-    { 125, 117, 108, 99, 91, 82, 73, 65, 56, 47, 52, 60, 69, 78, 86, 95, 104, 112, 121, 130 },
-    { 126, 117, 109, 100, 91, 82, 74, 65, 56, 48, 52, 61, 69, 78, 87, 96, 104, 113, 122, 131 },
-    { 127, 118, 110, 101, 92, 83, 74, 66, 57, 48, 52, 61, 70, 79, 88, 96, 105, 114, 123, 132 },
-    { 128, 119, 110, 101, 93, 84, 75, 66, 57, 48, 53, 62, 70, 79, 88, 97, 106, 115, 124, 133 },
-    { 129, 120, 111, 102, 93, 84, 75, 67, 58, 49, 53, 62, 71, 80, 89, 98, 107, 116, 125, 134 },
-    { 130, 121, 112, 103, 94, 85, 76, 67, 58, 49, 54, 63, 72, 81, 90, 99, 108, 117, 126, 135 },
-    { 131, 122, 113, 104, 95, 86, 77, 68, 58, 49, 54, 63, 72, 81, 90, 99, 108, 117, 126, 136 },
-    { 132, 123, 114, 105, 95, 86, 77, 68, 59, 50, 54, 63, 73, 82, 91, 100, 109, 118, 127, 137 },
-    { 133, 124, 115, 105, 96, 87, 78, 69, 59, 50, 55, 64, 73, 82, 92, 101, 110, 119, 128, 138 },
-    { 134, 125, 115, 106, 97, 88, 78, 69, 60, 50, 55, 64, 74, 83, 92, 101, 111, 120, 129, 139 },
-    { 135, 126, 116, 107, 98, 88, 79, 70, 60, 51, 56, 65, 74, 84, 93, 102, 112, 121, 130, 140 },
-    { 136, 126, 117, 108, 98, 89, 79, 70, 61, 51, 56, 65, 75, 84, 94, 103, 112, 122, 131, 141 },
-    { 137, 127, 118, 108, 99, 89, 80, 71, 61, 52, 56, 66, 75, 85, 94, 104, 113, 123, 132, 142 },
-    { 138, 128, 119, 109, 100, 90, 81, 71, 61, 52, 57, 66, 76, 85, 95, 104, 114, 123, 133, 143 },
-    { 139, 129, 120, 110, 100, 91, 81, 72, 62, 52, 57, 67, 76, 86, 96, 105, 115, 124, 134, 144 },
-    { 140, 130, 120, 111, 101, 91, 82, 72, 62, 53, 58, 67, 77, 87, 96, 106, 116, 125, 135, 145 },
-    { 141, 131, 121, 111, 102, 92, 82, 73, 63, 53, 58, 68, 77, 87, 97, 107, 116, 126, 136, 146 },
-    { 142, 132, 122, 112, 102, 93, 83, 73, 63, 53, 58, 68, 78, 88, 98, 107, 117, 127, 137, 147 },
-    { 143, 133, 123, 113, 103, 93, 83, 74, 64, 54, 59, 69, 78, 88, 98, 108, 118, 128, 138, 148 },
-    { 144, 134, 124, 114, 104, 94, 84, 74, 64, 54, 59, 69, 79, 89, 99, 109, 119, 129, 139, 149 },
-    { 145, 135, 125, 115, 105, 95, 85, 75, 65, 54, 60, 70, 80, 90, 100, 109, 120, 130, 140, 150 },
-    { 145, 135, 125, 115, 105, 95, 85, 75, 65, 55, 60, 70, 80, 90, 100, 110, 120, 130, 140, 151 },
-    { 146, 136, 126, 116, 106, 96, 86, 76, 65, 55, 60, 70, 81, 91, 101, 111, 121, 131, 141, 152 },
-    { 147, 137, 127, 117, 107, 96, 86, 76, 66, 56, 61, 71, 81, 91, 102, 112, 122, 132, 142, 153 },
-    { 148, 138, 128, 118, 107, 97, 87, 77, 66, 56, 61, 71, 82, 92, 102, 112, 123, 133, 143, 154 },
-    { 149, 139, 129, 118, 108, 98, 87, 77, 67, 56, 62, 72, 82, 93, 103, 113, 124, 134, 144, 155 },
-    { 150, 140, 130, 119, 109, 98, 88, 78, 67, 57, 62, 72, 83, 93, 104, 114, 124, 135, 145, 156 },
-    { 151, 141, 130, 120, 109, 99, 88, 78, 68, 57, 62, 73, 83, 94, 104, 115, 125, 136, 146, 157 },
-    { 152, 142, 131, 121, 110, 100, 89, 79, 68, 57, 63, 73, 84, 94, 105, 115, 126, 136, 147, 158 },
-    { 153, 143, 132, 121, 111, 100, 90, 79, 68, 58, 63, 74, 84, 95, 106, 116, 127, 137, 148, 159 },
-    { 154, 144, 133, 122, 112, 101, 90, 80, 69, 58, 64, 74, 85, 96, 106, 117, 128, 138, 149, 160 },
-    { 155, 144, 134, 123, 112, 101, 91, 80, 69, 59, 64, 75, 85, 96, 107, 118, 128, 139, 150, 161 },
-    { 156, 145, 135, 124, 113, 102, 91, 81, 70, 59, 64, 75, 86, 97, 108, 118, 129, 140, 151, 162 },
-    { 157, 146, 135, 124, 114, 103, 92, 81, 70, 59, 65, 76, 86, 97, 108, 119, 130, 141, 152, 163 },
-    { 158, 147, 136, 125, 114, 103, 92, 82, 71, 60, 65, 76, 87, 98, 109, 120, 131, 142, 153, 164 },
-    { 159, 148, 137, 126, 115, 104, 93, 82, 71, 60, 66, 77, 88, 99, 110, 120, 132, 143, 154, 165 },
-    { 160, 149, 138, 127, 116, 105, 94, 83, 71, 60, 66, 77, 88, 99, 110, 121, 132, 143, 154, 166 },
-    { 161, 150, 139, 128, 116, 105, 94, 83, 72, 61, 66, 77, 89, 100, 111, 122, 133, 144, 155, 167 },
-    { 162, 151, 140, 128, 117, 106, 95, 84, 72, 61, 67, 78, 89, 100, 112, 123, 134, 145, 156, 168 },
-    { 163, 152, 140, 129, 118, 107, 95, 84, 73, 61, 67, 78, 90, 101, 112, 123, 135, 146, 157, 169 },
-    { 164, 153, 141, 130, 118, 107, 96, 85, 73, 62, 68, 79, 90, 102, 113, 124, 136, 147, 158, 170 },
-    { 165, 153, 142, 131, 119, 108, 96, 85, 74, 62, 68, 79, 91, 102, 114, 125, 136, 148, 159, 171 },
-    { 166, 154, 143, 131, 120, 108, 97, 86, 74, 63, 68, 80, 91, 103, 114, 126, 137, 149, 160, 172 },
-    { 167, 155, 144, 132, 121, 109, 98, 86, 74, 63, 69, 80, 92, 103, 115, 126, 138, 149, 161, 173 },
-    { 168, 156, 145, 133, 121, 110, 98, 87, 75, 63, 69, 81, 92, 104, 116, 127, 139, 150, 162, 174 },
-    { 169, 157, 145, 134, 122, 110, 99, 87, 75, 64, 70, 81, 93, 105, 116, 128, 140, 151, 163, 175 },
-    { 170, 158, 146, 134, 123, 111, 99, 88, 76, 64, 70, 82, 93, 105, 117, 129, 140, 152, 164, 176 },
-    { 171, 159, 147, 135, 123, 112, 100, 88, 76, 64, 70, 82, 94, 106, 118, 129, 141, 153, 165, 177 },
-    { 172, 160, 148, 136, 124, 112, 100, 89, 77, 65, 71, 83, 94, 106, 118, 130, 142, 154, 166, 178 },
-    { 173, 161, 149, 137, 125, 113, 101, 89, 77, 65, 71, 83, 95, 107, 119, 131, 143, 155, 167, 179 },
-    { 174, 162, 150, 138, 125, 114, 102, 90, 78, 66, 72, 84, 96, 108, 120, 132, 144, 156, 168, 180 },
-    { 174, 162, 150, 138, 126, 114, 102, 90, 78, 66, 72, 84, 96, 108, 120, 132, 144, 156, 168, 181 },
-    { 175, 163, 151, 139, 127, 115, 103, 91, 78, 66, 72, 84, 97, 109, 121, 133, 145, 157, 169, 182 },
-    { 176, 164, 152, 140, 128, 115, 103, 91, 79, 67, 73, 85, 97, 109, 122, 134, 146, 158, 170, 183 },
-    { 177, 165, 153, 141, 128, 116, 104, 92, 79, 67, 73, 85, 98, 110, 122, 134, 147, 159, 171, 184 },
-    { 178, 166, 154, 141, 129, 117, 104, 92, 80, 67, 74, 86, 98, 111, 123, 135, 148, 160, 172, 185 },
-    { 179, 167, 155, 142, 130, 117, 105, 93, 80, 68, 74, 86, 99, 111, 124, 136, 148, 161, 173, 186 },
-    { 180, 168, 155, 143, 130, 118, 105, 93, 81, 68, 74, 87, 99, 112, 124, 137, 149, 162, 174, 187 },
-    { 181, 169, 156, 144, 131, 119, 106, 94, 81, 68, 75, 87, 100, 112, 125, 137, 150, 162, 175, 188 },
-    { 182, 170, 157, 144, 132, 119, 107, 94, 81, 69, 75, 88, 100, 113, 126, 138, 151, 163, 176, 189 },
-    { 183, 171, 158, 145, 133, 120, 107, 95, 82, 69, 76, 88, 101, 114, 126, 139, 152, 164, 177, 190 },
-    { 184, 171, 159, 146, 133, 120, 108, 95, 82, 70, 76, 89, 101, 114, 127, 140, 152, 165, 178, 191 },
-    { 185, 172, 160, 147, 134, 121, 108, 96, 83, 70, 76, 89, 102, 115, 128, 140, 153, 166, 179, 192 },
-    { 186, 173, 160, 147, 135, 122, 109, 96, 83, 70, 77, 90, 102, 115, 128, 141, 154, 167, 180, 193 },
-    { 187, 174, 161, 148, 135, 122, 109, 97, 84, 71, 77, 90, 103, 116, 129, 142, 155, 168, 181, 194 },
-    { 188, 175, 162, 149, 136, 123, 110, 97, 84, 71, 78, 91, 104, 117, 130, 143, 156, 169, 182, 195 },
-    { 189, 176, 163, 150, 137, 124, 111, 98, 84, 71, 78, 91, 104, 117, 130, 143, 156, 169, 182, 196 },
-    { 190, 177, 164, 151, 137, 124, 111, 98, 85, 72, 78, 91, 105, 118, 131, 144, 157, 170, 183, 197 },
-    { 191, 178, 165, 151, 138, 125, 112, 99, 85, 72, 79, 92, 105, 118, 132, 145, 158, 171, 184, 198 },
-    { 192, 179, 165, 152, 139, 126, 112, 99, 86, 72, 79, 92, 106, 119, 132, 145, 159, 172, 185, 199 },
-    { 193, 180, 166, 153, 140, 126, 113, 100, 86, 73, 80, 93, 106, 120, 133, 146, 160, 173, 186, 200 },
-    { 194, 180, 167, 154, 140, 127, 113, 100, 87, 73, 80, 93, 107, 120, 134, 147, 160, 174, 187, 201 },
-    { 195, 181, 168, 154, 141, 127, 114, 101, 87, 74, 80, 94, 107, 121, 134, 148, 161, 175, 188, 202 },
-    { 196, 182, 169, 155, 142, 128, 115, 101, 87, 74, 81, 94, 108, 121, 135, 148, 162, 175, 189, 203 },
-    { 197, 183, 170, 156, 142, 129, 115, 102, 88, 74, 81, 95, 108, 122, 136, 149, 163, 176, 190, 204 },
-    { 198, 184, 170, 157, 143, 129, 116, 102, 88, 75, 82, 95, 109, 123, 136, 150, 164, 177, 191, 205 },
-    { 199, 185, 171, 157, 144, 130, 116, 103, 89, 75, 82, 96, 109, 123, 137, 151, 164, 178, 192, 206 },
-    { 200, 186, 172, 158, 144, 131, 117, 103, 89, 75, 82, 96, 110, 124, 138, 151, 165, 179, 193, 207 },
-    { 201, 187, 173, 159, 145, 131, 117, 104, 90, 76, 83, 97, 110, 124, 138, 152, 166, 180, 194, 208 },
-    { 202, 188, 174, 160, 146, 132, 118, 104, 90, 76, 83, 97, 111, 125, 139, 153, 167, 181, 195, 209 },
-    { 203, 189, 175, 161, 147, 133, 119, 105, 91, 77, 84, 98, 112, 126, 140, 154, 168, 182, 196, 210 },
-    { 203, 189, 175, 161, 147, 133, 119, 105, 91, 77, 84, 98, 112, 126, 140, 154, 168, 182, 196, 211 },
-    { 204, 190, 176, 162, 148, 134, 120, 106, 91, 77, 84, 98, 113, 127, 141, 155, 169, 183, 197, 212 },
-    { 205, 191, 177, 163, 149, 134, 120, 106, 92, 78, 85, 99, 113, 127, 142, 156, 170, 184, 198, 213 },
-    { 206, 192, 178, 164, 149, 135, 121, 107, 92, 78, 85, 99, 114, 128, 142, 156, 171, 185, 199, 214 },
-    { 207, 193, 179, 164, 150, 136, 121, 107, 93, 78, 86, 100, 114, 129, 143, 157, 172, 186, 200, 215 },
-    { 208, 194, 180, 165, 151, 136, 122, 108, 93, 79, 86, 100, 115, 129, 144, 158, 172, 187, 201, 216 },
-    { 209, 195, 180, 166, 151, 137, 122, 108, 94, 79, 86, 101, 115, 130, 144, 159, 173, 188, 202, 217 },
-    { 210, 196, 181, 167, 152, 138, 123, 109, 94, 79, 87, 101, 116, 130, 145, 159, 174, 188, 203, 218 },
-    { 211, 197, 182, 167, 153, 138, 124, 109, 94, 80, 87, 102, 116, 131, 146, 160, 175, 189, 204, 219 },
-    { 212, 198, 183, 168, 154, 139, 124, 110, 95, 80, 88, 102, 117, 132, 146, 161, 176, 190, 205, 220 },
-    { 213, 198, 184, 169, 154, 139, 125, 110, 95, 81, 88, 103, 117, 132, 147, 162, 176, 191, 206, 221 },
-    { 214, 199, 185, 170, 155, 140, 125, 111, 96, 81, 88, 103, 118, 133, 148, 162, 177, 192, 207, 222 },
-    { 215, 200, 185, 170, 156, 141, 126, 111, 96, 81, 89, 104, 118, 133, 148, 163, 178, 193, 208, 223 },
-    { 216, 201, 186, 171, 156, 141, 126, 112, 97, 82, 89, 104, 119, 134, 149, 164, 179, 194, 209, 224 },
-    { 217, 202, 187, 172, 157, 142, 127, 112, 97, 82, 90, 105, 120, 135, 150, 165, 180, 195, 210, 225 },
-    { 218, 203, 188, 173, 158, 143, 128, 113, 97, 82, 90, 105, 120, 135, 150, 165, 180, 195, 210, 226 },
-    { 219, 204, 189, 174, 158, 143, 128, 113, 98, 83, 90, 105, 121, 136, 151, 166, 181, 196, 211, 227 },
-    { 220, 205, 190, 174, 159, 144, 129, 114, 98, 83, 91, 106, 121, 136, 152, 167, 182, 197, 212, 228 },
-    { 221, 206, 190, 175, 160, 145, 129, 114, 99, 83, 91, 106, 122, 137, 152, 167, 183, 198, 213, 229 },
-    { 222, 207, 191, 176, 161, 145, 130, 115, 99, 84, 92, 107, 122, 138, 153, 168, 184, 199, 214, 230 },
-    { 223, 207, 192, 177, 161, 146, 130, 115, 100, 84, 92, 107, 123, 138, 154, 169, 184, 200, 215, 231 },
-    { 224, 208, 193, 177, 162, 146, 131, 116, 100, 85, 92, 108, 123, 139, 154, 170, 185, 201, 216, 232 },
-    { 225, 209, 194, 178, 163, 147, 132, 116, 100, 85, 93, 108, 124, 139, 155, 170, 186, 201, 217, 233 },
-    { 226, 210, 195, 179, 163, 148, 132, 117, 101, 85, 93, 109, 124, 140, 156, 171, 187, 202, 218, 234 },
-    { 227, 211, 195, 180, 164, 148, 133, 117, 101, 86, 94, 109, 125, 141, 156, 172, 188, 203, 219, 235 },
-    { 228, 212, 196, 180, 165, 149, 133, 118, 102, 86, 94, 110, 125, 141, 157, 173, 188, 204, 220, 236 },
-    { 229, 213, 197, 181, 165, 150, 134, 118, 102, 86, 94, 110, 126, 142, 158, 173, 189, 205, 221, 237 },
-    { 230, 214, 198, 182, 166, 150, 134, 119, 103, 87, 95, 111, 126, 142, 158, 174, 190, 206, 222, 238 },
-    { 231, 215, 199, 183, 167, 151, 135, 119, 103, 87, 95, 111, 127, 143, 159, 175, 191, 207, 223, 239 },
-    { 232, 216, 200, 184, 168, 152, 136, 120, 104, 88, 96, 112, 128, 144, 160, 176, 192, 208, 224, 240 },
-    { 232, 216, 200, 184, 168, 152, 136, 120, 104, 88, 96, 112, 128, 144, 160, 176, 192, 208, 224, 241 },
-    { 233, 217, 201, 185, 169, 153, 137, 121, 104, 88, 96, 112, 129, 145, 161, 177, 193, 209, 225, 242 },
-    { 234, 218, 202, 186, 170, 153, 137, 121, 105, 89, 97, 113, 129, 145, 162, 178, 194, 210, 226, 243 },
-    { 235, 219, 203, 187, 170, 154, 138, 122, 105, 89, 97, 113, 130, 146, 162, 178, 195, 211, 227, 244 },
-    { 236, 220, 204, 187, 171, 155, 138, 122, 106, 89, 98, 114, 130, 147, 163, 179, 196, 212, 228, 245 },
-    { 237, 221, 205, 188, 172, 155, 139, 123, 106, 90, 98, 114, 131, 147, 164, 180, 196, 213, 229, 246 },
-    { 238, 222, 205, 189, 172, 156, 139, 123, 107, 90, 98, 115, 131, 148, 164, 181, 197, 214, 230, 247 },
-    { 239, 223, 206, 190, 173, 157, 140, 124, 107, 90, 99, 115, 132, 148, 165, 181, 198, 214, 231, 248 },
-    { 240, 224, 207, 190, 174, 157, 141, 124, 107, 91, 99, 116, 132, 149, 166, 182, 199, 215, 232, 249 },
-    { 241, 225, 208, 191, 175, 158, 141, 125, 108, 91, 100, 116, 133, 150, 166, 183, 200, 216, 233, 250 },
-    { 242, 225, 209, 192, 175, 158, 142, 125, 108, 92, 100, 117, 133, 150, 167, 184, 200, 217, 234, 251 },
-    { 243, 226, 210, 193, 176, 159, 142, 126, 109, 92, 100, 117, 134, 151, 168, 184, 201, 218, 235, 252 },
-    { 244, 227, 210, 193, 177, 160, 143, 126, 109, 92, 101, 118, 134, 151, 168, 185, 202, 219, 236, 253 },
-    { 245, 228, 211, 194, 177, 160, 143, 127, 110, 93, 101, 118, 135, 152, 169, 186, 203, 220, 237, 254 },
-    { 246, 229, 212, 195, 178, 161, 144, 127, 110, 93, 102, 119, 136, 153, 170, 187, 204, 221, 238, 255 }
-};
-
-
-#endif
\ No newline at end of file
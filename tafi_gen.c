@@ -0,0 +1,283 @@
+/**
+ *  tafi_gen.c -- The Amazing Fan Idea driver
+ *  Built-in pattern and load generator for stress and soak testing.
+ *
+ *  Writing a pattern name to <debugfs>/tafi/generator starts a kernel
+ *  thread producing frames of that pattern, "off" stops it. Frames are
+ *  published like any client's: replacing the last one, or queued FIFO
+ *  with generator_depth > 0 so none is ever dropped. generator_hz sets the
+ *  rate, 0 submits as fast as the submit path allows. Every frame carries
+ *  its sequence number, see tafi_gen.h, counted from 0 at every start.
+ *
+ *      (C) 2017 Harindu Perera
+ *
+ *  This file is subject to the terms and conditions of the GNU General Public
+ *  License. See the file COPYING in the main directory of this archive for
+ *  more details.
+ */
+
+#include <linux/fs.h>
+#include <linux/hrtimer.h>
+#include <linux/kthread.h>
+#include <linux/ktime.h>
+#include <linux/module.h>
+#include <linux/mutex.h>
+#include <linux/random.h>
+#include <linux/sched.h>
+#include <linux/string.h>
+#include <asm/uaccess.h>
+
+#include "tafi_common.h"
+#include "tafi_ioctl.h"
+#include "tafi_debugfs.h"
+#include "tafi_lut.h"
+#include "tafi_stats.h"
+#include "tafi_gen.h"
+
+#define TAFI_GEN_THREAD_NAME "tafi_gen"
+
+// Time between attempts to queue a frame while the FIFO is full.
+#define TAFI_GEN_RETRY_NS (NSEC_PER_MSEC)
+
+enum tafi_gen_pattern {
+    TAFI_GEN_OFF,
+    TAFI_GEN_GRADIENT,      // gradient rotating by one sector per frame
+    TAFI_GEN_COUNTER,       // every sector shows frame number + sector in binary
+    TAFI_GEN_NOISE,         // random bytes, reproducible from the frame number
+};
+
+static const char * const tafi_gen_pattern_names[] = {
+    [TAFI_GEN_OFF] = "off",
+    [TAFI_GEN_GRADIENT] = "gradient",
+    [TAFI_GEN_COUNTER] = "counter",
+    [TAFI_GEN_NOISE] = "noise",
+};
+
+// Frames per second, 0 = as fast as possible.
+static u32 tafi_gen_hz;
+// FIFO depth frames are queued with, 0 = replace the frame on display.
+static u32 tafi_gen_depth;
+
+static enum tafi_gen_pattern tafi_gen_pattern;
+static struct task_struct *tafi_gen_task;
+
+// Serializes starting and stopping the thread.
+static DEFINE_MUTEX(tafi_gen_mutex);
+
+static TAFI_COUNTER(tafi_gen_frames, "generator_frames");
+static TAFI_HIST(tafi_gen_submit_time, "generator_submit");
+
+static inline void tafi_gen_led(unsigned char *frame, unsigned int sector, unsigned int led, u8 red, u8 green,
+    u8 blue) {
+
+    unsigned char *out = frame + sector * TAFI_SECTOR_BUF_LEN + led * TAFI_LED_COLOR_FIELD_COUNT;
+
+    out[0] = tafi_lut_wire[led][blue];
+    out[1] = tafi_lut_wire[led][red];
+    out[2] = tafi_lut_wire[led][green];
+}
+
+static void tafi_gen_fill(enum tafi_gen_pattern pattern, u32 seq, unsigned char *frame) {
+    struct rnd_state rnd;
+    unsigned int s;
+    unsigned int l;
+    unsigned int i;
+    u8 on;
+    u32 v;
+
+    switch (pattern) {
+    case TAFI_GEN_GRADIENT:
+        for (s = 0; s < TAFI_SECTOR_COUNT; s++) {
+            v = (s + seq) % TAFI_SECTOR_COUNT * 255 / (TAFI_SECTOR_COUNT - 1);
+            for (l = 0; l < TAFI_SECTOR_LED_COUNT; l++)
+                tafi_gen_led(frame, s, l, v, 255 - v, l * 255 / (TAFI_SECTOR_LED_COUNT - 1));
+        }
+        break;
+    case TAFI_GEN_COUNTER:
+        // LED 0 is the stamp, bit n of the counter is LED n + 1
+        for (s = 0; s < TAFI_SECTOR_COUNT; s++) {
+            v = seq + s;
+            for (l = 1; l < TAFI_SECTOR_LED_COUNT; l++) {
+                on = v >> (l - 1) & 1 ? 255 : 0;
+                tafi_gen_led(frame, s, l, on, on, on);
+            }
+        }
+        break;
+    case TAFI_GEN_NOISE:
+        prandom_seed_state(&rnd, seq);
+        prandom_bytes_state(&rnd, frame, TAFI_DATA_BUF_LEN);
+        // every byte on the wire has the top bit set
+        for (i = 0; i < TAFI_DATA_BUF_LEN; i++)
+            frame[i] |= 0x80;
+        break;
+    default:
+        break;
+    }
+
+    for (s = 0; s < TAFI_SECTOR_COUNT; s++)
+        tafi_gen_stamp_write(frame + s * TAFI_SECTOR_BUF_LEN, seq);
+}
+
+/**
+ * Sleep for timeout, or until the thread is told to stop.
+ */
+static void tafi_gen_sleep(ktime_t timeout) {
+    set_current_state(TASK_INTERRUPTIBLE);
+    if (!kthread_should_stop())
+        schedule_hrtimeout(&timeout, HRTIMER_MODE_REL);
+    __set_current_state(TASK_RUNNING);
+}
+
+/**
+ * Generate and submit one frame. Returns 0, or a negative errno value if
+ * it could not be queued.
+ * The FIFO is polled rather than waited on, kthread_stop() couldn't end a
+ * wait for room that never comes, e.g. without sync edges.
+ */
+static int tafi_gen_submit(u32 seq) {
+    struct tafi_frame *frame;
+    unsigned int depth;
+    ktime_t start;
+    u64 ticket;
+    int ret = 0;
+
+    frame = tafi_frame_alloc();
+    if (frame == NULL)
+        return -ENOMEM;
+    tafi_gen_fill(READ_ONCE(tafi_gen_pattern), seq, frame->data);
+
+    start = ktime_get();
+    depth = READ_ONCE(tafi_gen_depth);
+    if (depth) {
+        while ((ret = tafi_queue_frame(frame, depth, true, &ticket)) == -EAGAIN && !kthread_should_stop())
+            tafi_gen_sleep(ns_to_ktime(TAFI_GEN_RETRY_NS));
+        if (ret)
+            tafi_frame_put(frame);
+    } else {
+        tafi_publish_frame(frame);
+    }
+    tafi_hist_add(&tafi_gen_submit_time, ktime_to_ns(ktime_sub(ktime_get(), start)));
+
+    if (ret == 0)
+        tafi_counter_inc(&tafi_gen_frames);
+    return ret;
+}
+
+static int tafi_gen_thread(void *data) {
+    ktime_t deadline = ktime_get();
+    u32 seq = 0;
+    u32 hz;
+
+    while (!kthread_should_stop()) {
+        if (tafi_gen_submit(seq) == 0)
+            seq = (seq + 1) & TAFI_GEN_STAMP_MASK;
+
+        hz = READ_ONCE(tafi_gen_hz);
+        if (hz == 0) {
+            cond_resched();
+            continue;
+        }
+
+        // frames missed while blocked are not made up for
+        deadline = ktime_add_ns(deadline, NSEC_PER_SEC / hz);
+        if (ktime_before(deadline, ktime_get())) {
+            deadline = ktime_get();
+            continue;
+        }
+
+        set_current_state(TASK_INTERRUPTIBLE);
+        if (!kthread_should_stop())
+            schedule_hrtimeout(&deadline, HRTIMER_MODE_ABS);
+        __set_current_state(TASK_RUNNING);
+    }
+
+    return 0;
+}
+
+/**
+ * Switch to pattern, starting or stopping the thread as needed.
+ * Called with tafi_gen_mutex held.
+ */
+static int tafi_gen_set(enum tafi_gen_pattern pattern) {
+    struct task_struct *task;
+
+    WRITE_ONCE(tafi_gen_pattern, pattern);
+
+    if (pattern == TAFI_GEN_OFF && tafi_gen_task) {
+        kthread_stop(tafi_gen_task);
+        tafi_gen_task = NULL;
+        printk(KERN_INFO TAFI_LOG_PREFIX"generator stopped.");
+    } else if (pattern != TAFI_GEN_OFF && !tafi_gen_task) {
+        task = kthread_run(tafi_gen_thread, NULL, TAFI_GEN_THREAD_NAME);
+        if (IS_ERR(task)) {
+            WRITE_ONCE(tafi_gen_pattern, TAFI_GEN_OFF);
+            return PTR_ERR(task);
+        }
+        tafi_gen_task = task;
+        printk(KERN_INFO TAFI_LOG_PREFIX"generator started.");
+    }
+    return 0;
+}
+
+/**
+ * Lists the patterns, the current one in brackets.
+ */
+static ssize_t tafi_gen_read(struct file *filep, char __user *buf, size_t len, loff_t *offset) {
+    char text[64];
+    unsigned int i;
+    int n = 0;
+
+    for (i = 0; i < ARRAY_SIZE(tafi_gen_pattern_names); i++)
+        n += scnprintf(text + n, sizeof(text) - n, i == READ_ONCE(tafi_gen_pattern) ? "[%s]%s" : "%s%s",
+            tafi_gen_pattern_names[i], i + 1 < ARRAY_SIZE(tafi_gen_pattern_names) ? " " : "\n");
+
+    return simple_read_from_buffer(buf, len, offset, text, n);
+}
+
+static ssize_t tafi_gen_write(struct file *filep, const char __user *buf, size_t len, loff_t *offset) {
+    char name[16];
+    int pattern;
+    int ret;
+
+    if (len >= sizeof(name))
+        return -EINVAL;
+    if (copy_from_user(name, buf, len))
+        return -EFAULT;
+    name[len] = '\0';
+
+    pattern = sysfs_match_string(tafi_gen_pattern_names, name);
+    if (pattern < 0)
+        return pattern;
+
+    mutex_lock(&tafi_gen_mutex);
+    ret = tafi_gen_set(pattern);
+    mutex_unlock(&tafi_gen_mutex);
+    return ret ? ret : len;
+}
+
+static const struct file_operations tafi_gen_fops = {
+    .owner = THIS_MODULE,
+    .read = tafi_gen_read,
+    .write = tafi_gen_write,
+    .llseek = default_llseek,
+};
+
+void tafi_gen_init(void) {
+    tafi_stats_register_counter(&tafi_gen_frames);
+    tafi_stats_register_hist(&tafi_gen_submit_time);
+
+    if (tafi_debugfs_dir() == NULL)
+        return;
+    debugfs_create_file(TAFI_GEN_FILE_NAME, 0600, tafi_debugfs_dir(), NULL, &tafi_gen_fops);
+    debugfs_create_u32("generator_hz", 0600, tafi_debugfs_dir(), &tafi_gen_hz);
+    debugfs_create_u32("generator_depth", 0600, tafi_debugfs_dir(), &tafi_gen_depth);
+}
+
+/**
+ * Stop the generator.
+ */
+void tafi_gen_exit(void) {
+    mutex_lock(&tafi_gen_mutex);
+    tafi_gen_set(TAFI_GEN_OFF);
+    mutex_unlock(&tafi_gen_mutex);
+}
@@ -0,0 +1,72 @@
+/**
+ *  tafi_gen.h -- The Amazing Fan Idea driver
+ *  Built-in pattern and load generator, and the sequence stamps it embeds
+ *  in its frames.
+ *
+ *  LED 0 of every sector of a generated frame carries the frame's
+ *  sequence number, the low 21 bits of it, 7 in each channel, most
+ *  significant in blue. A transmitted frame whose sectors disagree on the
+ *  stamp was torn. The stamp helpers below are freestanding and depend
+ *  only on tafi_uapi.h, so a capture reader can include them as is.
+ *
+ *      (C) 2017 Harindu Perera
+ *
+ *  This file is subject to the terms and conditions of the GNU General Public
+ *  License. See the file COPYING in the main directory of this archive for
+ *  more details.
+ */
+
+#ifndef TAFI_GEN_HDR
+#define TAFI_GEN_HDR
+
+#include "tafi_uapi.h"
+
+#define TAFI_GEN_FILE_NAME "generator"
+
+// LED of every sector holding the stamp.
+#define TAFI_GEN_STAMP_LED 0
+#define TAFI_GEN_STAMP_BITS 21
+#define TAFI_GEN_STAMP_MASK ((1u << TAFI_GEN_STAMP_BITS) - 1)
+
+/**
+ * Write the stamp of seq into one sector of a native frame.
+ */
+static inline void tafi_gen_stamp_write(unsigned char *sector, unsigned int seq) {
+    unsigned char *led = sector + TAFI_GEN_STAMP_LED * TAFI_LED_COLOR_FIELD_COUNT;
+
+    led[0] = 0x80 | ((seq >> 14) & 0x7f);
+    led[1] = 0x80 | ((seq >> 7) & 0x7f);
+    led[2] = 0x80 | (seq & 0x7f);
+}
+
+/**
+ * Read the stamp of one sector of a native frame.
+ */
+static inline unsigned int tafi_gen_stamp_read(const unsigned char *sector) {
+    const unsigned char *led = sector + TAFI_GEN_STAMP_LED * TAFI_LED_COLOR_FIELD_COUNT;
+
+    return (led[0] & 0x7f) << 14 | (led[1] & 0x7f) << 7 | (led[2] & 0x7f);
+}
+
+/**
+ * Stamp of a whole native frame, or -1 if its sectors disagree.
+ */
+static inline long tafi_gen_frame_stamp(const unsigned char *frame) {
+    unsigned int stamp = tafi_gen_stamp_read(frame);
+    unsigned int sector;
+
+    for (sector = 1; sector < TAFI_SECTOR_COUNT; sector++)
+        if (tafi_gen_stamp_read(frame + sector * TAFI_SECTOR_BUF_LEN) != stamp)
+            return -1;
+    return stamp;
+}
+
+#ifdef __KERNEL__
+
+void tafi_gen_init(void);
+
+void tafi_gen_exit(void);
+
+#endif
+
+#endif
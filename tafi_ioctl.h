@@ -10,25 +10,83 @@
  */
 
 #include <linux/types.h>
+#include <linux/cache.h>
+#include <linux/kref.h>
+
+#include "tafi_uapi.h"
 
 #ifndef TAFI_IOCTL
 #define TAFI_IOCTL
 
-#define TAFI_SECTOR_COUNT 150
-#define TAFI_SECTOR_LED_COUNT 20
-#define TAFI_LED_COLOR_FIELD_COUNT 3
-#define TAFI_SECTOR_BUF_LEN TAFI_SECTOR_LED_COUNT * TAFI_LED_COLOR_FIELD_COUNT
-#define TAFI_DATA_BUF_LEN TAFI_SECTOR_COUNT * TAFI_SECTOR_BUF_LEN
-
-static inline size_t tafi_check_bounds(size_t len, loff_t off) {
-    if (len < 0) return -1;
-    if (off < 0 || off > (TAFI_DATA_BUF_LEN - 1)) return -1;
-    if (len + off > TAFI_DATA_BUF_LEN) return (size_t) (TAFI_DATA_BUF_LEN - off);
+static inline ssize_t tafi_check_bounds_size(size_t len, loff_t off, size_t size) {
+    if (off < 0 || off > (loff_t) (size - 1)) return -1;
+    if (len + off > size) return (ssize_t) (size - off);
     return len;
 }
 
+static inline ssize_t tafi_check_bounds(size_t len, loff_t off) {
+    return tafi_check_bounds_size(len, off, TAFI_DATA_BUF_LEN);
+}
+
+// An immutable native frame once published, shared by reference.
+struct tafi_frame {
+    struct kref ref;
+    // mapping for the SPI controller, made once when published
+    dma_addr_t dma;
+    // data holds TAFI_INDEXED_BUF_LEN palette indices, expanded with the
+    // palette when transmitted; never mapped
+    bool indexed;
+    // fraction of a wire step each byte of data falls short by, dithered
+    // in over successive transmissions; NULL if there is none
+    u8 *dither;
+    // the same image sampled half a sector later, sent instead on odd
+    // revolutions; NULL if there is none
+    struct tafi_frame *phase;
+    // transmissions to crossfade in over from what was sent before, 0 cuts
+    u32 fade;
+    // on cache lines of its own, so nothing written to the fields above
+    // shares a line with data mapped for DMA
+    unsigned char data[TAFI_DATA_BUF_LEN] ____cacheline_aligned;
+};
+
+struct tafi_frame *tafi_frame_alloc(void);
+
+void tafi_frame_put(struct tafi_frame *frame);
+
+struct tafi_frame *tafi_frame_get_live(void);
+
+struct tafi_frame *tafi_frame_get_live_native(void);
+
+u64 tafi_publish_frame(struct tafi_frame *frame);
+
+void tafi_publish_frame_at(struct tafi_frame *frame, u64 tick);
+
+int tafi_queue_frame(struct tafi_frame *frame, unsigned int depth, bool nonblock, u64 *ticket);
+
+struct tafi_frame *tafi_frame_get_newest_native(void);
+
+// A display whose frames are converted by the transmit thread itself, a
+// group of sectors at a time while the previous group is on the wire.
+struct tafi_pipeline_source {
+    // convert sectors first to first + count - 1 into the same sectors of dst
+    void (*convert)(struct tafi_pipeline_source *source, unsigned int first, unsigned int count,
+        unsigned char *dst);
+};
+
+u64 tafi_pipeline_submit(struct tafi_pipeline_source *source);
+
+void tafi_pipeline_cancel(struct tafi_pipeline_source *source);
+
 void tafi_get_color_data(void * buf, size_t len, loff_t offset);
 
 void tafi_set_color_data(void *buf, size_t len, loff_t offset);
 
+int tafi_set_color_ranges(const void *frame, const struct tafi_range *ranges, unsigned int count, u64 *ticket);
+
+int tafi_wait_for_pickup(u64 ticket);
+
+u64 tafi_refresh(void);
+
+u64 tafi_color_data_pickup_count(void);
+
 #endif
\ No newline at end of file
@@ -0,0 +1,213 @@
+/**
+ *  tafi_lutgen.c -- The Amazing Fan Idea driver
+ *  Host tool generating the conversion lookup tables, tafi_lut.c.
+ *
+ *  The blade is a full diameter: the first half of the LEDs run from the
+ *  outer edge in to the hub on one arm, the second half from the hub out on
+ *  the other arm, shifted by half the LED pitch so the two arms interleave.
+ *  Sector s is sampled in the middle of its arc, at (s + 1/2) / sectors of
+ *  a revolution, and for angular interleaving also at its end, (s + 1) /
+ *  sectors, half a sector later.
+ *
+ *  Usage: tafi_lutgen [key=value ...] > tafi_lut.c, see the defaults below
+ *  for the keys.
+ *
+ *      (C) 2017 Harindu Perera
+ *
+ *  This file is subject to the terms and conditions of the GNU General Public
+ *  License. See the file COPYING in the main directory of this archive for
+ *  more details.
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+struct tafi_lutgen_param {
+    const char *key;
+    double value;
+};
+
+static struct tafi_lutgen_param params[] = {
+    { "sectors", 150 },         // sectors per revolution
+    { "leds", 20 },             // LEDs on the blade, both arms
+    { "xres", 80 },             // Cartesian framebuffer size
+    { "yres", 80 },
+    { "center_x", 41.5 },       // hub position in pixels
+    { "center_y", 38.5 },
+    { "led_pitch", 4 },         // distance between LEDs of one arm in pixels
+    { "brightness_hub", 93.5 }, // full scale brightness at the hub
+    { "brightness_slope", 4.25 }, // full scale brightness gained per pixel of radius
+    { "gamma", 1.0 },
+};
+
+#define PARAM_COUNT (sizeof(params) / sizeof(params[0]))
+
+static double param(const char *key) {
+    unsigned int i;
+
+    for (i = 0; i < PARAM_COUNT; i++)
+        if (!strcmp(params[i].key, key))
+            return params[i].value;
+
+    fprintf(stderr, "tafi_lutgen: no parameter %s\n", key);
+    exit(1);
+}
+
+static int parse_args(int argc, char **argv) {
+    unsigned int i;
+    char *value;
+    int a;
+
+    for (a = 1; a < argc; a++) {
+        value = strchr(argv[a], '=');
+        if (value == NULL)
+            goto err;
+        *value++ = '\0';
+        for (i = 0; i < PARAM_COUNT; i++) {
+            if (!strcmp(params[i].key, argv[a])) {
+                params[i].value = atof(value);
+                break;
+            }
+        }
+        if (i == PARAM_COUNT)
+            goto err;
+    }
+    return 0;
+
+err:
+    fprintf(stderr, "tafi_lutgen: bad argument %s\n", argv[a]);
+    return -1;
+}
+
+/*
+ * Signed distance of an LED from the hub along the blade, in pixels.
+ */
+static double led_radius(int led) {
+    int arm = (int) param("leds") / 2;
+    double pitch = param("led_pitch");
+
+    if (led < arm)
+        return (arm - 1 - led) * pitch;
+    return -(pitch / 2 + (led - arm) * pitch);
+}
+
+/*
+ * Full scale brightness of an LED, growing linearly with its radius.
+ */
+static double led_scale(int led) {
+    double scale = param("brightness_hub") + param("brightness_slope") * fabs(led_radius(led));
+
+    return scale > 255 ? 255 : scale;
+}
+
+/*
+ * Print a pixel table sampling sector s at (s + phase) / sectors of a
+ * revolution. Returns -1 if an LED falls off the framebuffer.
+ */
+static int print_pixel_table(const char *name, double phase) {
+    int sectors = param("sectors");
+    int leds = param("leds");
+    double angle;
+    double radius;
+    int row;
+    int col;
+    int s;
+    int l;
+
+    printf("const u8 %s[TAFI_SECTOR_COUNT][TAFI_SECTOR_LED_COUNT][2] = {\n", name);
+    for (s = 0; s < sectors; s++) {
+        angle = 2 * M_PI * (s + phase) / sectors;
+        printf("    {");
+        for (l = 0; l < leds; l++) {
+            radius = led_radius(l);
+            row = floor(param("center_y") + radius * sin(angle));
+            col = floor(param("center_x") + radius * cos(angle));
+            if (row < 0 || row >= param("yres") || col < 0 || col >= param("xres")) {
+                fprintf(stderr, "tafi_lutgen: LED %d of sector %d is off screen\n", l, s);
+                return -1;
+            }
+            printf(" {%d, %d},", row, col);
+        }
+        printf(" },\n");
+    }
+    printf("};\n\n");
+    return 0;
+}
+
+int main(int argc, char **argv) {
+    int sectors;
+    int leds;
+    int xres;
+    int yres;
+    double scale;
+    double value;
+    double level;
+    double prev;
+    int l;
+    int v;
+
+    if (parse_args(argc, argv) < 0)
+        return 1;
+
+    sectors = param("sectors");
+    leds = param("leds");
+    xres = param("xres");
+    yres = param("yres");
+
+    if (xres > 256 || yres > 256) {
+        fprintf(stderr, "tafi_lutgen: pixel coordinates no longer fit the u8 table\n");
+        return 1;
+    }
+
+    printf("/* Generated by tafi_lutgen, do not edit. */\n\n");
+    printf("#include \"tafi_lut.h\"\n\n");
+    printf("#if TAFI_SECTOR_COUNT != %d || TAFI_SECTOR_LED_COUNT != %d || TAFI_FB_XRES != %d || TAFI_FB_YRES != %d\n",
+        sectors, leds, xres, yres);
+    printf("#error \"lookup table geometry does not match the driver\"\n");
+    printf("#endif\n\n");
+
+    if (print_pixel_table("tafi_lut_pixel", 0.5) < 0 || print_pixel_table("tafi_lut_pixel_half", 1) < 0)
+        return 1;
+
+    printf("const u8 tafi_lut_wire[TAFI_SECTOR_LED_COUNT][256] = {\n");
+    for (l = 0; l < leds; l++) {
+        scale = led_scale(l) / 255;
+        printf("    {");
+        for (v = 0; v < 256; v++) {
+            if (v % 16 == 0)
+                printf("\n       ");
+            // the ramp truncates, in the order the original hand-made table
+            // was computed in, so a linear one reproduces it bit for bit
+            value = param("gamma") == 1 ? v : 255 * pow(v / 255.0, param("gamma"));
+            // 7 bit value with the top bit set, as on the wire
+            printf(" 0x%02x,", ((int) floor(value * scale) >> 1) | 0x80);
+        }
+        printf("\n    },\n");
+    }
+    printf("};\n\n");
+
+    // 16 bit input: wire level in 1/256 steps at every 256th channel
+    // value, the driver interpolates in between
+    printf("const u16 tafi_lut_deep[TAFI_SECTOR_LED_COUNT][257] = {\n");
+    for (l = 0; l < leds; l++) {
+        scale = led_scale(l);
+        prev = 0;
+        printf("    {");
+        for (v = 0; v <= 256; v++) {
+            if (v % 16 == 0)
+                printf("\n       ");
+            level = floor(scale * pow((v < 256 ? v * 256 : 65535) / 65535.0, param("gamma")) * 128 + 0.5);
+            // interpolation must never step down
+            if (level < prev)
+                level = prev;
+            prev = level;
+            printf(" %5d,", (int) level);
+        }
+        printf("\n    },\n");
+    }
+    printf("};\n");
+
+    return 0;
+}
@@ -0,0 +1,75 @@
+/**
+ *  tafi_palette.c -- The Amazing Fan Idea driver
+ *  Palette of indexed frames.
+ *
+ *  Indexed frames stay indexed until the transmit thread sends them, and
+ *  are expanded with whatever palette is current at the start of the
+ *  frame. Changing the palette therefore only has to trigger another
+ *  transmission.
+ *
+ *      (C) 2017 Harindu Perera
+ *
+ *  This file is subject to the terms and conditions of the GNU General Public
+ *  License. See the file COPYING in the main directory of this archive for
+ *  more details.
+ */
+
+#include <linux/spinlock.h>
+#include <linux/string.h>
+
+#include "tafi_common.h"
+#include "tafi_ioctl.h"
+#include "tafi_convert.h"
+#include "tafi_palette.h"
+
+static u8 tafi_palette[TAFI_PALETTE_SIZE][3];
+
+// Held for updates and for whole expansions, so a frame never mixes two
+// palettes.
+static DEFINE_SPINLOCK(tafi_palette_lock);
+
+/**
+ * Start out with the 3-3-2 bit RGB palette, so indexed content shows
+ * something sensible before a palette is loaded.
+ */
+void tafi_palette_init(void) {
+    unsigned int i;
+
+    for (i = 0; i < TAFI_PALETTE_SIZE; i++) {
+        tafi_palette[i][0] = ((i >> 5) & 0x7) * 255 / 7;
+        tafi_palette[i][1] = ((i >> 2) & 0x7) * 255 / 7;
+        tafi_palette[i][2] = (i & 0x3) * 255 / 3;
+    }
+}
+
+/**
+ * Replace entries first to first + count - 1, all at once.
+ * Returns a ticket for tafi_wait_for_pickup() of the first frame using
+ * them.
+ */
+u64 tafi_palette_set(const u8 (*entries)[3], unsigned int first, unsigned int count) {
+    if (first >= TAFI_PALETTE_SIZE)
+        return tafi_color_data_pickup_count();
+    count = min_t(unsigned int, count, TAFI_PALETTE_SIZE - first);
+
+    spin_lock(&tafi_palette_lock);
+    memcpy(tafi_palette[first], entries, count * sizeof(tafi_palette[0]));
+    spin_unlock(&tafi_palette_lock);
+
+    return tafi_refresh();
+}
+
+void tafi_palette_get(u8 (*entries)[3]) {
+    spin_lock(&tafi_palette_lock);
+    memcpy(entries, tafi_palette, sizeof(tafi_palette));
+    spin_unlock(&tafi_palette_lock);
+}
+
+/**
+ * Expand an indexed frame into a native one with the current palette.
+ */
+void tafi_palette_expand(const unsigned char *indices, unsigned char *dst) {
+    spin_lock(&tafi_palette_lock);
+    tafi_convert_indexed(indices, (const u8 (*)[3]) tafi_palette, dst);
+    spin_unlock(&tafi_palette_lock);
+}
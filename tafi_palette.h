@@ -0,0 +1,27 @@
+/**
+ *  tafi_palette.h -- The Amazing Fan Idea driver
+ *  Palette of indexed frames.
+ *
+ *      (C) 2017 Harindu Perera
+ *
+ *  This file is subject to the terms and conditions of the GNU General Public
+ *  License. See the file COPYING in the main directory of this archive for
+ *  more details.
+ */
+
+#ifndef TAFI_PALETTE_HDR
+#define TAFI_PALETTE_HDR
+
+#include <linux/types.h>
+
+#include "tafi_ioctl.h"
+
+void tafi_palette_init(void);
+
+u64 tafi_palette_set(const u8 (*entries)[3], unsigned int first, unsigned int count);
+
+void tafi_palette_get(u8 (*entries)[3]);
+
+void tafi_palette_expand(const unsigned char *indices, unsigned char *dst);
+
+#endif
@@ -0,0 +1,156 @@
+/**
+ *  tafi_present.c -- The Amazing Fan Idea driver
+ *  Presentation modes of the clients committing frames.
+ *
+ *  The display shows about 10.8 frames a second, so most producers commit
+ *  faster than it can keep up. In mailbox mode a commit replaces the live
+ *  frame and whatever it held is lost if the thread hadn't picked it up
+ *  yet. FIFO mode queues whole frames in the core instead, which the
+ *  thread makes live one per frame, and holds the client back while the
+ *  queue is full. Immediate mode is mailbox mode committing every write.
+ *
+ *  A mailbox frame was dropped if the next one was published before any
+ *  pickup, which shows as both getting the same ticket. FIFO frames are
+ *  only dropped when a blocked client gives up, on close.
+ *
+ *  A client with a crossfade set always presents whole frames, each
+ *  carrying the fade, since the thread blends frames, not ranges.
+ *
+ *      (C) 2017 Harindu Perera
+ *
+ *  This file is subject to the terms and conditions of the GNU General Public
+ *  License. See the file COPYING in the main directory of this archive for
+ *  more details.
+ */
+
+#include <linux/kernel.h>
+#include <linux/string.h>
+
+#include "tafi_common.h"
+#include "tafi_stats.h"
+#include "tafi_present.h"
+
+static TAFI_COUNTER(tafi_dropped_mailbox, "dropped_mailbox");
+static TAFI_COUNTER(tafi_dropped_fifo, "dropped_fifo");
+static TAFI_COUNTER(tafi_dropped_immediate, "dropped_immediate");
+
+static struct tafi_counter *const tafi_present_dropped[] = {
+    [TAFI_PRESENT_MAILBOX] = &tafi_dropped_mailbox,
+    [TAFI_PRESENT_FIFO] = &tafi_dropped_fifo,
+    [TAFI_PRESENT_IMMEDIATE] = &tafi_dropped_immediate,
+};
+
+void tafi_present_init(void) {
+    tafi_stats_register_counter(&tafi_dropped_mailbox);
+    tafi_stats_register_counter(&tafi_dropped_fifo);
+    tafi_stats_register_counter(&tafi_dropped_immediate);
+}
+
+/**
+ * Change a client's mode. Frames it already queued still play out.
+ */
+int tafi_present_set(struct tafi_presenter *presenter, const struct tafi_present *args) {
+    switch (args->mode) {
+    case TAFI_PRESENT_FIFO:
+        if (args->depth < 1 || args->depth > TAFI_PRESENT_FIFO_MAX)
+            return -EINVAL;
+        break;
+    case TAFI_PRESENT_MAILBOX:
+    case TAFI_PRESENT_IMMEDIATE:
+        break;
+    default:
+        return -EINVAL;
+    }
+
+    presenter->mode = args->mode;
+    presenter->depth = args->depth;
+    presenter->presented = false;
+    return 0;
+}
+
+void tafi_present_get(const struct tafi_presenter *presenter, struct tafi_present *args) {
+    memset(args, 0, sizeof(*args));
+    args->mode = presenter->mode;
+    args->depth = presenter->depth;
+    args->dropped = presenter->dropped;
+}
+
+int tafi_present_set_fade(struct tafi_presenter *presenter, u32 fade) {
+    if (fade > TAFI_FADE_MAX)
+        return -EINVAL;
+    presenter->fade = fade;
+    return 0;
+}
+
+/**
+ * Count a frame of the client that will never be transmitted.
+ */
+void tafi_present_drop(struct tafi_presenter *presenter) {
+    presenter->dropped++;
+    tafi_counter_inc(tafi_present_dropped[presenter->mode]);
+}
+
+static void tafi_present_account(struct tafi_presenter *presenter, u64 ticket) {
+    // no pickup in between, the previous frame was replaced unseen
+    if (presenter->presented && ticket == presenter->last_ticket)
+        tafi_present_drop(presenter);
+    presenter->last_ticket = ticket;
+    presenter->presented = true;
+}
+
+/**
+ * Present a whole frame. Takes over the reference unless it fails, which
+ * only happens in FIFO mode, see tafi_queue_frame().
+ */
+int tafi_present_frame(struct tafi_presenter *presenter, struct tafi_frame *frame, bool nonblock, u64 *ticket) {
+    frame->fade = presenter->fade;
+    if (presenter->mode == TAFI_PRESENT_FIFO)
+        return tafi_queue_frame(frame, presenter->depth, nonblock, ticket);
+
+    *ticket = tafi_publish_frame(frame);
+    tafi_present_account(presenter, *ticket);
+    return 0;
+}
+
+/**
+ * Present ranges of a full-size frame, on top of what the display will
+ * show by then, like tafi_set_color_ranges().
+ */
+int tafi_present_ranges(struct tafi_presenter *presenter, const void *data, const struct tafi_range *ranges,
+    unsigned int count, bool nonblock, u64 *ticket) {
+
+    struct tafi_frame *newest;
+    struct tafi_frame *next;
+    unsigned int i;
+    int ret;
+
+    if (presenter->mode != TAFI_PRESENT_FIFO && !presenter->fade) {
+        ret = tafi_set_color_ranges(data, ranges, count, ticket);
+        if (ret)
+            return ret;
+        tafi_present_account(presenter, *ticket);
+        return 0;
+    }
+
+    next = tafi_frame_alloc();
+    if (next == NULL)
+        return -ENOMEM;
+
+    // the ranges apply to the frame queued last, not the one on display
+    newest = tafi_frame_get_newest_native();
+    if (newest == NULL) {
+        tafi_frame_put(next);
+        return -ENOMEM;
+    }
+    memcpy(next->data, newest->data, TAFI_DATA_BUF_LEN);
+    tafi_frame_put(newest);
+    for (i = 0; i < count; i++) {
+        memcpy(next->data + ranges[i].offset,
+            (const unsigned char *) data + ranges[i].offset, ranges[i].len);
+    }
+
+    ret = tafi_present_frame(presenter, next, nonblock, ticket);
+    if (ret)
+        tafi_frame_put(next);
+    return ret;
+}
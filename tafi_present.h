@@ -0,0 +1,46 @@
+/**
+ *  tafi_present.h -- The Amazing Fan Idea driver
+ *  Presentation modes of the clients committing frames.
+ *
+ *      (C) 2017 Harindu Perera
+ *
+ *  This file is subject to the terms and conditions of the GNU General Public
+ *  License. See the file COPYING in the main directory of this archive for
+ *  more details.
+ */
+
+#ifndef TAFI_PRESENT_HDR
+#define TAFI_PRESENT_HDR
+
+#include <linux/types.h>
+
+#include "tafi_ioctl.h"
+
+// Presentation state of one client. All zero is mailbox mode.
+struct tafi_presenter {
+    u32 mode;           // TAFI_PRESENT_*
+    u32 depth;
+    // ticket of the last frame presented outside FIFO mode
+    u64 last_ticket;
+    bool presented;
+    u64 dropped;
+    // crossfade of the frames presented, see TAFI_IOC_SET_FADE
+    u32 fade;
+};
+
+void tafi_present_init(void);
+
+int tafi_present_set(struct tafi_presenter *presenter, const struct tafi_present *args);
+
+void tafi_present_get(const struct tafi_presenter *presenter, struct tafi_present *args);
+
+int tafi_present_set_fade(struct tafi_presenter *presenter, u32 fade);
+
+int tafi_present_frame(struct tafi_presenter *presenter, struct tafi_frame *frame, bool nonblock, u64 *ticket);
+
+int tafi_present_ranges(struct tafi_presenter *presenter, const void *data, const struct tafi_range *ranges,
+    unsigned int count, bool nonblock, u64 *ticket);
+
+void tafi_present_drop(struct tafi_presenter *presenter);
+
+#endif
@@ -0,0 +1,146 @@
+/**
+ *  tafi_stats.c -- The Amazing Fan Idea driver
+ *  Counters and latency histograms, reported through debugfs.
+ *
+ *  Subsystems register their statistics once at init. Reading
+ *  <debugfs>/tafi/stats prints all of them, writing anything to it resets
+ *  them.
+ * 
+ *      (C) 2017 Harindu Perera
+ *  
+ *  This file is subject to the terms and conditions of the GNU General Public
+ *  License. See the file COPYING in the main directory of this archive for
+ *  more details.
+ */
+
+#include <linux/fs.h>
+#include <linux/log2.h>
+#include <linux/math64.h>
+#include <linux/module.h>
+#include <linux/mutex.h>
+#include <linux/seq_file.h>
+#include <linux/string.h>
+
+#include "tafi_common.h"
+#include "tafi_debugfs.h"
+#include "tafi_stats.h"
+
+static struct tafi_hist *tafi_stats_hists[TAFI_STATS_MAX_ENTRIES];
+static unsigned int tafi_stats_hist_count;
+
+static struct tafi_counter *tafi_stats_counters[TAFI_STATS_MAX_ENTRIES];
+static unsigned int tafi_stats_counter_count;
+
+// Protects the registries.
+static DEFINE_MUTEX(tafi_stats_mutex);
+
+void tafi_stats_register_hist(struct tafi_hist *hist) {
+    mutex_lock(&tafi_stats_mutex);
+    if (tafi_stats_hist_count < TAFI_STATS_MAX_ENTRIES)
+        tafi_stats_hists[tafi_stats_hist_count++] = hist;
+    mutex_unlock(&tafi_stats_mutex);
+}
+
+void tafi_stats_register_counter(struct tafi_counter *counter) {
+    mutex_lock(&tafi_stats_mutex);
+    if (tafi_stats_counter_count < TAFI_STATS_MAX_ENTRIES)
+        tafi_stats_counters[tafi_stats_counter_count++] = counter;
+    mutex_unlock(&tafi_stats_mutex);
+}
+
+/**
+ * Account one sample. Negative samples count as zero.
+ */
+void tafi_hist_add(struct tafi_hist *hist, s64 value_ns) {
+    u64 value = value_ns > 0 ? value_ns : 0;
+    u64 us = div_u64(value, NSEC_PER_USEC);
+    unsigned int bucket = us ? ilog2(us) + 1 : 0;
+
+    if (bucket >= TAFI_HIST_BUCKETS)
+        bucket = TAFI_HIST_BUCKETS - 1;
+
+    WRITE_ONCE(hist->buckets[bucket], hist->buckets[bucket] + 1);
+    WRITE_ONCE(hist->count, hist->count + 1);
+    WRITE_ONCE(hist->sum_ns, hist->sum_ns + value);
+    if (value > hist->max_ns)
+        WRITE_ONCE(hist->max_ns, value);
+}
+
+static void tafi_stats_show_hist(struct seq_file *m, struct tafi_hist *hist) {
+    u64 count = READ_ONCE(hist->count);
+    unsigned int i;
+
+    seq_printf(m, "%s: count %llu avg_us %llu max_us %llu\n", hist->name, count,
+        count ? div64_u64(READ_ONCE(hist->sum_ns), count * NSEC_PER_USEC) : 0,
+        div_u64(READ_ONCE(hist->max_ns), NSEC_PER_USEC));
+
+    for (i = 0; i < TAFI_HIST_BUCKETS; i++) {
+        if (!READ_ONCE(hist->buckets[i]))
+            continue;
+        if (i == 0)
+            seq_printf(m, "  %10s %10u us: %llu\n", "", 1, READ_ONCE(hist->buckets[i]));
+        else if (i == TAFI_HIST_BUCKETS - 1)
+            seq_printf(m, "  %10u %10s us: %llu\n", 1U << (i - 1), "", READ_ONCE(hist->buckets[i]));
+        else
+            seq_printf(m, "  %10u %10u us: %llu\n", 1U << (i - 1), 1U << i, READ_ONCE(hist->buckets[i]));
+    }
+}
+
+static int tafi_stats_show(struct seq_file *m, void *v) {
+    unsigned int i;
+
+    mutex_lock(&tafi_stats_mutex);
+    for (i = 0; i < tafi_stats_counter_count; i++)
+        seq_printf(m, "%s: %llu\n", tafi_stats_counters[i]->name, (u64) atomic64_read(&tafi_stats_counters[i]->value));
+    for (i = 0; i < tafi_stats_hist_count; i++)
+        tafi_stats_show_hist(m, tafi_stats_hists[i]);
+    mutex_unlock(&tafi_stats_mutex);
+    return 0;
+}
+
+static int tafi_stats_open(struct inode *inodep, struct file *filep) {
+    return single_open(filep, tafi_stats_show, NULL);
+}
+
+/**
+ * Any write resets all statistics.
+ */
+static ssize_t tafi_stats_write(struct file *filep, const char __user *buf, size_t len, loff_t *offset) {
+    struct tafi_hist *hist;
+    unsigned int i;
+
+    mutex_lock(&tafi_stats_mutex);
+    for (i = 0; i < tafi_stats_counter_count; i++)
+        atomic64_set(&tafi_stats_counters[i]->value, 0);
+    for (i = 0; i < tafi_stats_hist_count; i++) {
+        hist = tafi_stats_hists[i];
+        memset(hist->buckets, 0, sizeof(hist->buckets));
+        hist->count = 0;
+        hist->sum_ns = 0;
+        hist->max_ns = 0;
+    }
+    mutex_unlock(&tafi_stats_mutex);
+    return len;
+}
+
+static const struct file_operations tafi_stats_fops = {
+    .owner = THIS_MODULE,
+    .open = tafi_stats_open,
+    .read = seq_read,
+    .write = tafi_stats_write,
+    .llseek = seq_lseek,
+    .release = single_release,
+};
+
+int tafi_stats_init(void) {
+    if (tafi_debugfs_dir())
+        debugfs_create_file(TAFI_STATS_FILE_NAME, 0600, tafi_debugfs_dir(), NULL, &tafi_stats_fops);
+    return 0;
+}
+
+void tafi_stats_exit(void) {
+    mutex_lock(&tafi_stats_mutex);
+    tafi_stats_hist_count = 0;
+    tafi_stats_counter_count = 0;
+    mutex_unlock(&tafi_stats_mutex);
+}
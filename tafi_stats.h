@@ -0,0 +1,65 @@
+/**
+ *  tafi_stats.h -- The Amazing Fan Idea driver
+ *  Counters and latency histograms, reported through debugfs.
+ * 
+ *      (C) 2017 Harindu Perera
+ *  
+ *  This file is subject to the terms and conditions of the GNU General Public
+ *  License. See the file COPYING in the main directory of this archive for
+ *  more details.
+ */
+
+#ifndef TAFI_STATS
+#define TAFI_STATS
+
+#include <linux/atomic.h>
+#include <linux/compiler.h>
+#include <linux/types.h>
+
+#define TAFI_STATS_FILE_NAME "stats"
+
+// Histogram buckets are powers of two in microseconds: [0, 1), [1, 2),
+// [2, 4), ... with the last bucket open ended.
+#define TAFI_HIST_BUCKETS 20
+
+// Maximum number of registered histograms and counters.
+#define TAFI_STATS_MAX_ENTRIES 32
+
+// Each histogram has a single writer. Readers may see a sample half
+// accounted for, which is fine for diagnostics. Counters are atomic, as
+// some are counted by every client at once.
+struct tafi_hist {
+    const char *name;
+    u64 buckets[TAFI_HIST_BUCKETS];
+    u64 count;
+    u64 sum_ns;
+    u64 max_ns;
+};
+
+struct tafi_counter {
+    const char *name;
+    atomic64_t value;
+};
+
+#define TAFI_HIST(var, hist_name) struct tafi_hist var = { .name = hist_name }
+#define TAFI_COUNTER(var, counter_name) struct tafi_counter var = { .name = counter_name, .value = ATOMIC64_INIT(0) }
+
+int tafi_stats_init(void);
+
+void tafi_stats_exit(void);
+
+void tafi_stats_register_hist(struct tafi_hist *hist);
+
+void tafi_stats_register_counter(struct tafi_counter *counter);
+
+void tafi_hist_add(struct tafi_hist *hist, s64 value_ns);
+
+static inline void tafi_counter_add(struct tafi_counter *counter, u64 n) {
+    atomic64_add(n, &counter->value);
+}
+
+static inline void tafi_counter_inc(struct tafi_counter *counter) {
+    tafi_counter_add(counter, 1);
+}
+
+#endif
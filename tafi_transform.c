@@ -0,0 +1,379 @@
+/**
+ *  tafi_transform.c -- The Amazing Fan Idea driver
+ *  Geometric transforms applied by the transmit thread.
+ *
+ *  Rotating a polar image only changes the sector the frame starts at, so a
+ *  pure rotation sends the published frame as is, in two pieces. Mirroring
+ *  and radial shifts rebuild the frame in a scratch buffer on its way to
+ *  the wire, which is still far cheaper than converting it again.
+ *
+ *  The transform is replaced as a whole and read by the thread under RCU.
+ *
+ *      (C) 2017 Harindu Perera
+ *
+ *  This file is subject to the terms and conditions of the GNU General Public
+ *  License. See the file COPYING in the main directory of this archive for
+ *  more details.
+ */
+
+#include <linux/device.h>
+#include <linux/ktime.h>
+#include <linux/math64.h>
+#include <linux/mutex.h>
+#include <linux/rcupdate.h>
+#include <linux/slab.h>
+
+#include "tafi_common.h"
+#include "tafi_ioctl.h"
+#include "tafi_bus.h"
+#include "tafi_capture.h"
+#include "tafi_lut.h"
+#include "tafi_transform.h"
+#include "tafi_wire.h"
+
+#define TAFI_ARM_LED_COUNT (TAFI_SECTOR_LED_COUNT / 2)
+
+struct tafi_transform_state {
+    struct tafi_transform args;
+    // time args.rotation was reached
+    ktime_t epoch;
+    // LED each LED takes its value from after the radial shift, -1 if dark
+    s8 source[TAFI_SECTOR_LED_COUNT];
+    // wire value of the source LED to wire value of this LED
+    u8 remap[TAFI_SECTOR_LED_COUNT][128];
+    struct rcu_head rcu;
+};
+
+// Current transform, NULL for none.
+static struct tafi_transform_state __rcu *tafi_transform_state;
+
+// Serializes updates.
+static DEFINE_MUTEX(tafi_transform_mutex);
+
+// Frame rebuilt for transmission, only used by the thread.
+static unsigned char *tafi_transform_buf;
+
+/**
+ * Index of the LED at the given distance from the hub on the arm of led,
+ * in LED pitches, or -1 if that is off the blade.
+ */
+static int tafi_transform_led_at(int led, int radius) {
+    if (radius < 0 || radius >= TAFI_ARM_LED_COUNT)
+        return -1;
+    // the first arm runs from the edge in, the second from the hub out
+    if (led < TAFI_ARM_LED_COUNT)
+        return TAFI_ARM_LED_COUNT - 1 - radius;
+    return TAFI_ARM_LED_COUNT + radius;
+}
+
+static int tafi_transform_led_radius(int led) {
+    if (led < TAFI_ARM_LED_COUNT)
+        return TAFI_ARM_LED_COUNT - 1 - led;
+    return led - TAFI_ARM_LED_COUNT;
+}
+
+/**
+ * Work out where each LED's value comes from after a radial shift. Wire
+ * values carry the brightness correction of the LED they were made for, so
+ * they are mapped back to a channel value and corrected for the new LED.
+ */
+static void tafi_transform_prepare_shift(struct tafi_transform_state *state) {
+    unsigned int led;
+    unsigned int w;
+    unsigned int v;
+    int from;
+
+    for (led = 0; led < TAFI_SECTOR_LED_COUNT; led++) {
+        from = tafi_transform_led_at(led, tafi_transform_led_radius(led) - state->args.radial_shift);
+        state->source[led] = from;
+        if (from < 0)
+            continue;
+        // the tables are monotonic, take the darkest value giving w
+        v = 0;
+        for (w = 0; w < 128; w++) {
+            while (v < 255 && (tafi_lut_wire[from][v] & 0x7f) < w)
+                v++;
+            state->remap[led][w] = tafi_lut_wire[led][v];
+        }
+    }
+}
+
+/**
+ * Rotation in sectors at the given time.
+ */
+static unsigned int tafi_transform_rotation(const struct tafi_transform_state *state, ktime_t now) {
+    s64 phase = (s64) state->args.rotation * 1000;
+    s32 rem;
+
+    if (state->args.angular_velocity)
+        phase += div_s64((s64) state->args.angular_velocity * ktime_ms_delta(now, state->epoch), 1000);
+
+    // in millisectors, rounded down so animations pass zero smoothly
+    div_s64_rem(phase, TAFI_SECTOR_COUNT * 1000, &rem);
+    if (rem < 0)
+        rem += TAFI_SECTOR_COUNT * 1000;
+    return rem / 1000;
+}
+
+static bool tafi_transform_is_identity(const struct tafi_transform *transform) {
+    return !transform->rotation && !transform->angular_velocity && !transform->radial_shift && !transform->flags;
+}
+
+/**
+ * Replace the transform, and have the thread send the frame on display
+ * again with it. Called with tafi_transform_mutex held.
+ * Returns -EINVAL for unknown flags.
+ */
+static int tafi_transform_replace(const struct tafi_transform *transform) {
+    struct tafi_transform_state *state = NULL;
+    struct tafi_transform_state *old;
+
+    if (transform->flags & ~TAFI_TRANSFORM_MIRROR)
+        return -EINVAL;
+
+    if (!tafi_transform_is_identity(transform)) {
+        state = kzalloc(sizeof(*state), GFP_KERNEL);
+        if (state == NULL)
+            return -ENOMEM;
+        state->args = *transform;
+        state->args.rotation %= TAFI_SECTOR_COUNT;
+        state->args.radial_shift = clamp_t(s32, transform->radial_shift,
+            -TAFI_ARM_LED_COUNT, TAFI_ARM_LED_COUNT);
+        state->epoch = ktime_get();
+        if (state->args.radial_shift)
+            tafi_transform_prepare_shift(state);
+    }
+
+    old = rcu_dereference_protected(tafi_transform_state, lockdep_is_held(&tafi_transform_mutex));
+    rcu_assign_pointer(tafi_transform_state, state);
+
+    if (old)
+        kfree_rcu(old, rcu);
+    // even an idle display shows it right away
+    tafi_refresh();
+    return 0;
+}
+
+/**
+ * Replace the transform.
+ * Returns -EINVAL for unknown flags.
+ */
+int tafi_transform_set(const struct tafi_transform *transform) {
+    int ret;
+
+    mutex_lock(&tafi_transform_mutex);
+    ret = tafi_transform_replace(transform);
+    mutex_unlock(&tafi_transform_mutex);
+    return ret;
+}
+
+/**
+ * Read the transform, with the rotation reached by now.
+ */
+void tafi_transform_get(struct tafi_transform *transform) {
+    struct tafi_transform_state *state;
+
+    memset(transform, 0, sizeof(*transform));
+
+    rcu_read_lock();
+    state = rcu_dereference(tafi_transform_state);
+    if (state) {
+        *transform = state->args;
+        transform->rotation = tafi_transform_rotation(state, ktime_get());
+    }
+    rcu_read_unlock();
+}
+
+bool tafi_transform_active(void) {
+    return rcu_access_pointer(tafi_transform_state) != NULL;
+}
+
+/**
+ * Whether the transform changes from frame to frame, so the frame on
+ * display must be sent every period even if it didn't change.
+ */
+bool tafi_transform_animated(void) {
+    struct tafi_transform_state *state;
+    bool animated;
+
+    rcu_read_lock();
+    state = rcu_dereference(tafi_transform_state);
+    animated = state && state->args.angular_velocity;
+    rcu_read_unlock();
+    return animated;
+}
+
+/**
+ * Rebuild a frame with the transform applied.
+ */
+static void tafi_transform_build(const struct tafi_transform_state *state, unsigned int rotation,
+    const unsigned char *src, unsigned char *dst) {
+
+    const unsigned char *in;
+    unsigned char *out;
+    unsigned int sector;
+    unsigned int from;
+    unsigned int led;
+    unsigned int c;
+
+    for (sector = 0; sector < TAFI_SECTOR_COUNT; sector++) {
+        from = (sector + TAFI_SECTOR_COUNT - rotation) % TAFI_SECTOR_COUNT;
+        if (state->args.flags & TAFI_TRANSFORM_MIRROR)
+            from = TAFI_SECTOR_COUNT - 1 - from;
+        in = src + from * TAFI_SECTOR_BUF_LEN;
+        out = dst + sector * TAFI_SECTOR_BUF_LEN;
+
+        if (!state->args.radial_shift) {
+            memcpy(out, in, TAFI_SECTOR_BUF_LEN);
+            continue;
+        }
+
+        for (led = 0; led < TAFI_SECTOR_LED_COUNT; led++) {
+            for (c = 0; c < TAFI_LED_COLOR_FIELD_COUNT; c++) {
+                if (state->source[led] < 0)
+                    out[c] = TAFI_WIRE_OFF;
+                else
+                    out[c] = state->remap[led][in[state->source[led] * TAFI_LED_COLOR_FIELD_COUNT + c] & 0x7f];
+            }
+            out += TAFI_LED_COLOR_FIELD_COUNT;
+        }
+    }
+}
+
+/**
+ * Send a frame, optionally pre-mapped, with the transform applied and the
+ * bus held by tafi_bus_lock().
+ * Returns the bytes that went on the wire, valid until the next call.
+ */
+const unsigned char *tafi_transform_write_locked(const unsigned char *buf, dma_addr_t dma) {
+    struct tafi_transform_state *state;
+    unsigned int rotation;
+
+    rcu_read_lock();
+    state = rcu_dereference(tafi_transform_state);
+    if (state == NULL) {
+        rcu_read_unlock();
+        tafi_wire_write_locked(buf, dma);
+        return buf;
+    }
+
+    rotation = tafi_transform_rotation(state, ktime_get());
+
+    // a plain rotation is just a different starting sector, unless the
+    // capture has to see the frame as sent or the encoder the whole frame
+    if (!(state->args.flags & TAFI_TRANSFORM_MIRROR) && !state->args.radial_shift &&
+        !static_branch_unlikely(&tafi_capture_enabled) && !tafi_wire_compressing()) {
+        rcu_read_unlock();
+        tafi_data_write_rotated_locked(buf, dma, TAFI_DATA_BUF_LEN,
+            ((TAFI_SECTOR_COUNT - rotation) % TAFI_SECTOR_COUNT) * TAFI_SECTOR_BUF_LEN);
+        return buf;
+    }
+
+    tafi_transform_build(state, rotation, buf, tafi_transform_buf);
+    rcu_read_unlock();
+
+    tafi_wire_write_locked(tafi_transform_buf, DMA_MAPPING_ERROR);
+    return tafi_transform_buf;
+}
+
+static ssize_t tafi_transform_show(struct device *dev, char *buf, size_t offset) {
+    struct tafi_transform transform;
+
+    tafi_transform_get(&transform);
+    return sprintf(buf, "%d\n", *(s32 *) ((char *) &transform + offset));
+}
+
+static ssize_t tafi_transform_store(struct device *dev, const char *buf, size_t count, size_t offset) {
+    struct tafi_transform transform;
+    s32 value;
+    int ret;
+
+    ret = kstrtos32(buf, 0, &value);
+    if (ret < 0)
+        return ret;
+
+    // the read and the update must not interleave with another update
+    mutex_lock(&tafi_transform_mutex);
+    tafi_transform_get(&transform);
+    *(s32 *) ((char *) &transform + offset) = value;
+    ret = tafi_transform_replace(&transform);
+    mutex_unlock(&tafi_transform_mutex);
+
+    return ret < 0 ? ret : count;
+}
+
+#define TAFI_TRANSFORM_ATTR(_name, _field)                                                          \
+    static ssize_t _name##_show(struct device *dev, struct device_attribute *attr, char *buf) {     \
+        return tafi_transform_show(dev, buf, offsetof(struct tafi_transform, _field));              \
+    }                                                                                               \
+    static ssize_t _name##_store(struct device *dev, struct device_attribute *attr,                 \
+        const char *buf, size_t count) {                                                            \
+        return tafi_transform_store(dev, buf, count, offsetof(struct tafi_transform, _field));      \
+    }                                                                                               \
+    static DEVICE_ATTR_RW(_name)
+
+TAFI_TRANSFORM_ATTR(rotation, rotation);
+TAFI_TRANSFORM_ATTR(angular_velocity, angular_velocity);
+TAFI_TRANSFORM_ATTR(radial_shift, radial_shift);
+
+static ssize_t mirror_show(struct device *dev, struct device_attribute *attr, char *buf) {
+    struct tafi_transform transform;
+
+    tafi_transform_get(&transform);
+    return sprintf(buf, "%d\n", !!(transform.flags & TAFI_TRANSFORM_MIRROR));
+}
+
+static ssize_t mirror_store(struct device *dev, struct device_attribute *attr, const char *buf, size_t count) {
+    struct tafi_transform transform;
+    bool value;
+    int ret;
+
+    ret = kstrtobool(buf, &value);
+    if (ret < 0)
+        return ret;
+
+    mutex_lock(&tafi_transform_mutex);
+    tafi_transform_get(&transform);
+    if (value)
+        transform.flags |= TAFI_TRANSFORM_MIRROR;
+    else
+        transform.flags &= ~TAFI_TRANSFORM_MIRROR;
+    ret = tafi_transform_replace(&transform);
+    mutex_unlock(&tafi_transform_mutex);
+
+    return ret < 0 ? ret : count;
+}
+static DEVICE_ATTR_RW(mirror);
+
+static struct attribute *tafi_transform_attrs[] = {
+    &dev_attr_rotation.attr,
+    &dev_attr_angular_velocity.attr,
+    &dev_attr_radial_shift.attr,
+    &dev_attr_mirror.attr,
+    NULL,
+};
+
+static const struct attribute_group tafi_transform_group = {
+    .attrs = tafi_transform_attrs,
+};
+
+const struct attribute_group *tafi_transform_groups[] = {
+    &tafi_transform_group,
+    NULL,
+};
+
+int tafi_transform_init(void) {
+    tafi_transform_buf = kmalloc(TAFI_DATA_BUF_LEN, GFP_KERNEL);
+    if (tafi_transform_buf == NULL)
+        return -ENOMEM;
+    return 0;
+}
+
+/**
+ * Must be called after the thread has stopped.
+ */
+void tafi_transform_exit(void) {
+    kfree(rcu_dereference_protected(tafi_transform_state, 1));
+    RCU_INIT_POINTER(tafi_transform_state, NULL);
+    kfree(tafi_transform_buf);
+}
@@ -0,0 +1,37 @@
+/**
+ *  tafi_transform.h -- The Amazing Fan Idea driver
+ *  Geometric transforms applied by the transmit thread.
+ *
+ *      (C) 2017 Harindu Perera
+ *
+ *  This file is subject to the terms and conditions of the GNU General Public
+ *  License. See the file COPYING in the main directory of this archive for
+ *  more details.
+ */
+
+#ifndef TAFI_TRANSFORM_HDR
+#define TAFI_TRANSFORM_HDR
+
+#include <linux/sysfs.h>
+#include <linux/types.h>
+
+#include "tafi_ioctl.h"
+
+// Attributes of the transform, created on the character device.
+extern const struct attribute_group *tafi_transform_groups[];
+
+int tafi_transform_init(void);
+
+void tafi_transform_exit(void);
+
+int tafi_transform_set(const struct tafi_transform *transform);
+
+void tafi_transform_get(struct tafi_transform *transform);
+
+bool tafi_transform_active(void);
+
+bool tafi_transform_animated(void);
+
+const unsigned char *tafi_transform_write_locked(const unsigned char *buf, dma_addr_t dma);
+
+#endif
@@ -0,0 +1,201 @@
+/**
+ *  tafi_uapi.h -- The Amazing Fan Idea driver
+ *  Definitions shared with user space: the native frame layout and the
+ *  ioctls of /dev/tafi. Must not depend on anything but the uapi headers,
+ *  libtafi includes it as is.
+ *
+ *      (C) 2017 Harindu Perera
+ *
+ *  This file is subject to the terms and conditions of the GNU General Public
+ *  License. See the file COPYING in the main directory of this archive for
+ *  more details.
+ */
+
+#ifndef TAFI_UAPI
+#define TAFI_UAPI
+
+#include <linux/types.h>
+#include <linux/ioctl.h>
+
+#define TAFI_SECTOR_COUNT 150
+#define TAFI_SECTOR_LED_COUNT 20
+#define TAFI_LED_COLOR_FIELD_COUNT 3
+#define TAFI_SECTOR_BUF_LEN (TAFI_SECTOR_LED_COUNT * TAFI_LED_COLOR_FIELD_COUNT)
+#define TAFI_DATA_BUF_LEN (TAFI_SECTOR_COUNT * TAFI_SECTOR_BUF_LEN)
+
+// Indexed frames carry one palette index per LED, in wire order.
+#define TAFI_PALETTE_SIZE 256
+#define TAFI_INDEXED_BUF_LEN (TAFI_SECTOR_COUNT * TAFI_SECTOR_LED_COUNT)
+
+// Size of the Cartesian image the lookup tables sample from.
+#define TAFI_FB_XRES 80
+#define TAFI_FB_YRES 80
+
+// Writes at this offset carry a sequence of sector range updates instead of
+// raw frame bytes: a tafi_sector_range header followed by sector_count
+// sectors of data in the file's format, repeated. Like plain writes they
+// are staged until the transaction is committed, see TAFI_IOC_COMMIT. Far
+// beyond the frame of every format, so no plain write ever lands on it.
+#define TAFI_SPARSE_WRITE_OFFSET (1ULL << 40)
+
+struct tafi_sector_range {
+    __u16 first_sector;
+    __u16 sector_count;
+};
+
+// A byte range of the frame, used to commit several updates at once.
+struct tafi_range {
+    __u32 offset;
+    __u32 len;
+};
+
+// Record format of the debugfs frame capture stream. Each read returns
+// whole records, oldest first; gaps in seq mean the reader fell behind.
+struct tafi_capture_record {
+    __u64 seq;              // transmitted frame number
+    __u64 timestamp_ns;     // CLOCK_MONOTONIC time of the frame start signal
+    __u32 duration_ns;      // time spent on the bus
+    __u32 len;              // valid bytes in data
+    __u8 data[TAFI_DATA_BUF_LEN];
+};
+
+// ioctls on /dev/tafi
+#define TAFI_IOC_MAGIC 'T'
+
+// Number of native frames that can be exported as dma-bufs.
+#define TAFI_DMABUF_RING_FRAMES 4
+
+// Export slot index of the native frame ring as a dma-buf. The frame goes
+// live when the exporter is told about a CPU write via DMA_BUF_IOCTL_SYNC.
+struct tafi_dmabuf_export {
+    __u32 index;    // in: ring slot
+    __u32 flags;    // in: O_CLOEXEC and/or O_RDWR
+    __s32 fd;       // out: dma-buf file descriptor
+};
+
+// Display a native frame held in any dma-buf, e.g. one from udmabuf or
+// another driver. The buffer's exclusive fence is waited on before reading,
+// and fence_fd returns a sync_file that signals once the frame has been
+// picked up by the transmit thread.
+struct tafi_dmabuf_queue {
+    __s32 fd;       // in: dma-buf file descriptor
+    __u32 offset;   // in: byte offset of the frame in the buffer
+    __s32 fence_fd; // out: sync_file file descriptor
+    __u32 flags;    // in: reserved, must be 0
+};
+
+#define TAFI_IOC_DMABUF_EXPORT _IOWR(TAFI_IOC_MAGIC, 0x01, struct tafi_dmabuf_export)
+#define TAFI_IOC_DMABUF_QUEUE  _IOWR(TAFI_IOC_MAGIC, 0x02, struct tafi_dmabuf_queue)
+
+// Writes to /dev/tafi accumulate in a per-file transaction that goes live
+// as a whole on this ioctl, on fsync() or on close(). Writes on a file
+// opened with O_SYNC or O_DSYNC commit immediately.
+#define TAFI_IOC_COMMIT        _IO(TAFI_IOC_MAGIC, 0x03)
+
+// Geometric transform applied to every frame on its way to the wire, so
+// rotating or flipping static content costs no upload at all. Sector i is
+// sent with the content of sector i - rotation, mirrored first if asked.
+struct tafi_transform {
+    __s32 rotation;         // sectors in the direction of increasing index
+    __s32 angular_velocity; // millisectors per second added to rotation
+    __s32 radial_shift;     // LEDs outward, negative is inward
+    __u32 flags;            // TAFI_TRANSFORM_*
+};
+
+// Reflect sector s onto sector TAFI_SECTOR_COUNT - 1 - s.
+#define TAFI_TRANSFORM_MIRROR 0x1
+
+// Replace the transform. TAFI_IOC_GET_TRANSFORM returns the rotation
+// reached so far, so setting it back continues an animation seamlessly.
+#define TAFI_IOC_SET_TRANSFORM _IOW(TAFI_IOC_MAGIC, 0x04, struct tafi_transform)
+#define TAFI_IOC_GET_TRANSFORM _IOR(TAFI_IOC_MAGIC, 0x05, struct tafi_transform)
+
+// The display's palette, used for every indexed frame. A new palette takes
+// effect at the start of the next frame, without the frame being uploaded
+// again, so palette animation costs only these 768 bytes per step.
+struct tafi_palette {
+    __u8 entries[TAFI_PALETTE_SIZE][3];     // red, green, blue
+};
+
+#define TAFI_IOC_SET_PALETTE   _IOW(TAFI_IOC_MAGIC, 0x06, struct tafi_palette)
+#define TAFI_IOC_GET_PALETTE   _IOR(TAFI_IOC_MAGIC, 0x07, struct tafi_palette)
+
+// Layout of the data read and written through this file descriptor. The
+// open transaction is committed before the format changes.
+#define TAFI_FORMAT_NATIVE     0   // TAFI_DATA_BUF_LEN bytes in wire format
+#define TAFI_FORMAT_INDEXED8   1   // TAFI_INDEXED_BUF_LEN palette indices
+#define TAFI_FORMAT_NATIVE16   2   // TAFI_DEEP_BUF_LEN bytes, see below
+
+// Native layout with a __u16 per channel, in wire channel order but before
+// brightness correction. What the wire can't resolve is dithered in over
+// successive frames by the driver, so static content needs no re-upload.
+#define TAFI_DEEP_BUF_LEN (TAFI_DATA_BUF_LEN * 2)
+
+#define TAFI_IOC_SET_FORMAT    _IOW(TAFI_IOC_MAGIC, 0x08, __u32)
+
+// Frame clock: ticks are counted from module load, or from the tick
+// numbered with TAFI_IOC_SET_CLOCK. Fans sharing a sync input count the
+// same edges, so once they have numbered the same edge the same tick
+// number starts the same frame on all of them.
+struct tafi_clock_info {
+    __u64 tick;         // last tick
+    __u64 tick_ns;      // CLOCK_MONOTONIC time of the last tick
+    __u32 period_us;    // nominal time between ticks
+    __u32 flags;        // TAFI_CLOCK_*
+};
+
+#define TAFI_CLOCK_SYNCED      0x1  // ticks are edges of the sync input
+
+#define TAFI_IOC_GET_CLOCK     _IOR(TAFI_IOC_MAGIC, 0x0a, struct tafi_clock_info)
+
+// Number the next tick, the shared epoch of a group: set the same number
+// on every fan while the sync input is held still, and the edge that
+// releases it gets that number on all of them.
+#define TAFI_IOC_SET_CLOCK     _IOW(TAFI_IOC_MAGIC, 0x0f, __u64)
+
+// Commit the open transaction so it is first transmitted at the given
+// tick, or as soon as possible if that has passed. Committing the same
+// tick on every fan of a group updates them all in the same frame. A later
+// scheduled commit replaces one still pending.
+#define TAFI_IOC_COMMIT_AT     _IOW(TAFI_IOC_MAGIC, 0x09, __u64)
+
+// How the frames committed through a file descriptor are presented. The
+// display runs slower than most producers, this decides what gives.
+struct tafi_present {
+    __u32 mode;         // TAFI_PRESENT_*
+    __u32 depth;        // FIFO: queued frames before commits block, at most TAFI_PRESENT_FIFO_MAX
+    __u64 dropped;      // out: frames of this file that were never transmitted
+};
+
+// The newest committed frame replaces one not yet transmitted. Never
+// blocks, and the default.
+#define TAFI_PRESENT_MAILBOX   0
+// Committed frames are queued and each transmitted at least once, in
+// order. Commits block while the queue is full, or fail with EAGAIN on a
+// non-blocking file.
+#define TAFI_PRESENT_FIFO      1
+// Every write goes live by itself, without waiting for a commit. Lowest
+// latency, but a frame written in several parts may be shown half done.
+#define TAFI_PRESENT_IMMEDIATE 2
+
+#define TAFI_PRESENT_FIFO_MAX  8
+
+// Setting the mode commits the open transaction first.
+#define TAFI_IOC_SET_PRESENT   _IOW(TAFI_IOC_MAGIC, 0x0b, struct tafi_present)
+#define TAFI_IOC_GET_PRESENT   _IOR(TAFI_IOC_MAGIC, 0x0c, struct tafi_present)
+
+// Crossfade: frames committed through a file descriptor blend in from what
+// is on display over this many transmitted frames instead of replacing it
+// at once, 0 (the default) cuts. The blend runs in the driver on native
+// frames, so a slideshow commits each slide once. A FIFO queue waits while
+// a fade runs.
+#define TAFI_FADE_MAX          65535
+
+#define TAFI_IOC_SET_FADE      _IOW(TAFI_IOC_MAGIC, 0x0d, __u32)
+#define TAFI_IOC_GET_FADE      _IOR(TAFI_IOC_MAGIC, 0x0e, __u32)
+
+// On the framebuffer device: export the video memory as a dma-buf (index is
+// ignored). A DMA_BUF_IOCTL_SYNC write end flushes it to the display.
+#define TAFI_FBIO_DMABUF_EXPORT _IOWR(TAFI_IOC_MAGIC, 0x10, struct tafi_dmabuf_export)
+
+#endif
@@ -0,0 +1,469 @@
+/**
+ *  tafi_v4l2.c -- The Amazing Fan Idea driver
+ *  V4L2 video output device.
+ *
+ *  Queued buffers are handed to a worker thread, which samples only the
+ *  pixels that map onto an LED, converts those to RGB, commits the frame
+ *  and returns the buffer once the transmit thread has picked it up. A
+ *  stream therefore plays at the display's pace.
+ * 
+ *      (C) 2017 Harindu Perera
+ *  
+ *  This file is subject to the terms and conditions of the GNU General Public
+ *  License. See the file COPYING in the main directory of this archive for
+ *  more details.
+ */
+
+#include <linux/kthread.h>
+#include <linux/list.h>
+#include <linux/module.h>
+#include <linux/mutex.h>
+#include <linux/platform_device.h>
+#include <linux/slab.h>
+#include <linux/spinlock.h>
+#include <linux/wait.h>
+
+#include <media/v4l2-device.h>
+#include <media/v4l2-ioctl.h>
+#include <media/v4l2-dev.h>
+#include <media/videobuf2-v4l2.h>
+#include <media/videobuf2-vmalloc.h>
+
+#include "tafi_common.h"
+#include "tafi_ioctl.h"
+#include "tafi_convert.h"
+#include "tafi_v4l2.h"
+
+struct tafi_v4l2_buffer {
+    struct vb2_v4l2_buffer vb;
+    struct list_head node;
+};
+
+struct tafi_v4l2 {
+    struct v4l2_device v4l2_dev;
+    struct video_device vdev;
+    struct vb2_queue queue;
+    // Serializes ioctls and queue operations.
+    struct mutex lock;
+
+    struct v4l2_pix_format format;
+
+    // Buffers waiting to be displayed.
+    struct list_head pending;
+    spinlock_t pending_lock;
+    wait_queue_head_t pending_wait;
+
+    struct task_struct *worker;
+    u32 sequence;
+
+    unsigned char frame[TAFI_DATA_BUF_LEN];
+};
+
+// The plane of a buffer being converted, and its format.
+struct tafi_v4l2_source {
+    const unsigned char *vaddr;
+    const struct v4l2_pix_format *format;
+};
+
+static struct platform_device *tafi_v4l2_pdev;
+
+static const u32 tafi_v4l2_formats[] = {
+    V4L2_PIX_FMT_RGB24,
+    V4L2_PIX_FMT_YUYV,
+    V4L2_PIX_FMT_NV12,
+};
+
+// Color conversion
+
+static inline unsigned char tafi_v4l2_clamp(int v) {
+    return v < 0 ? 0 : (v > 255 ? 255 : v);
+}
+
+/**
+ * BT.601 limited range YCbCr to RGB, in 8.8 fixed point.
+ */
+static inline void tafi_v4l2_yuv_to_rgb(int y, int u, int v, unsigned char *rgb) {
+    int c = 298 * (y - 16) + 128;
+    int d = u - 128;
+    int e = v - 128;
+
+    rgb[0] = tafi_v4l2_clamp((c + 409 * e) >> 8);
+    rgb[1] = tafi_v4l2_clamp((c - 100 * d - 208 * e) >> 8);
+    rgb[2] = tafi_v4l2_clamp((c + 516 * d) >> 8);
+}
+
+static void tafi_v4l2_sample_rgb24(const void *priv, unsigned int x, unsigned int y, unsigned char *rgb) {
+    const struct tafi_v4l2_source *src = priv;
+    const unsigned char *p = src->vaddr + y * src->format->bytesperline + x * 3;
+
+    rgb[0] = p[0];
+    rgb[1] = p[1];
+    rgb[2] = p[2];
+}
+
+static void tafi_v4l2_sample_yuyv(const void *priv, unsigned int x, unsigned int y, unsigned char *rgb) {
+    const struct tafi_v4l2_source *src = priv;
+    // Y0 U Y1 V, one chroma pair per two pixels
+    const unsigned char *p = src->vaddr + y * src->format->bytesperline + (x & ~1U) * 2;
+
+    tafi_v4l2_yuv_to_rgb(p[(x & 1) * 2], p[1], p[3], rgb);
+}
+
+static void tafi_v4l2_sample_nv12(const void *priv, unsigned int x, unsigned int y, unsigned char *rgb) {
+    const struct tafi_v4l2_source *src = priv;
+    unsigned int stride = src->format->bytesperline;
+    const unsigned char *luma = src->vaddr + y * stride + x;
+    // interleaved CbCr plane at half resolution follows the luma plane
+    const unsigned char *chroma = src->vaddr + src->format->height * stride + (y / 2) * stride + (x & ~1U);
+
+    tafi_v4l2_yuv_to_rgb(luma[0], chroma[0], chroma[1], rgb);
+}
+
+static void tafi_v4l2_convert(struct tafi_v4l2 *dev, const void *vaddr) {
+    struct tafi_v4l2_source src = {
+        .vaddr = vaddr,
+        .format = &dev->format,
+    };
+    tafi_convert_sample_t sample;
+
+    switch (dev->format.pixelformat) {
+    case V4L2_PIX_FMT_YUYV:
+        sample = tafi_v4l2_sample_yuyv;
+        break;
+    case V4L2_PIX_FMT_NV12:
+        sample = tafi_v4l2_sample_nv12;
+        break;
+    default:
+        sample = tafi_v4l2_sample_rgb24;
+        break;
+    }
+
+    tafi_convert_sampled(dev->format.width, dev->format.height, sample, &src, dev->frame);
+}
+
+// Worker
+
+static struct tafi_v4l2_buffer *tafi_v4l2_next_buffer(struct tafi_v4l2 *dev) {
+    struct tafi_v4l2_buffer *buf = NULL;
+    unsigned long flags;
+
+    spin_lock_irqsave(&dev->pending_lock, flags);
+    if (!list_empty(&dev->pending)) {
+        buf = list_first_entry(&dev->pending, struct tafi_v4l2_buffer, node);
+        list_del(&buf->node);
+    }
+    spin_unlock_irqrestore(&dev->pending_lock, flags);
+    return buf;
+}
+
+static int tafi_v4l2_worker(void *data) {
+    struct tafi_v4l2 *dev = data;
+    struct tafi_range range = { .offset = 0, .len = TAFI_DATA_BUF_LEN };
+    struct tafi_v4l2_buffer *buf;
+    u64 ticket;
+    int ret;
+
+    while (!kthread_should_stop()) {
+        buf = tafi_v4l2_next_buffer(dev);
+        if (buf == NULL) {
+            wait_event_interruptible(dev->pending_wait,
+                !list_empty_careful(&dev->pending) || kthread_should_stop());
+            continue;
+        }
+
+        tafi_v4l2_convert(dev, vb2_plane_vaddr(&buf->vb.vb2_buf, 0));
+        ret = tafi_set_color_ranges(dev->frame, &range, 1, &ticket);
+
+        // hold the buffer until the frame is on its way to the fan
+        if (ret == 0)
+            tafi_wait_for_pickup(ticket);
+
+        buf->vb.sequence = dev->sequence++;
+        vb2_buffer_done(&buf->vb.vb2_buf, ret ? VB2_BUF_STATE_ERROR : VB2_BUF_STATE_DONE);
+    }
+
+    return 0;
+}
+
+// Queue
+
+static int tafi_v4l2_queue_setup(struct vb2_queue *vq, unsigned int *nbuffers, unsigned int *nplanes,
+    unsigned int sizes[], struct device *alloc_devs[]) {
+
+    struct tafi_v4l2 *dev = vb2_get_drv_priv(vq);
+
+    if (*nplanes)
+        return sizes[0] < dev->format.sizeimage ? -EINVAL : 0;
+
+    *nplanes = 1;
+    sizes[0] = dev->format.sizeimage;
+    if (*nbuffers < TAFI_V4L2_MIN_BUFFERS)
+        *nbuffers = TAFI_V4L2_MIN_BUFFERS;
+    return 0;
+}
+
+static int tafi_v4l2_buf_prepare(struct vb2_buffer *vb) {
+    struct tafi_v4l2 *dev = vb2_get_drv_priv(vb->vb2_queue);
+
+    if (vb2_plane_size(vb, 0) < dev->format.sizeimage)
+        return -EINVAL;
+    if (vb2_get_plane_payload(vb, 0) < dev->format.sizeimage)
+        return -EINVAL;
+    return 0;
+}
+
+static void tafi_v4l2_buf_queue(struct vb2_buffer *vb) {
+    struct tafi_v4l2 *dev = vb2_get_drv_priv(vb->vb2_queue);
+    struct vb2_v4l2_buffer *vbuf = to_vb2_v4l2_buffer(vb);
+    struct tafi_v4l2_buffer *buf = container_of(vbuf, struct tafi_v4l2_buffer, vb);
+    unsigned long flags;
+
+    spin_lock_irqsave(&dev->pending_lock, flags);
+    list_add_tail(&buf->node, &dev->pending);
+    spin_unlock_irqrestore(&dev->pending_lock, flags);
+    wake_up_interruptible(&dev->pending_wait);
+}
+
+static void tafi_v4l2_return_buffers(struct tafi_v4l2 *dev, enum vb2_buffer_state state) {
+    struct tafi_v4l2_buffer *buf;
+
+    while ((buf = tafi_v4l2_next_buffer(dev)) != NULL)
+        vb2_buffer_done(&buf->vb.vb2_buf, state);
+}
+
+static int tafi_v4l2_start_streaming(struct vb2_queue *vq, unsigned int count) {
+    struct tafi_v4l2 *dev = vb2_get_drv_priv(vq);
+
+    dev->sequence = 0;
+    dev->worker = kthread_run(tafi_v4l2_worker, dev, "tafi_v4l2");
+    if (IS_ERR(dev->worker)) {
+        tafi_v4l2_return_buffers(dev, VB2_BUF_STATE_QUEUED);
+        return PTR_ERR(dev->worker);
+    }
+    return 0;
+}
+
+static void tafi_v4l2_stop_streaming(struct vb2_queue *vq) {
+    struct tafi_v4l2 *dev = vb2_get_drv_priv(vq);
+
+    kthread_stop(dev->worker);
+    dev->worker = NULL;
+    tafi_v4l2_return_buffers(dev, VB2_BUF_STATE_ERROR);
+}
+
+static const struct vb2_ops tafi_v4l2_qops = {
+    .queue_setup = tafi_v4l2_queue_setup,
+    .buf_prepare = tafi_v4l2_buf_prepare,
+    .buf_queue = tafi_v4l2_buf_queue,
+    .start_streaming = tafi_v4l2_start_streaming,
+    .stop_streaming = tafi_v4l2_stop_streaming,
+    .wait_prepare = vb2_ops_wait_prepare,
+    .wait_finish = vb2_ops_wait_finish,
+};
+
+// Formats
+
+static void tafi_v4l2_fill_format(struct v4l2_pix_format *pix) {
+    unsigned int i;
+
+    for (i = 0; i < ARRAY_SIZE(tafi_v4l2_formats); i++) {
+        if (pix->pixelformat == tafi_v4l2_formats[i])
+            break;
+    }
+    if (i == ARRAY_SIZE(tafi_v4l2_formats))
+        pix->pixelformat = V4L2_PIX_FMT_RGB24;
+
+    // even sizes keep the subsampled chroma simple
+    pix->width = clamp_t(u32, pix->width, TAFI_V4L2_MIN_WIDTH, TAFI_V4L2_MAX_WIDTH) & ~1U;
+    pix->height = clamp_t(u32, pix->height, TAFI_V4L2_MIN_HEIGHT, TAFI_V4L2_MAX_HEIGHT) & ~1U;
+    pix->field = V4L2_FIELD_NONE;
+
+    switch (pix->pixelformat) {
+    case V4L2_PIX_FMT_YUYV:
+        pix->bytesperline = pix->width * 2;
+        pix->sizeimage = pix->bytesperline * pix->height;
+        pix->colorspace = V4L2_COLORSPACE_SMPTE170M;
+        break;
+    case V4L2_PIX_FMT_NV12:
+        pix->bytesperline = pix->width;
+        pix->sizeimage = pix->bytesperline * pix->height * 3 / 2;
+        pix->colorspace = V4L2_COLORSPACE_SMPTE170M;
+        break;
+    default:
+        pix->bytesperline = pix->width * 3;
+        pix->sizeimage = pix->bytesperline * pix->height;
+        pix->colorspace = V4L2_COLORSPACE_SRGB;
+        break;
+    }
+
+    pix->ycbcr_enc = V4L2_YCBCR_ENC_DEFAULT;
+    pix->quantization = V4L2_QUANTIZATION_DEFAULT;
+    pix->xfer_func = V4L2_XFER_FUNC_DEFAULT;
+    pix->priv = 0;
+}
+
+static int tafi_v4l2_querycap(struct file *file, void *priv, struct v4l2_capability *cap) {
+    strscpy(cap->driver, TAFI_V4L2_DRIVER_NAME, sizeof(cap->driver));
+    strscpy(cap->card, TAFI_V4L2_CARD_NAME, sizeof(cap->card));
+    snprintf(cap->bus_info, sizeof(cap->bus_info), "platform:%s", TAFI_V4L2_DRIVER_NAME);
+    return 0;
+}
+
+static int tafi_v4l2_enum_fmt(struct file *file, void *priv, struct v4l2_fmtdesc *f) {
+    if (f->index >= ARRAY_SIZE(tafi_v4l2_formats))
+        return -EINVAL;
+    f->pixelformat = tafi_v4l2_formats[f->index];
+    return 0;
+}
+
+static int tafi_v4l2_g_fmt(struct file *file, void *priv, struct v4l2_format *f) {
+    struct tafi_v4l2 *dev = video_drvdata(file);
+
+    f->fmt.pix = dev->format;
+    return 0;
+}
+
+static int tafi_v4l2_try_fmt(struct file *file, void *priv, struct v4l2_format *f) {
+    tafi_v4l2_fill_format(&f->fmt.pix);
+    return 0;
+}
+
+static int tafi_v4l2_s_fmt(struct file *file, void *priv, struct v4l2_format *f) {
+    struct tafi_v4l2 *dev = video_drvdata(file);
+
+    if (vb2_is_busy(&dev->queue))
+        return -EBUSY;
+
+    tafi_v4l2_fill_format(&f->fmt.pix);
+    dev->format = f->fmt.pix;
+    return 0;
+}
+
+static const struct v4l2_ioctl_ops tafi_v4l2_ioctl_ops = {
+    .vidioc_querycap = tafi_v4l2_querycap,
+    .vidioc_enum_fmt_vid_out = tafi_v4l2_enum_fmt,
+    .vidioc_g_fmt_vid_out = tafi_v4l2_g_fmt,
+    .vidioc_try_fmt_vid_out = tafi_v4l2_try_fmt,
+    .vidioc_s_fmt_vid_out = tafi_v4l2_s_fmt,
+    .vidioc_reqbufs = vb2_ioctl_reqbufs,
+    .vidioc_create_bufs = vb2_ioctl_create_bufs,
+    .vidioc_prepare_buf = vb2_ioctl_prepare_buf,
+    .vidioc_querybuf = vb2_ioctl_querybuf,
+    .vidioc_qbuf = vb2_ioctl_qbuf,
+    .vidioc_dqbuf = vb2_ioctl_dqbuf,
+    .vidioc_expbuf = vb2_ioctl_expbuf,
+    .vidioc_streamon = vb2_ioctl_streamon,
+    .vidioc_streamoff = vb2_ioctl_streamoff,
+};
+
+static const struct v4l2_file_operations tafi_v4l2_fops = {
+    .owner = THIS_MODULE,
+    .open = v4l2_fh_open,
+    .release = vb2_fop_release,
+    .write = vb2_fop_write,
+    .poll = vb2_fop_poll,
+    .mmap = vb2_fop_mmap,
+    .unlocked_ioctl = video_ioctl2,
+};
+
+// Device
+
+static int tafi_v4l2_probe(struct platform_device *pdev) {
+    struct tafi_v4l2 *dev;
+    struct vb2_queue *q;
+    int ret;
+
+    dev = devm_kzalloc(&pdev->dev, sizeof(*dev), GFP_KERNEL);
+    if (dev == NULL)
+        return -ENOMEM;
+
+    mutex_init(&dev->lock);
+    INIT_LIST_HEAD(&dev->pending);
+    spin_lock_init(&dev->pending_lock);
+    init_waitqueue_head(&dev->pending_wait);
+
+    dev->format.width = TAFI_FB_XRES;
+    dev->format.height = TAFI_FB_YRES;
+    dev->format.pixelformat = V4L2_PIX_FMT_RGB24;
+    tafi_v4l2_fill_format(&dev->format);
+
+    ret = v4l2_device_register(&pdev->dev, &dev->v4l2_dev);
+    if (ret)
+        return ret;
+
+    q = &dev->queue;
+    q->type = V4L2_BUF_TYPE_VIDEO_OUTPUT;
+    q->io_modes = VB2_MMAP | VB2_USERPTR | VB2_DMABUF | VB2_WRITE;
+    q->drv_priv = dev;
+    q->buf_struct_size = sizeof(struct tafi_v4l2_buffer);
+    q->ops = &tafi_v4l2_qops;
+    q->mem_ops = &vb2_vmalloc_memops;
+    q->timestamp_flags = V4L2_BUF_FLAG_TIMESTAMP_COPY;
+    q->min_buffers_needed = 1;
+    q->lock = &dev->lock;
+    q->dev = &pdev->dev;
+
+    ret = vb2_queue_init(q);
+    if (ret)
+        goto err_v4l2;
+
+    strscpy(dev->vdev.name, TAFI_V4L2_CARD_NAME, sizeof(dev->vdev.name));
+    dev->vdev.fops = &tafi_v4l2_fops;
+    dev->vdev.ioctl_ops = &tafi_v4l2_ioctl_ops;
+    dev->vdev.release = video_device_release_empty;
+    dev->vdev.v4l2_dev = &dev->v4l2_dev;
+    dev->vdev.queue = q;
+    dev->vdev.lock = &dev->lock;
+    dev->vdev.vfl_dir = VFL_DIR_TX;
+    dev->vdev.device_caps = V4L2_CAP_VIDEO_OUTPUT | V4L2_CAP_STREAMING | V4L2_CAP_READWRITE;
+    video_set_drvdata(&dev->vdev, dev);
+
+    ret = video_register_device(&dev->vdev, VFL_TYPE_VIDEO, -1);
+    if (ret)
+        goto err_v4l2;
+
+    platform_set_drvdata(pdev, dev);
+    printk(KERN_INFO TAFI_LOG_PREFIX"V4L2 output device registered as %s.", video_device_node_name(&dev->vdev));
+    return 0;
+
+err_v4l2:
+    v4l2_device_unregister(&dev->v4l2_dev);
+    return ret;
+}
+
+static int tafi_v4l2_remove(struct platform_device *pdev) {
+    struct tafi_v4l2 *dev = platform_get_drvdata(pdev);
+
+    video_unregister_device(&dev->vdev);
+    v4l2_device_unregister(&dev->v4l2_dev);
+    return 0;
+}
+
+static struct platform_driver tafi_v4l2_platform_driver = {
+    .probe = tafi_v4l2_probe,
+    .remove = tafi_v4l2_remove,
+    .driver = {
+        .name = TAFI_V4L2_DRIVER_NAME,
+    },
+};
+
+int tafi_v4l2_init(void) {
+    int ret;
+
+    ret = platform_driver_register(&tafi_v4l2_platform_driver);
+    if (ret)
+        return ret;
+
+    tafi_v4l2_pdev = platform_device_register_simple(TAFI_V4L2_DRIVER_NAME, -1, NULL, 0);
+    if (IS_ERR(tafi_v4l2_pdev)) {
+        platform_driver_unregister(&tafi_v4l2_platform_driver);
+        return PTR_ERR(tafi_v4l2_pdev);
+    }
+
+    return 0;
+}
+
+void tafi_v4l2_exit(void) {
+    platform_device_unregister(tafi_v4l2_pdev);
+    platform_driver_unregister(&tafi_v4l2_platform_driver);
+}
@@ -0,0 +1,31 @@
+/**
+ *  tafi_v4l2.h -- The Amazing Fan Idea driver
+ *  V4L2 video output device.
+ * 
+ *      (C) 2017 Harindu Perera
+ *  
+ *  This file is subject to the terms and conditions of the GNU General Public
+ *  License. See the file COPYING in the main directory of this archive for
+ *  more details.
+ */
+
+#ifndef TAFI_V4L2_HDR
+#define TAFI_V4L2_HDR
+
+#define TAFI_V4L2_DRIVER_NAME "tafi_v4l2"
+#define TAFI_V4L2_CARD_NAME "The Amazing Fan Idea"
+
+// Accepted source frame sizes. Frames are scaled to the display while
+// sampling, so there is no need to scale them in user space.
+#define TAFI_V4L2_MIN_WIDTH 16
+#define TAFI_V4L2_MIN_HEIGHT 16
+#define TAFI_V4L2_MAX_WIDTH 1920
+#define TAFI_V4L2_MAX_HEIGHT 1088
+
+#define TAFI_V4L2_MIN_BUFFERS 2
+
+int tafi_v4l2_init(void);
+
+void tafi_v4l2_exit(void);
+
+#endif
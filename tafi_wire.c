@@ -0,0 +1,108 @@
+/**
+ *  tafi_wire.c -- The Amazing Fan Idea driver
+ *  Compression of frames on their way to the wire, see tafi_wire.h for the
+ *  format and the encoder.
+ *
+ *  Only receivers that decode the format can take it, so it is off by
+ *  default and the setting is latched once per frame.
+ *
+ *      (C) 2017 Harindu Perera
+ *
+ *  This file is subject to the terms and conditions of the GNU General Public
+ *  License. See the file COPYING in the main directory of this archive for
+ *  more details.
+ */
+
+#include <linux/dma-mapping.h>
+#include <linux/ktime.h>
+#include <linux/module.h>
+#include <linux/slab.h>
+
+#include "tafi_common.h"
+#include "tafi_ioctl.h"
+#include "tafi_bus.h"
+#include "tafi_stats.h"
+#include "tafi_wire.h"
+
+static bool wire_compression;
+module_param(wire_compression, bool, 0644);
+MODULE_PARM_DESC(wire_compression, "Run-length compress frames on the wire, the receiver must decode it");
+
+// Compressed frame being sent, only used by the thread.
+static unsigned char *tafi_wire_buf;
+// Bytes of tafi_wire_buf filled by the pieces of a pipelined frame.
+static unsigned int tafi_wire_fill;
+// wire_compression as latched for the frame being sent.
+static bool tafi_wire_frame_compressed;
+
+static TAFI_HIST(tafi_wire_encode_time, "wire_encode");
+static TAFI_COUNTER(tafi_wire_bytes_raw, "wire_bytes_raw");
+static TAFI_COUNTER(tafi_wire_bytes_sent, "wire_bytes_sent");
+
+static unsigned int tafi_wire_encode_timed(const unsigned char *frame, unsigned int first, unsigned int count,
+    unsigned char *dst) {
+
+    ktime_t start = ktime_get();
+    unsigned int len;
+
+    len = tafi_wire_encode(frame, first, count, dst);
+    tafi_hist_add(&tafi_wire_encode_time, ktime_to_ns(ktime_sub(ktime_get(), start)));
+    tafi_counter_add(&tafi_wire_bytes_raw, count * TAFI_SECTOR_BUF_LEN);
+    tafi_counter_add(&tafi_wire_bytes_sent, len);
+    return len;
+}
+
+bool tafi_wire_compressing(void) {
+    return READ_ONCE(wire_compression);
+}
+
+/**
+ * Send a whole native frame, optionally pre-mapped, compressed if enabled,
+ * with the bus held by tafi_bus_lock().
+ */
+int tafi_wire_write_locked(const unsigned char *frame, dma_addr_t dma) {
+    unsigned int len;
+
+    if (!READ_ONCE(wire_compression))
+        return tafi_data_write_locked(frame, dma, TAFI_DATA_BUF_LEN);
+
+    len = tafi_wire_encode_timed(frame, 0, TAFI_SECTOR_COUNT, tafi_wire_buf);
+    return tafi_data_write_locked(tafi_wire_buf, DMA_MAPPING_ERROR, len);
+}
+
+/**
+ * Queue sectors first to first + count - 1 of a native frame, compressed
+ * if enabled, see tafi_data_queue_locked(). Pieces must be queued in order,
+ * starting with sector 0.
+ */
+int tafi_wire_queue_locked(const unsigned char *frame, unsigned int first, unsigned int count) {
+    unsigned int len;
+
+    if (first == 0) {
+        tafi_wire_frame_compressed = READ_ONCE(wire_compression);
+        tafi_wire_fill = 0;
+    }
+
+    if (!tafi_wire_frame_compressed)
+        return tafi_data_queue_locked(frame + first * TAFI_SECTOR_BUF_LEN, count * TAFI_SECTOR_BUF_LEN);
+
+    // earlier pieces may still be on the wire, so append after them
+    len = tafi_wire_encode_timed(frame, first, count, tafi_wire_buf + tafi_wire_fill);
+    tafi_wire_fill += len;
+    return tafi_data_queue_locked(tafi_wire_buf + tafi_wire_fill - len, len);
+}
+
+int tafi_wire_init(void) {
+    tafi_wire_buf = kmalloc(TAFI_DATA_BUF_LEN, GFP_KERNEL);
+    if (tafi_wire_buf == NULL)
+        return -ENOMEM;
+
+    tafi_stats_register_hist(&tafi_wire_encode_time);
+    tafi_stats_register_counter(&tafi_wire_bytes_raw);
+    tafi_stats_register_counter(&tafi_wire_bytes_sent);
+    return 0;
+}
+
+void tafi_wire_exit(void) {
+    kfree(tafi_wire_buf);
+}
@@ -0,0 +1,228 @@
+/**
+ *  tafi_wire.h -- The Amazing Fan Idea driver
+ *  Compressed wire format and its reference decoder.
+ *
+ *  Every byte of a native frame has the top bit set, so bytes with it
+ *  clear are free to carry commands. A compressed frame is a stream of
+ *  LEDs in wire order, each either given literally as its three bytes, or
+ *  produced by a command byte standing for up to 64 LEDs:
+ *
+ *      1bbbbbbb 1rrrrrrr 1ggggggg  one LED, as in a native frame
+ *      00nnnnnn                    n + 1 copies of the previous LED
+ *      01nnnnnn                    the next n + 1 LEDs as they are in
+ *                                  the previous sector
+ *
+ *  The previous LED of the first LED of a sector is the last one of the
+ *  sector before. Before the first sector of a frame there is a sector of
+ *  LEDs that are off, so frames decode on their own. A command never
+ *  reaches past the end of its sector. A native frame is a valid
+ *  compressed frame, so a receiver that decodes this format accepts both.
+ *
+ *  The encoder is greedy: at every LED it takes the longer of the run of
+ *  copies of the previous LED and the run of LEDs unchanged from the
+ *  previous sector, and a literal if both are empty. A command costs one
+ *  byte against three for a literal, so a sector never grows, and one with
+ *  nothing to compress goes out as its raw bytes. Frames written natively
+ *  or through a dma-buf may have bytes with the top bit clear; only the
+ *  low seven bits carry a value, so literals go out with the top bit
+ *  forced on and LEDs are compared on those bits alone. The decoded frame
+ *  is the input with the top bit of every byte set.
+ *
+ *  The encoder and the decoder below are freestanding and depend only on
+ *  tafi_uapi.h, so the driver, test code and hardware models all build the
+ *  same code. The decoder is the reference for receivers.
+ *
+ *      (C) 2017 Harindu Perera
+ *
+ *  This file is subject to the terms and conditions of the GNU General Public
+ *  License. See the file COPYING in the main directory of this archive for
+ *  more details.
+ */
+
+#ifndef TAFI_WIRE_HDR
+#define TAFI_WIRE_HDR
+
+#include "tafi_uapi.h"
+
+// Wire value of a dark channel.
+#define TAFI_WIRE_OFF 0x80
+
+#define TAFI_WIRE_LITERAL 0x80
+#define TAFI_WIRE_RUN 0x00
+#define TAFI_WIRE_COPY 0x40
+#define TAFI_WIRE_COMMAND_MASK 0xc0
+#define TAFI_WIRE_COUNT_MASK 0x3f
+#define TAFI_WIRE_MAX_COUNT (TAFI_WIRE_COUNT_MASK + 1)
+
+/**
+ * Whether two LEDs are the same on the wire, which sets the top bit of
+ * every byte.
+ */
+static inline int tafi_wire_led_equal(const unsigned char *a, const unsigned char *b) {
+    return !(((a[0] ^ b[0]) | (a[1] ^ b[1]) | (a[2] ^ b[2])) & ~TAFI_WIRE_LITERAL);
+}
+
+/**
+ * Encode one sector into dst, prev being the sector before in the frame,
+ * or NULL for the first sector of a frame.
+ * Returns the number of bytes written, at most TAFI_SECTOR_BUF_LEN.
+ */
+static inline unsigned int tafi_wire_encode_sector(const unsigned char *sector, const unsigned char *prev,
+    unsigned char *dst) {
+
+    static const unsigned char off[TAFI_LED_COLOR_FIELD_COUNT] = { TAFI_WIRE_OFF, TAFI_WIRE_OFF, TAFI_WIRE_OFF };
+    const unsigned char *last = prev ? prev + (TAFI_SECTOR_LED_COUNT - 1) * TAFI_LED_COLOR_FIELD_COUNT : off;
+    const unsigned char *led;
+    unsigned char *out = dst;
+    unsigned int l = 0;
+    unsigned int run;
+    unsigned int copy;
+
+    while (l < TAFI_SECTOR_LED_COUNT) {
+        led = sector + l * TAFI_LED_COLOR_FIELD_COUNT;
+
+        for (run = 0; l + run < TAFI_SECTOR_LED_COUNT && run < TAFI_WIRE_MAX_COUNT; run++)
+            if (!tafi_wire_led_equal(led + run * TAFI_LED_COLOR_FIELD_COUNT, last))
+                break;
+        for (copy = 0; l + copy < TAFI_SECTOR_LED_COUNT && copy < TAFI_WIRE_MAX_COUNT; copy++)
+            if (!tafi_wire_led_equal(led + copy * TAFI_LED_COLOR_FIELD_COUNT,
+                    prev ? prev + (l + copy) * TAFI_LED_COLOR_FIELD_COUNT : off))
+                break;
+
+        if (run == 0 && copy == 0) {
+            out[0] = led[0] | TAFI_WIRE_LITERAL;
+            out[1] = led[1] | TAFI_WIRE_LITERAL;
+            out[2] = led[2] | TAFI_WIRE_LITERAL;
+            out += TAFI_LED_COLOR_FIELD_COUNT;
+            last = led;
+            l++;
+        } else if (run >= copy) {
+            *out++ = TAFI_WIRE_RUN | (run - 1);
+            l += run;
+        } else {
+            *out++ = TAFI_WIRE_COPY | (copy - 1);
+            l += copy;
+            last = sector + (l - 1) * TAFI_LED_COLOR_FIELD_COUNT;
+        }
+    }
+
+    return out - dst;
+}
+
+/**
+ * Encode sectors first to first + count - 1 of a native frame into dst,
+ * which needs room for count * TAFI_SECTOR_BUF_LEN bytes. Sectors before
+ * first must be final already, the first one refers to them.
+ * Returns the number of bytes written.
+ */
+static inline unsigned int tafi_wire_encode(const unsigned char *frame, unsigned int first, unsigned int count,
+    unsigned char *dst) {
+
+    const unsigned char *prev;
+    unsigned int len = 0;
+    unsigned int s;
+
+    for (s = first; s < first + count; s++) {
+        prev = s ? frame + (s - 1) * TAFI_SECTOR_BUF_LEN : 0;
+        len += tafi_wire_encode_sector(frame + s * TAFI_SECTOR_BUF_LEN, prev, dst + len);
+    }
+
+    return len;
+}
+
+/**
+ * Decode one sector of a compressed frame from src, at most len bytes,
+ * into dst, TAFI_SECTOR_BUF_LEN bytes. prev is the sector decoded before,
+ * or NULL for the first sector of a frame.
+ * Returns the number of bytes of src consumed, or -1 if they are not a
+ * valid sector.
+ */
+static inline int tafi_wire_decode_sector(const unsigned char *src, unsigned int len, const unsigned char *prev,
+    unsigned char *dst) {
+
+    static const unsigned char off[TAFI_LED_COLOR_FIELD_COUNT] = { TAFI_WIRE_OFF, TAFI_WIRE_OFF, TAFI_WIRE_OFF };
+    const unsigned char *last;
+    unsigned int used = 0;
+    unsigned int led = 0;
+    unsigned int count;
+    unsigned int c;
+    unsigned char token;
+
+    while (led < TAFI_SECTOR_LED_COUNT) {
+        if (used >= len)
+            return -1;
+        token = src[used];
+
+        if ((token & TAFI_WIRE_LITERAL) == TAFI_WIRE_LITERAL) {
+            if (len - used < TAFI_LED_COLOR_FIELD_COUNT)
+                return -1;
+            for (c = 0; c < TAFI_LED_COLOR_FIELD_COUNT; c++) {
+                // the other bytes of a literal must be data too
+                if (!(src[used + c] & TAFI_WIRE_LITERAL))
+                    return -1;
+                dst[led * TAFI_LED_COLOR_FIELD_COUNT + c] = src[used + c];
+            }
+            used += TAFI_LED_COLOR_FIELD_COUNT;
+            led++;
+            continue;
+        }
+
+        used++;
+        count = (token & TAFI_WIRE_COUNT_MASK) + 1;
+        if (count > TAFI_SECTOR_LED_COUNT - led)
+            return -1;
+
+        while (count--) {
+            if ((token & TAFI_WIRE_COMMAND_MASK) == TAFI_WIRE_COPY) {
+                last = prev ? prev + led * TAFI_LED_COLOR_FIELD_COUNT : off;
+            } else if (led > 0) {
+                last = dst + (led - 1) * TAFI_LED_COLOR_FIELD_COUNT;
+            } else {
+                last = prev ? prev + (TAFI_SECTOR_LED_COUNT - 1) * TAFI_LED_COLOR_FIELD_COUNT : off;
+            }
+            for (c = 0; c < TAFI_LED_COLOR_FIELD_COUNT; c++)
+                dst[led * TAFI_LED_COLOR_FIELD_COUNT + c] = last[c];
+            led++;
+        }
+    }
+
+    return used;
+}
+
+/**
+ * Decode a whole compressed frame of len bytes into dst, TAFI_DATA_BUF_LEN
+ * bytes. Returns 0, or -1 if src is not exactly one valid frame.
+ */
+static inline int tafi_wire_decode(const unsigned char *src, unsigned int len, unsigned char *dst) {
+    const unsigned char *prev = 0;
+    unsigned int sector;
+    int used;
+
+    for (sector = 0; sector < TAFI_SECTOR_COUNT; sector++) {
+        used = tafi_wire_decode_sector(src, len, prev, dst);
+        if (used < 0)
+            return -1;
+        src += used;
+        len -= used;
+        prev = dst;
+        dst += TAFI_SECTOR_BUF_LEN;
+    }
+
+    return len ? -1 : 0;
+}
+
+#ifdef __KERNEL__
+
+int tafi_wire_init(void);
+
+void tafi_wire_exit(void);
+
+int tafi_wire_write_locked(const unsigned char *frame, dma_addr_t dma);
+
+int tafi_wire_queue_locked(const unsigned char *frame, unsigned int first, unsigned int count);
+
+bool tafi_wire_compressing(void);
+
+#endif
+
+#endif
@@ -0,0 +1,201 @@
+/**
+ *  sync_group.c -- The Amazing Fan Idea driver tests
+ *  Frame clock numbering and scheduled commits, against a simulated sync
+ *  line.
+ *
+ *  The driver must be loaded with sync_gpio set to a gpio-mockup line,
+ *  whose debugfs file is given on the command line; sync_group.sh sets
+ *  that up. Every rising edge generated here is a tick. Checks that:
+ *
+ *   - TAFI_IOC_SET_CLOCK numbers the next edge, and ticks count on by one
+ *     per edge from there,
+ *   - renumbering a running clock takes effect on the next edge, so fans
+ *     loaded at different times agree once they numbered the same edge,
+ *   - a frame committed for a tick with TAFI_IOC_COMMIT_AT goes live on
+ *     that edge, and not on the one before.
+ *
+ *  Usage: sync_group [-d device] line_file
+ *
+ *      (C) 2017 Harindu Perera
+ *
+ *  This file is subject to the terms and conditions of the GNU General Public
+ *  License. See the file COPYING in the main directory of this archive for
+ *  more details.
+ */
+
+#include <fcntl.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <linux/types.h>
+
+#include "tafi_uapi.h"
+
+// Half of one edge period, well below the driver's sync timeout of four
+// frame periods, and long enough for the thread to act on the edge.
+#define SYNC_HALF_PERIOD_MS 30
+
+static int tafi_fd;
+static const char *line_path;
+static int failures;
+
+static void sleep_ms(unsigned int ms) {
+    struct timespec ts = { .tv_sec = ms / 1000, .tv_nsec = (ms % 1000) * 1000000L };
+
+    nanosleep(&ts, NULL);
+}
+
+/**
+ * Pull the simulated line low or high, gpio-mockup fires the interrupt of
+ * an input on the edge it was requested for.
+ */
+static void set_line(const char *level) {
+    FILE *f = fopen(line_path, "w");
+
+    if (f == NULL || fputs(level, f) < 0 || fclose(f) != 0) {
+        perror(line_path);
+        exit(1);
+    }
+}
+
+/**
+ * Generate one rising edge, and give the thread time to handle it.
+ */
+static void edge(void) {
+    set_line("0");
+    sleep_ms(SYNC_HALF_PERIOD_MS);
+    set_line("1");
+    sleep_ms(SYNC_HALF_PERIOD_MS);
+}
+
+static void xioctl(unsigned long cmd, void *arg, const char *name) {
+    if (ioctl(tafi_fd, cmd, arg) < 0) {
+        perror(name);
+        exit(1);
+    }
+}
+
+static uint64_t tick(void) {
+    struct tafi_clock_info clock;
+
+    xioctl(TAFI_IOC_GET_CLOCK, &clock, "TAFI_IOC_GET_CLOCK");
+    if (!(clock.flags & TAFI_CLOCK_SYNCED)) {
+        fprintf(stderr, "clock not synced, is sync_gpio set?\n");
+        exit(1);
+    }
+    return clock.tick;
+}
+
+static void set_clock(uint64_t next) {
+    xioctl(TAFI_IOC_SET_CLOCK, &next, "TAFI_IOC_SET_CLOCK");
+}
+
+static void expect_tick(uint64_t expected, const char *what) {
+    uint64_t got = tick();
+
+    if (got != expected) {
+        fprintf(stderr, "FAIL: %s: tick %llu, expected %llu\n", what,
+            (unsigned long long) got, (unsigned long long) expected);
+        failures++;
+    }
+}
+
+/**
+ * Stage a whole frame of one byte value, without committing it.
+ */
+static void stage(unsigned char value) {
+    unsigned char frame[TAFI_DATA_BUF_LEN];
+
+    memset(frame, value, sizeof(frame));
+    if (pwrite(tafi_fd, frame, sizeof(frame), 0) != sizeof(frame)) {
+        perror("write");
+        exit(1);
+    }
+}
+
+static void expect_live(unsigned char value, const char *what) {
+    unsigned char frame[TAFI_DATA_BUF_LEN];
+    size_t i;
+
+    if (pread(tafi_fd, frame, sizeof(frame), 0) != sizeof(frame)) {
+        perror("read");
+        exit(1);
+    }
+    for (i = 0; i < sizeof(frame); i++) {
+        if (frame[i] != value) {
+            fprintf(stderr, "FAIL: %s: byte %zu is 0x%02x, expected 0x%02x\n", what, i, frame[i], value);
+            failures++;
+            return;
+        }
+    }
+}
+
+int main(int argc, char **argv) {
+    const char *device = "/dev/tafi";
+    uint64_t at;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "d:")) != -1) {
+        switch (opt) {
+        case 'd':
+            device = optarg;
+            break;
+        default:
+            fprintf(stderr, "usage: %s [-d device] line_file\n", argv[0]);
+            return 2;
+        }
+    }
+    if (optind + 1 != argc) {
+        fprintf(stderr, "usage: %s [-d device] line_file\n", argv[0]);
+        return 2;
+    }
+    line_path = argv[optind];
+
+    tafi_fd = open(device, O_RDWR);
+    if (tafi_fd < 0) {
+        perror(device);
+        return 1;
+    }
+
+    // number an edge, then count on from it
+    set_line("0");
+    set_clock(1000);
+    edge();
+    expect_tick(1000, "numbered edge");
+    edge();
+    edge();
+    expect_tick(1002, "edges after the numbered one");
+
+    // a fan renumbered while running agrees from the next edge on
+    set_clock(5000);
+    expect_tick(1002, "before the renumbered edge");
+    edge();
+    expect_tick(5000, "renumbered edge");
+
+    // a scheduled commit goes live on its tick, not before
+    stage(0x80);
+    xioctl(TAFI_IOC_COMMIT, NULL, "TAFI_IOC_COMMIT");
+    edge();
+    expect_live(0x80, "committed frame");
+
+    at = tick() + 2;
+    stage(0xff);
+    xioctl(TAFI_IOC_COMMIT_AT, &at, "TAFI_IOC_COMMIT_AT");
+    edge();
+    expect_live(0x80, "tick before the scheduled one");
+    edge();
+    expect_tick(at, "scheduled tick");
+    expect_live(0xff, "scheduled tick");
+
+    close(tafi_fd);
+
+    if (failures)
+        return 1;
+    printf("sync_group: ok\n");
+    return 0;
+}
@@ -0,0 +1,60 @@
+#!/bin/sh
+# sync_group.sh -- The Amazing Fan Idea driver tests
+# Loads the driver against a gpio-mockup sync line and a virtual SPI
+# controller, and runs sync_group on it. Needs root, debugfs and
+# gpio-mockup, whose lines raise edge interrupts since 5.2, so it runs on
+# every kernel the driver builds for.
+#
+#     SPI_BUS=N [MODULE=../tafi.ko] ./sync_group.sh
+#
+# SPI_BUS is the bus number of the controller to bind to, e.g. a spi-gpio
+# or QEMU virtio-spi controller; by default the first one there is. Exits
+# with 4, the kselftest skip code, if something needed is missing.
+
+set -e
+
+cd "$(dirname "$0")"
+
+MODULE=${MODULE:-../tafi.ko}
+DEBUGFS=/sys/kernel/debug
+MOCKUP=$DEBUGFS/gpio-mockup
+
+skip() {
+    echo "sync_group: SKIP: $*"
+    exit 4
+}
+
+cleanup() {
+    rmmod tafi 2>/dev/null || true
+    rmmod gpio-mockup 2>/dev/null || true
+}
+
+[ "$(id -u)" = 0 ] || skip "must run as root"
+[ -f "$MODULE" ] || skip "no module at $MODULE"
+grep -qs '^gpio_mockup ' /proc/modules && skip "gpio-mockup already loaded, its lines may be in use"
+[ -d "$DEBUGFS/gpio-mockup" ] || mount -t debugfs none "$DEBUGFS" 2>/dev/null || true
+
+if [ -z "$SPI_BUS" ]; then
+    for master in /sys/class/spi_master/spi*; do
+        [ -e "$master" ] || continue
+        SPI_BUS=${master##*/spi}
+        break
+    done
+fi
+[ -n "$SPI_BUS" ] || skip "no SPI controller"
+
+# a one line mockup chip at a free base, the sync input
+modprobe gpio-mockup gpio_mockup_ranges=-1,1 2>/dev/null || skip "no gpio-mockup"
+trap cleanup EXIT
+[ -d "$MOCKUP" ] || skip "no gpio-mockup debugfs, is debugfs mounted?"
+chip=$(ls "$MOCKUP")
+line=$MOCKUP/$chip/0
+echo 0 > "$line"
+
+# sync_gpio takes a global GPIO number
+base=$(sed -n "s/^$chip: GPIOs \([0-9]*\)-.*/\1/p" "$DEBUGFS/gpio")
+[ -n "$base" ] || skip "no GPIO base for $chip"
+
+make -s sync_group
+insmod "$MODULE" sync_gpio="$base" spi_bus="$SPI_BUS"
+./sync_group "$line"